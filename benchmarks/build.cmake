@@ -0,0 +1,5 @@
+add_executable(regex_benchmark ${CMAKE_CURRENT_LIST_DIR}/regex.c)
+target_link_libraries(regex_benchmark PRIVATE text)
+
+add_executable(sort_benchmark ${CMAKE_CURRENT_LIST_DIR}/sort.c)
+target_link_libraries(sort_benchmark PRIVATE text)
@@ -0,0 +1,107 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Log-grep style benchmark of the regex engine over a synthetic access log.
+ * Usage: regex_benchmark [megabytes]
+ */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <text.h>
+#include <text_regex.h>
+
+static const char *const PATTERNS[] = {
+        "ERROR",
+        "ERROR .*timeout",
+        "\\d+\\.\\d+\\.\\d+\\.\\d+",
+        "(GET|POST) /api/\\w+",
+        "user=(\\w+) status=(5\\d\\d)",
+        "[a-z]+@[a-z]+\\.com",
+};
+
+static uint32_t nextRandom(uint32_t *const state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static Text generateLog(const size_t size) {
+    static const char *const levels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+    static const char *const methods[] = {"GET", "POST", "PUT", "DELETE"};
+    static const char *const paths[] = {"/api/users", "/api/orders", "/static/app.js", "/index.html", "/api/items"};
+    static const char *const users[] = {"alice", "bob", "carol", "dave", "erin"};
+    static const char *const notes[] = {"ok", "slow response", "upstream timeout", "cache miss", "retrying"};
+    char line[256];
+    uint32_t state = 2463534242U;
+    Text log = Text_withCapacity(size + sizeof(line));
+    while (Text_length(log) < size) {
+        const int length = snprintf(
+                line, sizeof(line), "2018-%02u-%02u 12:%02u:%02u %s %u.%u.%u.%u %s %s user=%s status=%u %s\n",
+                1 + nextRandom(&state) % 12, 1 + nextRandom(&state) % 28, nextRandom(&state) % 60,
+                nextRandom(&state) % 60, levels[nextRandom(&state) % 6], nextRandom(&state) % 256,
+                nextRandom(&state) % 256, nextRandom(&state) % 256, nextRandom(&state) % 256,
+                methods[nextRandom(&state) % 4], paths[nextRandom(&state) % 5], users[nextRandom(&state) % 5],
+                (nextRandom(&state) % 4 + 2) * 100 + nextRandom(&state) % 4, notes[nextRandom(&state) % 5]
+        );
+        log = Text_appendBytes(&log, line, (size_t) length);
+    }
+    return log;
+}
+
+static double elapsedSeconds(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+int main(int argc, char **argv) {
+    const size_t megabytes = argc > 1 ? strtoul(argv[1], NULL, 10) : 64;
+    Text log = generateLog(megabytes * 1024 * 1024);
+    const double size = (double) Text_length(log) / (1024.0 * 1024.0);
+    printf("%-32s %10s %10s %12s\n", "pattern", "matches", "seconds", "MiB/s");
+    for (size_t i = 0; i < sizeof(PATTERNS) / sizeof(PATTERNS[0]); i++) {
+        size_t invalidOffset, matches = 0;
+        Text pattern = Text_fromLiteral(PATTERNS[i]);
+        TextRegex *regex = TextRegex_new(pattern, &invalidOffset);
+        TextRegexIterator iterator = TextRegex_findAll(regex, log, 0);
+        TextSlice match;
+        struct timespec start;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        while (TextRegexIterator_next(&iterator, &match)) {
+            matches++;
+        }
+        const double seconds = elapsedSeconds(&start);
+        printf("%-32s %10zu %10.3f %12.1f\n", PATTERNS[i], matches, seconds, size / seconds);
+        TextRegex_delete(regex);
+        Text_delete(pattern);
+    }
+    Text_delete(log);
+    return 0;
+}
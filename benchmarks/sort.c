@@ -0,0 +1,114 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Sorts synthetic URL keys sharing long prefixes with qsort and with Text_sortArray.
+ * Usage: sort_benchmark [count] [threads]
+ */
+
+#include <time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <text.h>
+#include <text_sort.h>
+
+static uint32_t nextRandom(uint32_t *const state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 17;
+    *state ^= *state << 5;
+    return *state;
+}
+
+static Text *generateKeys(const size_t count) {
+    static const char *const hosts[] = {"https://example.org", "https://api.example.org", "https://cdn.example.org"};
+    static const char *const paths[] = {"/api/v1/users/", "/api/v1/orders/", "/static/assets/", "/api/v2/users/"};
+    uint32_t state = 2463534242U;
+    Text *keys = malloc(sizeof(keys[0]) * count);
+    if (NULL == keys) {
+        abort();
+    }
+    for (size_t i = 0; i < count; i++) {
+        keys[i] = Text_format("%s%s%u/items/%u", hosts[nextRandom(&state) % 3], paths[nextRandom(&state) % 4],
+                              nextRandom(&state) % 100000, nextRandom(&state) % 1000);
+    }
+    return keys;
+}
+
+static int compareStrings(const void *a, const void *b) {
+    return strcmp(*(const char *const *) a, *(const char *const *) b);
+}
+
+static double elapsedSeconds(const struct timespec *const start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static bool isSorted(const Text *const keys, const size_t count) {
+    for (size_t i = 1; i < count; i++) {
+        if (Text_compare(keys[i - 1], keys[i]) > 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    const size_t count = argc > 1 ? strtoul(argv[1], NULL, 10) : 2000000;
+    const unsigned threads = argc > 2 ? (unsigned) strtoul(argv[2], NULL, 10) : 0;
+    Text *const keys = generateKeys(count), *const work = malloc(sizeof(keys[0]) * count);
+    if (NULL == work) {
+        abort();
+    }
+    printf("%-24s %10s %8s\n", "algorithm", "seconds", "sorted");
+    for (unsigned i = 0; i < 3; i++) {
+        static const char *const names[] = {"qsort + strcmp", "Text_sortArray", "Text_sortArrayParallel"};
+        struct timespec start;
+        memcpy(work, keys, sizeof(keys[0]) * count);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        switch (i) {
+            case 0:
+                qsort(work, count, sizeof(work[0]), compareStrings);
+                break;
+            case 1:
+                Text_sortArray(work, count);
+                break;
+            default:
+                Text_sortArrayParallel(work, count, threads);
+                break;
+        }
+        const double seconds = elapsedSeconds(&start);
+        printf("%-24s %10.3f %8s\n", names[i], seconds, isSorted(work, count) ? "yes" : "no");
+    }
+    for (size_t i = 0; i < count; i++) {
+        Text_delete(keys[i]);
+    }
+    free(keys);
+    free(work);
+    return 0;
+}
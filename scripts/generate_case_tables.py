@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+"""
+Generates sources/text_case_tables.h from the Unicode database bundled with Python.
+
+The tables map each code point to its full lowercase, uppercase and case folding (as given by str.lower,
+str.upper and str.casefold applied to the single code point, i.e. without context or language sensitive rules).
+
+Usage: python3 scripts/generate_case_tables.py > sources/text_case_tables.h
+"""
+
+import os
+import sys
+import unicodedata
+
+SHIFT = 7
+BLOCK = 1 << SHIFT
+MAX_CODE_POINT = 0x10FFFF
+SURROGATES = range(0xD800, 0xE000)
+
+LICENSE_SOURCE = os.path.join(os.path.dirname(os.path.abspath(__file__)), os.pardir, 'sources', 'text.h')
+LICENSE = open(LICENSE_SOURCE).read().split('*/')[0] + '*/'
+
+
+def mappings(cp):
+    c = chr(cp)
+    return c.lower(), c.upper(), c.casefold()
+
+
+def main():
+    specials = [()]
+    special_ids = {(): 0}
+    records = [(0, 0, 0, 0, 0, 0)]
+    record_ids = {records[0]: 0}
+    entries = []
+    limit = 0
+
+    for cp in range(MAX_CODE_POINT + 1):
+        if cp in SURROGATES:
+            entries.append(0)
+            continue
+        deltas, ids = [], []
+        for mapped in mappings(cp):
+            if len(mapped) == 1:
+                deltas.append(ord(mapped) - cp)
+                ids.append(0)
+            else:
+                key = tuple(ord(m) for m in mapped)
+                assert len(key) <= 3
+                if key not in special_ids:
+                    special_ids[key] = len(specials)
+                    specials.append(key)
+                deltas.append(0)
+                ids.append(special_ids[key])
+        record = tuple(deltas + ids)
+        if record not in record_ids:
+            record_ids[record] = len(records)
+            records.append(record)
+        entries.append(record_ids[record])
+        if record_ids[record]:
+            limit = cp + 1
+
+    limit = (limit + BLOCK - 1) // BLOCK * BLOCK
+    blocks, block_ids, stage1 = [], {}, []
+    for start in range(0, limit, BLOCK):
+        block = tuple(entries[start:start + BLOCK])
+        if block not in block_ids:
+            block_ids[block] = len(blocks)
+            blocks.append(block)
+        stage1.append(block_ids[block])
+
+    assert len(blocks) <= 256 and len(records) <= 65536 and len(specials) <= 65536
+    stage2_type = 'uint8_t' if len(records) <= 256 else 'uint16_t'
+
+    def rows(values, per_row=16):
+        values = list(values)
+        return ',\n'.join('        ' + ', '.join(values[i:i + per_row]) for i in range(0, len(values), per_row))
+
+    out = sys.stdout
+    out.write(LICENSE + '\n\n')
+    out.write('/*\n')
+    out.write(' * Generated by scripts/generate_case_tables.py from Unicode %s, do not edit.\n'
+              % unicodedata.unidata_version)
+    out.write(' *\n')
+    out.write(' * A code point below TEXT_CASE_LIMIT selects a block through TextCase_stage1 (cp >> TEXT_CASE_SHIFT),\n')
+    out.write(' * the block selects a record through TextCase_stage2. Code points at or above the limit are caseless.\n')
+    out.write(' * Single code point mappings are stored as deltas, longer ones as an index into TextCase_specials.\n')
+    out.write(' */\n\n')
+    out.write('#pragma once\n\n#include <stdint.h>\n\n')
+    out.write('#define TEXT_CASE_SHIFT     %d\n' % SHIFT)
+    out.write('#define TEXT_CASE_LIMIT     0x%XU\n\n' % limit)
+    out.write('struct TextCase_Record {\n    int32_t delta[3];       // lower, upper, fold\n'
+              '    uint16_t special[3];    // lower, upper, fold\n};\n\n')
+    out.write('static const struct TextCase_Record TextCase_records[%d] = {\n' % len(records))
+    out.write(',\n'.join('        {{%d, %d, %d}, {%d, %d, %d}}' % r for r in records))
+    out.write('\n};\n\n')
+    out.write('static const uint32_t TextCase_specials[%d][3] = {\n' % len(specials))
+    out.write(',\n'.join('        {%s}' % ', '.join('0x%04X' % c for c in (s + (0, 0, 0))[:3]) for s in specials))
+    out.write('\n};\n\n')
+    out.write('static const uint8_t TextCase_stage1[%d] = {\n' % len(stage1))
+    out.write(rows(str(b) for b in stage1))
+    out.write('\n};\n\n')
+    out.write('static const %s TextCase_stage2[%d] = {\n' % (stage2_type, len(blocks) * BLOCK))
+    out.write(rows((str(e) for block in blocks for e in block), 32))
+    out.write('\n};\n')
+
+
+if __name__ == '__main__':
+    main()
@@ -4,4 +4,5 @@ message("${ARCHIVE_NAME}@${CMAKE_CURRENT_LIST_DIR} using: ${CMAKE_CURRENT_LIST_F
 file(GLOB ARCHIVE_HEADERS ${CMAKE_CURRENT_LIST_DIR}/*.h)
 file(GLOB ARCHIVE_SOURCES ${CMAKE_CURRENT_LIST_DIR}/*.c)
 add_library(${ARCHIVE_NAME} ${ARCHIVE_HEADERS} ${ARCHIVE_SOURCES})
-target_link_libraries(${ARCHIVE_NAME} PRIVATE panic alligator)
+find_package(Threads REQUIRED)
+target_link_libraries(${ARCHIVE_NAME} PRIVATE panic alligator Threads::Threads)
@@ -30,15 +30,21 @@ OTHER DEALINGS IN THE SOFTWARE.
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
+#include <pthread.h>
 #include <panic/panic.h>
 #include <alligator/alligator.h>
 #include "text.h"
 #include "text_config.h"
+#include "text_simd.h"
+#include "text_header.h"
 
 #if TEXT_DEFAULT_CAPACITY < 32UL || TEXT_DEFAULT_CAPACITY >= SIZE_MAX
     #error
 #endif
 
+// TEXT_BUFFER_SIZE reserves four pointers for the header
+typedef char Text_checkBufferSize[sizeof(struct Text_Header) <= 4 * sizeof(void *) ? 1 : -1];
+
 static size_t nextEven(const size_t size) {
     assert(size < SIZE_MAX);
     return size + (size % 2);
@@ -59,16 +65,119 @@ static size_t calculateNewCapacity(size_t currentCapacity, const size_t targetCa
     return currentCapacity;
 }
 
+/*
+ * Capacity of the heap block taking over a text outgrowing its caller provided buffer.
+ */
+static size_t calculateSpilledCapacity(const size_t currentCapacity, const size_t targetCapacity) {
+    const size_t capacity = currentCapacity > TEXT_DEFAULT_CAPACITY ? currentCapacity : TEXT_DEFAULT_CAPACITY;
+    return capacity >= targetCapacity ? capacity : calculateNewCapacity(capacity, targetCapacity);
+}
+
 static bool isTrimmable(char c) {
     return isspace(c) || isblank(c) || !isprint(c);
 }
 
-struct Text_Header {
-    size_t capacity;
-    size_t length;
-    char *content;
+/*
+ * Per thread cache of deleted heap blocks, bucketed by the highest bit of their capacity.
+ * Cached blocks are linked through their content pointer, which is restored on reuse.
+ */
+#define RECYCLER_BUCKETS    (sizeof(size_t) * 8)
+
+struct Recycler {
+    struct Text_Header *buckets[RECYCLER_BUCKETS];
+    size_t bytes;
+    size_t maxBytes;
+    bool enabled;
 };
 
+static __thread struct Recycler recycler;
+static pthread_key_t recyclerKey;
+static pthread_once_t recyclerKeyOnce = PTHREAD_ONCE_INIT;
+
+static unsigned highestBit(const size_t value) {
+    assert(value > 0);
+    return (unsigned) (sizeof(unsigned long long) * 8 - 1) - (unsigned) __builtin_clzll(value);
+}
+
+static size_t blockSize(const size_t capacity) {
+    return sizeof(struct Text_Header) + sizeof(char) * (capacity + 1);
+}
+
+static struct Text_Header *Recycler_popBucket(const unsigned bucket) {
+    struct Text_Header *const header = recycler.buckets[bucket];
+    recycler.buckets[bucket] = (struct Text_Header *) header->content;
+    recycler.bytes -= blockSize(header->capacity);
+    return header;
+}
+
+/*
+ * Blocks in the bucket of capacity have at least its highest bit, the head is checked for an exact fit first.
+ */
+static struct Text_Header *Recycler_take(const size_t capacity) {
+    if (!recycler.enabled) {
+        return NULL;
+    }
+    const unsigned bucket = highestBit(capacity);
+    if (recycler.buckets[bucket] && recycler.buckets[bucket]->capacity >= capacity) {
+        return Recycler_popBucket(bucket);
+    }
+    if (bucket + 1 < RECYCLER_BUCKETS && recycler.buckets[bucket + 1]) {
+        return Recycler_popBucket(bucket + 1);
+    }
+    return NULL;
+}
+
+static bool Recycler_put(struct Text_Header *const header) {
+    const size_t size = blockSize(header->capacity);
+    if (!recycler.enabled || header->capacity < TEXT_DEFAULT_CAPACITY || size > recycler.maxBytes - recycler.bytes) {
+        return false;   // shrunk blocks smaller than the default capacity would never be reused
+    }
+    const unsigned bucket = highestBit(header->capacity);
+    header->content = (char *) recycler.buckets[bucket];
+    recycler.buckets[bucket] = header;
+    recycler.bytes += size;
+    return true;
+}
+
+static void Recycler_release(void *const arg) {
+    (void) arg;
+    Text_trimRecycled(0);
+    recycler.enabled = false;
+}
+
+static void Recycler_createKey(void) {
+    if (0 != pthread_key_create(&recyclerKey, Recycler_release)) {
+        Panic_terminate("Unable to create thread key");
+    }
+}
+
+void Text_enableRecycling(const size_t maxBytes) {
+    pthread_once(&recyclerKeyOnce, Recycler_createKey);
+    if (0 != pthread_setspecific(recyclerKey, &recycler)) {   // frees the cache when the thread exits
+        Panic_terminate("Unable to set thread key");
+    }
+    recycler.maxBytes = maxBytes;
+    recycler.enabled = true;
+    Text_trimRecycled(maxBytes);
+}
+
+void Text_disableRecycling(void) {
+    Text_trimRecycled(0);
+    recycler.enabled = false;
+}
+
+void Text_trimRecycled(const size_t maxBytes) {
+    for (unsigned bucket = RECYCLER_BUCKETS; recycler.bytes > maxBytes && bucket-- > 0;) {   // largest blocks first
+        while (recycler.bytes > maxBytes && recycler.buckets[bucket]) {
+            Alligator_free(Recycler_popBucket(bucket));
+        }
+    }
+}
+
+size_t Text_recycledBytes(void) {
+    return recycler.bytes;
+}
+
 Text Text_new(void) {
     return Text_withCapacity(TEXT_DEFAULT_CAPACITY);
 }
@@ -78,15 +187,32 @@ Text Text_withCapacity(size_t capacity) {
     if (capacity < TEXT_DEFAULT_CAPACITY) {
         capacity = TEXT_DEFAULT_CAPACITY;
     }
-    struct Text_Header *header = Option_unwrap(Alligator_malloc(
-            sizeof(*header) + sizeof(header->content[0]) * (capacity + 1)
-    ));
+    struct Text_Header *header = Recycler_take(capacity);
+    if (header) {
+        capacity = header->capacity;
+    } else {
+        header = Option_unwrap(Alligator_malloc(blockSize(capacity)));
+    }
     header->content = (char *) (header + 1);
+    header->storage = Text_Storage_Heap;
     header->content[header->length = 0] = 0;
     header->content[header->capacity = capacity] = 0;
     return header->content;
 }
 
+Text Text_withBuffer(void *const buffer, const size_t size) {
+    assert(buffer);
+    assert(size >= TEXT_BUFFER_SIZE(0));
+    const size_t alignment = __alignof__(struct Text_Header);
+    const size_t padding = (alignment - (uintptr_t) buffer % alignment) % alignment;
+    struct Text_Header *header = (struct Text_Header *) ((char *) buffer + padding);
+    header->content = (char *) (header + 1);
+    header->storage = Text_Storage_Inline;
+    header->content[header->length = 0] = 0;
+    header->content[header->capacity = size - padding - sizeof(*header) - 1] = 0;
+    return header->content;
+}
+
 Text Text_quoted(const void *bytes, const size_t size) {
     assert(bytes);
     assert(size < SIZE_MAX);
@@ -145,6 +271,200 @@ Text Text_quoted(const void *bytes, const size_t size) {
     return text;
 }
 
+/*
+ * Parses a \uXXXX escape sequence starting at cursor, returns the code unit or -1 if malformed.
+ */
+static long parseCodeUnit(const char *const cursor, const char *const end) {
+    if (end - cursor < 6 || '\\' != cursor[0] || 'u' != cursor[1]) {
+        return -1;
+    }
+    long unit = 0;
+    for (size_t i = 2; i < 6; i++) {
+        const int digit = TextSimd_hexValue((unsigned char) cursor[i]);
+        if (digit < 0) {
+            return -1;
+        }
+        unit = unit * 16 + digit;
+    }
+    return unit;
+}
+
+static size_t encodeUtf8(char *const out, const unsigned long codePoint) {
+    if (codePoint < 0x80) {
+        out[0] = (char) codePoint;
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        out[0] = (char) (0xC0 | (codePoint >> 6));
+        out[1] = (char) (0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000) {
+        out[0] = (char) (0xE0 | (codePoint >> 12));
+        out[1] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = (char) (0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = (char) (0xF0 | (codePoint >> 18));
+    out[1] = (char) (0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = (char) (0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = (char) (0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+/*
+ * Decodes the JSON string literal in [bytes, bytes + size) into out, that may alias bytes since the output never
+ * outgrows the input; if out is NULL the literal is only validated.
+ * Runs free of escapes are located with a vectorized scan and moved in bulk.
+ * Returns the decoded size or SIZE_MAX if the literal is invalid.
+ */
+static size_t unquote(char *const out, const char *const bytes, const size_t size) {
+    if (size < 2 || '"' != bytes[0] || '"' != bytes[size - 1]) {
+        return SIZE_MAX;
+    }
+    struct Text_ByteSet specials;
+    TextSimd_byteSetInit(&specials, "\"\\", 2);
+    const char *cursor = bytes + 1, *const end = bytes + size - 1;
+    size_t length = 0;
+    char buffer[4];
+
+    for (;;) {
+        const char *special = TextSimd_findFirstOf(cursor, end, &specials);
+        const size_t run = (size_t) ((special ? special : end) - cursor);
+        if (out) {
+            memmove(out + length, cursor, run);
+        }
+        length += run;
+        if (NULL == special) {
+            return length;
+        }
+        if ('"' == *special || special + 1 == end) {
+            return SIZE_MAX;
+        }
+
+        size_t decodedSize = 1;
+        cursor = special + 2;
+        switch (special[1]) {
+            case '"':
+            case '\\':
+            case '/': {
+                buffer[0] = special[1];
+                break;
+            }
+            case 'b': {
+                buffer[0] = '\b';
+                break;
+            }
+            case 'f': {
+                buffer[0] = '\f';
+                break;
+            }
+            case 'n': {
+                buffer[0] = '\n';
+                break;
+            }
+            case 'r': {
+                buffer[0] = '\r';
+                break;
+            }
+            case 't': {
+                buffer[0] = '\t';
+                break;
+            }
+            case 'u': {
+                long codePoint = parseCodeUnit(special, end);
+                if (codePoint < 0 || (codePoint >= 0xDC00 && codePoint <= 0xDFFF)) {
+                    return SIZE_MAX;
+                }
+                cursor = special + 6;
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF) {
+                    const long low = parseCodeUnit(cursor, end);
+                    if (low < 0xDC00 || low > 0xDFFF) {
+                        return SIZE_MAX;
+                    }
+                    codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    cursor += 6;
+                }
+                decodedSize = encodeUtf8(buffer, (unsigned long) codePoint);
+                break;
+            }
+            default: {
+                return SIZE_MAX;
+            }
+        }
+        if (out) {
+            memcpy(out + length, buffer, decodedSize);
+        }
+        length += decodedSize;
+    }
+}
+
+Text Text_unquoted(const void *const bytes, const size_t size) {
+    assert(bytes);
+    assert(size < SIZE_MAX);
+    Text text = Text_withCapacity(size);
+    const size_t length = unquote(text, bytes, size);
+    if (SIZE_MAX == length) {
+        Text_delete(text);
+        return NULL;
+    }
+    Text_setLength(text, length);
+    return text;
+}
+
+/*
+ * Gets the entity replacing c, if any.
+ */
+static const char *htmlEntity(const char c, size_t *const size) {
+    switch (c) {
+        case '&': *size = 5; return "&amp;";
+        case '<': *size = 4; return "&lt;";
+        case '>': *size = 4; return "&gt;";
+        case '"': *size = 6; return "&quot;";
+        case '\'': *size = 5; return "&#39;";
+        default: *size = 1; return NULL;
+    }
+}
+
+static void htmlEscapes(struct Text_ByteSet *const set) {
+    TextSimd_byteSetInit(set, "&<>\"'", 5);
+}
+
+/*
+ * Counts the bytes added escaping [begin, end).
+ */
+static size_t htmlExpansion(const char *begin, const char *const end, const struct Text_ByteSet *const escapes) {
+    size_t expansion = 0, size;
+    while (NULL != (begin = TextSimd_findFirstOf(begin, end, escapes))) {
+        htmlEntity(*begin++, &size);
+        expansion += size - 1;
+    }
+    return expansion;
+}
+
+Text Text_escapedHtml(const void *const bytes, const size_t size) {
+    assert(bytes);
+    assert(size < SIZE_MAX);
+    struct Text_ByteSet escapes;
+    htmlEscapes(&escapes);
+    const char *cursor = bytes, *const end = cursor + size;
+    const size_t length = size + htmlExpansion(cursor, end, &escapes);
+    Text text = Text_withCapacity(length);
+    char *out = text;
+
+    for (const char *escape; NULL != (escape = TextSimd_findFirstOf(cursor, end, &escapes)); cursor = escape + 1) {
+        size_t entitySize;
+        const char *const entity = htmlEntity(*escape, &entitySize);
+        memcpy(out, cursor, (size_t) (escape - cursor));
+        out += escape - cursor;
+        memcpy(out, entity, entitySize);
+        out += entitySize;
+    }
+    memcpy(out, cursor, (size_t) (end - cursor));
+    Text_setLength(text, length);
+    return text;
+}
+
 Text Text_format(const char *format, ...) {
     assert(format);
     va_list args;
@@ -388,6 +708,50 @@ Text Text_quote(Text *ref) {
     return self;
 }
 
+bool Text_unquote(Text self) {
+    assert(self);
+    const size_t size = Text_length(self);
+    Text_Header_getMutable(self);
+    if (SIZE_MAX == unquote(NULL, self, size)) {
+        return false;
+    }
+    Text_setLength(self, unquote(self, self, size));
+    return true;
+}
+
+Text Text_escapeHtml(Text *ref) {
+    assert(ref);
+    assert(*ref);
+    struct Text_ByteSet escapes;
+    htmlEscapes(&escapes);
+    Text self = *ref;
+    const size_t length = Text_length(self);
+    const char *const first = TextSimd_findFirstOf(self, self + length, &escapes);
+    if (NULL == first) {
+        *ref = NULL;
+        return self;
+    }
+
+    // grow once, then move the content from the last escape backward so that each byte is moved only once
+    const size_t offset = (size_t) (first - self);
+    const size_t escapedLength = length + htmlExpansion(first, self + length, &escapes);
+    self = Text_expandToFit(ref, escapedLength);
+    const char *begin = self + offset, *end = self + length;
+    char *out = self + escapedLength;
+    for (const char *escape; NULL != (escape = TextSimd_findLastOf(begin, end, &escapes)); end = escape) {
+        size_t entitySize;
+        const char *const entity = htmlEntity(*escape, &entitySize);
+        const size_t run = (size_t) (end - escape - 1);
+        out -= run;
+        memmove(out, escape + 1, run);
+        out -= entitySize;
+        memcpy(out, entity, entitySize);
+    }
+    assert(out == end);
+    Text_setLength(self, escapedLength);
+    return self;
+}
+
 void Text_eraseRange(Text self, const size_t start, const size_t end) {
     assert(self);
     assert(start <= end);
@@ -398,11 +762,11 @@ void Text_eraseRange(Text self, const size_t start, const size_t end) {
             if (0 == start) {
                 Text_clear(self);
             } else {
-                struct Text_Header *header = (struct Text_Header *) self - 1;
+                struct Text_Header *header = Text_Header_getMutable(self);
                 self[header->length -= (end - start)] = 0;
             }
         } else {
-            struct Text_Header *header = (struct Text_Header *) self - 1;
+            struct Text_Header *header = Text_Header_getMutable(self);
             memmove(self + start, self + end, length - end);
             self[header->length -= (end - start)] = 0;
         }
@@ -432,6 +796,7 @@ void Text_trim(Text self) {         // TODO test
 
 void Text_lower(Text self) {
     assert(self);
+    Text_Header_getMutable(self);
     const size_t length = Text_length(self);
     for (size_t i = 0; i < length; i++) {
         self[i] = (char) tolower(self[i]);
@@ -440,6 +805,7 @@ void Text_lower(Text self) {
 
 void Text_upper(Text self) {
     assert(self);
+    Text_Header_getMutable(self);
     const size_t length = Text_length(self);
     for (size_t i = 0; i < length; i++) {
         self[i] = (char) toupper(self[i]);
@@ -448,14 +814,14 @@ void Text_upper(Text self) {
 
 void Text_clear(Text self) {
     assert(self);
-    struct Text_Header *header = (struct Text_Header *) self - 1;
+    struct Text_Header *header = Text_Header_getMutable(self);
     self[header->length = 0] = 0;
 }
 
 void Text_setLength(Text self, size_t length) {
     assert(self);
     assert(length <= Text_capacity(self));
-    struct Text_Header *header = (struct Text_Header *) self - 1;
+    struct Text_Header *header = Text_Header_getMutable(self);
     self[header->length = length] = 0;
 }
 
@@ -463,7 +829,15 @@ Text Text_expandToFit(Text *ref, size_t capacity) {
     assert(ref);
     assert(*ref);
     assert(capacity < SIZE_MAX);
-    struct Text_Header *header = (struct Text_Header *) (*ref) - 1;
+    struct Text_Header *header = Text_Header_getMutable(*ref);
+    if (capacity > header->capacity && Text_Storage_Inline == header->storage) {
+        // the whole buffer moves, like a reallocation keeps what callers wrote past the length
+        Text text = Text_withCapacity(calculateSpilledCapacity(header->capacity, capacity));
+        memcpy(text, header->content, header->capacity);
+        ((struct Text_Header *) text - 1)->length = header->length;
+        *ref = NULL;
+        return text;
+    }
     if (capacity > header->capacity) {
         capacity = calculateNewCapacity(header->capacity, capacity);
         header = Option_unwrap(Alligator_realloc(
@@ -479,9 +853,9 @@ Text Text_expandToFit(Text *ref, size_t capacity) {
 Text Text_shrinkToFit(Text *ref) {
     assert(ref);
     assert(*ref);
-    struct Text_Header *header = (struct Text_Header *) (*ref) - 1;
+    struct Text_Header *header = Text_Header_getMutable(*ref);
     const size_t size = header->length;
-    if (size < header->capacity) {
+    if (size < header->capacity && Text_Storage_Inline != header->storage) {
         header = Option_unwrap(Alligator_realloc(
                 header, sizeof(*header) + sizeof(header->content[0]) * (size + 1)
         ));
@@ -516,6 +890,7 @@ char Text_put(Text self, const size_t index, const char c) {
     if (index >= Text_length(self)) {
         Panic_terminate("Out of range");
     }
+    Text_Header_getMutable(self);
     char *p = self + index;
     const char bk = *p;
     *p = c;
@@ -566,9 +941,167 @@ bool Text_equals(const TextView self, const TextView other) {
     return length == Text_length(other) && 0 == memcmp(self, other, length);
 }
 
+int Text_compare(const TextView self, const TextView other) {
+    assert(self);
+    assert(other);
+    const size_t selfLength = Text_length(self), otherLength = Text_length(other);
+    const size_t length = selfLength < otherLength ? selfLength : otherLength;
+    const size_t i = TextSimd_mismatch(self, other, length);
+    if (i < length) {
+        return (unsigned char) self[i] - (unsigned char) other[i];
+    }
+    return (selfLength > otherLength) - (selfLength < otherLength);
+}
+
+size_t Text_commonPrefixLength(const TextView self, const TextView other) {
+    assert(self);
+    assert(other);
+    const size_t selfLength = Text_length(self), otherLength = Text_length(other);
+    return TextSimd_mismatch(self, other, selfLength < otherLength ? selfLength : otherLength);
+}
+
+bool Text_startsWith(const TextView self, const void *const prefix, const size_t size) {
+    assert(self);
+    assert(prefix);
+    return size <= Text_length(self) && size == TextSimd_mismatch(self, prefix, size);
+}
+
+bool Text_endsWith(const TextView self, const void *const suffix, const size_t size) {
+    assert(self);
+    assert(suffix);
+    const size_t length = Text_length(self);
+    return size <= length && size == TextSimd_mismatch(self + length - size, suffix, size);
+}
+
+bool Text_equalsIgnoreCase(const TextView self, const TextView other) {
+    assert(self);
+    assert(other);
+    const size_t length = Text_length(self);
+    return length == Text_length(other) && length == TextSimd_mismatchIgnoreCase(self, other, length);
+}
+
+int Text_compareIgnoreCase(const TextView self, const TextView other) {
+    assert(self);
+    assert(other);
+    const size_t selfLength = Text_length(self), otherLength = Text_length(other);
+    const size_t length = selfLength < otherLength ? selfLength : otherLength;
+    const size_t i = TextSimd_mismatchIgnoreCase(self, other, length);
+    if (i < length) {
+        return TextSimd_foldAscii((unsigned char) self[i]) - TextSimd_foldAscii((unsigned char) other[i]);
+    }
+    return (selfLength > otherLength) - (selfLength < otherLength);
+}
+
+size_t Text_findIgnoreCase(const TextView self, const size_t offset, const void *const needle, const size_t size) {
+    assert(self);
+    assert(needle);
+    const size_t length = Text_length(self);
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+    if (0 == size) {
+        return offset;
+    }
+    const char *const match = TextSimd_findIgnoreCase(self + offset, self + length, needle, size);
+    return match ? (size_t) (match - self) : SIZE_MAX;
+}
+
+static TextSplitIterator makeSplitIterator(const TextView self) {
+    TextSplitIterator iterator;
+    memset(&iterator, 0, sizeof(iterator));
+    iterator.begin = self;
+    iterator.end = self + Text_length(self);
+    iterator.splitsLeft = SIZE_MAX;
+    return iterator;
+}
+
+TextSplitIterator Text_splitByByte(const TextView self, const char delimiter) {
+    assert(self);
+    return Text_splitByByteSet(self, &delimiter, 1);
+}
+
+TextSplitIterator Text_splitByByteSet(const TextView self, const void *const delimiters, const size_t size) {
+    assert(self);
+    assert(delimiters);
+    assert(size > 0);
+    TextSplitIterator iterator = makeSplitIterator(self);
+    TextSimd_byteSetInit(&iterator.delimiters, delimiters, size);
+    return iterator;
+}
+
+TextSplitIterator Text_splitBySeparator(const TextView self, const void *const separator, const size_t size) {
+    assert(self);
+    assert(separator);
+    assert(size > 0);
+    TextSplitIterator iterator = makeSplitIterator(self);
+    iterator.separator = separator;
+    iterator.separatorSize = size;
+    return iterator;
+}
+
+void TextSplitIterator_setMaxSplits(TextSplitIterator *const self, const size_t maxSplits) {
+    assert(self);
+    self->splitsLeft = maxSplits;
+}
+
+void TextSplitIterator_setReverse(TextSplitIterator *const self, const bool reverse) {
+    assert(self);
+    self->reverse = reverse;
+}
+
+static const char *findDelimiter(const TextSplitIterator *const self) {
+    if (self->separator) {
+        return self->reverse
+               ? TextSimd_findLast(self->begin, self->end, self->separator, self->separatorSize)
+               : TextSimd_find(self->begin, self->end, self->separator, self->separatorSize);
+    }
+    if (1 == self->delimiters.size) {
+        const char delimiter = (char) self->delimiters.bytes[0];
+        return self->reverse
+               ? TextSimd_findLastByte(self->begin, self->end, delimiter)
+               : TextSimd_findByte(self->begin, self->end, delimiter);
+    }
+    return self->reverse
+           ? TextSimd_findLastOf(self->begin, self->end, &self->delimiters)
+           : TextSimd_findFirstOf(self->begin, self->end, &self->delimiters);
+}
+
+bool TextSplitIterator_next(TextSplitIterator *const self, TextSlice *const token) {
+    assert(self);
+    assert(token);
+    if (self->exhausted) {
+        return false;
+    }
+    const char *delimiter = self->splitsLeft > 0 ? findDelimiter(self) : NULL;
+    if (NULL == delimiter) {
+        token->bytes = self->begin;
+        token->size = (size_t) (self->end - self->begin);
+        self->exhausted = true;
+        return true;
+    }
+    const size_t delimiterSize = self->separator ? self->separatorSize : 1;
+    if (self->reverse) {
+        token->bytes = delimiter + delimiterSize;
+        token->size = (size_t) (self->end - token->bytes);
+        self->end = delimiter;
+    } else {
+        token->bytes = self->begin;
+        token->size = (size_t) (delimiter - self->begin);
+        self->begin = delimiter + delimiterSize;
+    }
+    if (self->splitsLeft != SIZE_MAX) {
+        self->splitsLeft -= 1;
+    }
+    return true;
+}
+
 void Text_delete(Text self) {
     if (self) {
         struct Text_Header *header = (struct Text_Header *) self - 1;
-        Alligator_free(header);
+        if (Text_Storage_Mapped == header->storage) {
+            Text_Header_unmap(header);
+        } else if (Text_Storage_Inline != header->storage && !Recycler_put(header)) {
+            Alligator_free(header);
+        }
     }
 }
@@ -29,6 +29,7 @@ OTHER DEALINGS IN THE SOFTWARE.
 
 #include <stdarg.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdbool.h>
 
 #if !(defined(__GNUC__) || defined(__clang__))
@@ -54,6 +55,47 @@ extern "C" {
 typedef char *Text;
 typedef const char *TextView;
 
+/**
+ * A borrowed, non NUL terminated, sequence of bytes usually pointing into the content of a text.
+ */
+typedef struct TextSlice {
+    const char *bytes;
+    size_t size;
+} TextSlice;
+
+/**
+ * The size of a caller buffer backing a text of the given capacity, see Text_withBuffer.
+ * Accounts for the private header, up to its alignment and the terminator.
+ */
+#define TEXT_BUFFER_SIZE(capacity)  (5 * sizeof(void *) + (capacity))
+
+#define TEXT_BYTE_SET_SMALL     8
+
+/*
+ * Private: a set of bytes used by the splitting functions.
+ */
+struct Text_ByteSet {
+    uint32_t bitmap[8];
+    unsigned char bytes[TEXT_BYTE_SET_SMALL];   // meaningful only if size <= TEXT_BYTE_SET_SMALL
+    size_t size;
+};
+
+/**
+ * A lazy iterator over the tokens of a text, it never allocates: tokens are slices into the content of the text.
+ * The text must not be modified nor deleted while iterating.
+ * Fields are private.
+ */
+typedef struct TextSplitIterator {
+    const char *begin;
+    const char *end;
+    const char *separator;
+    size_t separatorSize;
+    size_t splitsLeft;
+    struct Text_ByteSet delimiters;
+    bool reverse;
+    bool exhausted;
+} TextSplitIterator;
+
 /**
  * Creates an empty text using default capacity.
  *
@@ -73,6 +115,23 @@ __attribute__((__warn_unused_result__));
 extern Text Text_withCapacity(size_t capacity)
 __attribute__((__warn_unused_result__));
 
+/**
+ * Creates a new text whose content lives in a caller provided buffer, for instance on the stack.
+ * The text can be used with every function, it is moved to the heap only when it outgrows the buffer
+ * and the returned reference tells when that happened. Text_shrinkToFit leaves it in the buffer.
+ * Text_delete must still be called, it frees nothing unless the text has been moved to the heap.
+ *
+ * @attention buffer must not be NULL.
+ * @attention size must be greater or equal than TEXT_BUFFER_SIZE(0).
+ * @attention the buffer must outlive the text, unless it has been moved to the heap.
+ *
+ * @param buffer The memory backing the text, with no alignment requirement.
+ * @param size The size of buffer, usually TEXT_BUFFER_SIZE(capacity).
+ * @return a new text instance, with at least the capacity given to TEXT_BUFFER_SIZE.
+ */
+extern Text Text_withBuffer(void *buffer, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
 /**
  * Creates a new JSON compliant quoted instance of text starting from bytes.
  *
@@ -86,6 +145,37 @@ __attribute__((__warn_unused_result__));
 extern Text Text_quoted(const void *bytes, size_t size)
 __attribute__((__warn_unused_result__, __nonnull__));
 
+/**
+ * Creates a new text decoding a JSON string literal.
+ * Escaped code points (\uXXXX, surrogate pairs included) are encoded as UTF-8.
+ * Unescaped bytes are copied as they are.
+ * Text_quoted escapes each byte from 0x80 on its own as \u00XX, which decodes to the UTF-8 encoding of U+0080 to U+00FF:
+ * the two functions are the inverse of each other only for bytes below 0x80.
+ *
+ * @attention bytes array must not be NULL.
+ * @attention the size of the bytes array must be less than SIZE_MAX.
+ *
+ * @param bytes The sequence of bytes, including the enclosing quotes.
+ * @param size The size of bytes.
+ * @return a new text instance, or NULL if bytes is not a valid string literal.
+ */
+extern Text Text_unquoted(const void *bytes, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates a new text escaping bytes for HTML and XML content and attribute values:
+ * '&', '<', '>', '"' and '\'' are replaced by "&amp;", "&lt;", "&gt;", "&quot;" and "&#39;".
+ *
+ * @attention bytes array must not be NULL.
+ * @attention the size of the bytes array must be less than SIZE_MAX.
+ *
+ * @param bytes The sequence of bytes.
+ * @param size The size of bytes.
+ * @return a new text instance.
+ */
+extern Text Text_escapedHtml(const void *bytes, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
 /**
  * Creates a new text from a printf-like format.
  *
@@ -416,6 +506,32 @@ __attribute__((__warn_unused_result__, __nonnull__));
 extern Text Text_quote(Text *ref)
 __attribute__((__warn_unused_result__, __nonnull__));
 
+/**
+ * Modifies text decoding in place the JSON string literal it contains, see Text_unquoted.
+ * The decoded content is never longer than the literal so the capacity of the text is unchanged.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The text instance.
+ * @return true on success, false if the content is not a valid string literal in which case the text is unchanged.
+ */
+extern bool Text_unquote(Text self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Modifies text escaping in place it's content for HTML and XML, see Text_escapedHtml.
+ * The text is expanded at most once, if there is nothing to escape it's left untouched.
+ *
+ * @attention ref and *ref must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @return the modified text instance
+ */
+extern Text Text_escapeHtml(Text *ref)
+__attribute__((__warn_unused_result__, __nonnull__));
+
 /**
  * Erases content from this text.
  * Note: A starting index equal to the ending one will result in a no-op.
@@ -497,6 +613,7 @@ __attribute__((__nonnull__));
 
 /**
  * Expands (if needed) the text to fit the requested capacity.
+ * A text outgrowing its caller provided buffer is moved to the heap.
  *
  * @attention ref and *ref must not be NULL.
  * @attention capacity must be less than SIZE_MAX.
@@ -510,6 +627,7 @@ __attribute__((__warn_unused_result__, __nonnull__));
 
 /**
  * Shrinks the capacity of the text to fit the size of its content.
+ * A text backed by a caller provided buffer is left as is.
  *
  * @attention ref and *ref must not be NULL.
  * @attention the reference to the text will be invalidated after this call, the new text is returned.
@@ -616,9 +734,208 @@ __attribute__((__warn_unused_result__, __nonnull__));
 extern bool Text_equals(TextView self, TextView other)
 __attribute__((__warn_unused_result__, __nonnull__));
 
+/**
+ * Compares lexicographically the bytes of the texts, embedded zeros included.
+ * Bytes are compared as unsigned values, a text preceding another is less than it.
+ *
+ * @attention self must not be NULL.
+ * @attention other must not be NULL.
+ *
+ * @return a negative value, zero or a positive value if self is respectively less than, equal to or greater than other.
+ */
+extern int Text_compare(TextView self, TextView other)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the length of the longest common prefix of the texts.
+ *
+ * @attention self must not be NULL.
+ * @attention other must not be NULL.
+ */
+extern size_t Text_commonPrefixLength(TextView self, TextView other)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Checks if the text starts with the given bytes.
+ *
+ * @attention self must not be NULL.
+ * @attention prefix must not be NULL.
+ *
+ * @param self The text instance.
+ * @param prefix The bytes to look for.
+ * @param size The number of bytes of prefix.
+ */
+extern bool Text_startsWith(TextView self, const void *prefix, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Checks if the text ends with the given bytes.
+ *
+ * @attention self must not be NULL.
+ * @attention suffix must not be NULL.
+ *
+ * @param self The text instance.
+ * @param suffix The bytes to look for.
+ * @param size The number of bytes of suffix.
+ */
+extern bool Text_endsWith(TextView self, const void *suffix, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Checks for equality ignoring the case of ASCII letters, no temporary copies are made.
+ *
+ * @attention self must not be NULL.
+ * @attention other must not be NULL.
+ */
+extern bool Text_equalsIgnoreCase(TextView self, TextView other)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Compares lexicographically the bytes of the texts ignoring the case of ASCII letters.
+ * Letters are compared as lower case, a text preceding another is less than it.
+ *
+ * @attention self must not be NULL.
+ * @attention other must not be NULL.
+ *
+ * @return a negative value, zero or a positive value if self is respectively less than, equal to or greater than other.
+ */
+extern int Text_compareIgnoreCase(TextView self, TextView other)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Finds the first occurrence of needle starting from offset ignoring the case of ASCII letters.
+ * An empty needle is found at offset.
+ *
+ * @attention self must not be NULL.
+ * @attention needle must not be NULL.
+ * @attention terminates execution if offset is greater than the text's length.
+ *
+ * @param self The text instance.
+ * @param offset The index the search starts from.
+ * @param needle The bytes to search for.
+ * @param size The number of bytes of needle.
+ * @return the index of the occurrence, SIZE_MAX if not found.
+ */
+extern size_t Text_findIgnoreCase(TextView self, size_t offset, const void *needle, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over the tokens of the text separated by the delimiter byte.
+ * Adjacent delimiters produce empty tokens, an empty text produces a single empty token.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The text instance.
+ * @param delimiter The delimiter byte.
+ * @return the iterator.
+ */
+extern TextSplitIterator Text_splitByByte(TextView self, char delimiter)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over the tokens of the text separated by any of the delimiter bytes.
+ * Adjacent delimiters produce empty tokens, an empty text produces a single empty token.
+ *
+ * @attention self must not be NULL.
+ * @attention delimiters must not be NULL.
+ * @attention size must be greater than 0.
+ *
+ * @param self The text instance.
+ * @param delimiters The set of delimiter bytes.
+ * @param size The size of the delimiters array.
+ * @return the iterator.
+ */
+extern TextSplitIterator Text_splitByByteSet(TextView self, const void *delimiters, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over the tokens of the text separated by the separator.
+ * Adjacent separators produce empty tokens, an empty text produces a single empty token.
+ *
+ * @attention self must not be NULL.
+ * @attention separator must not be NULL and must outlive the iterator.
+ * @attention size must be greater than 0.
+ *
+ * @param self The text instance.
+ * @param separator The separator bytes.
+ * @param size The size of the separator.
+ * @return the iterator.
+ */
+extern TextSplitIterator Text_splitBySeparator(TextView self, const void *separator, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Limits the number of splits performed by the iterator, once the limit is reached the rest of the text
+ * is yielded as the last token.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The iterator.
+ * @param maxSplits The maximum number of splits.
+ */
+extern void TextSplitIterator_setMaxSplits(TextSplitIterator *self, size_t maxSplits)
+__attribute__((__nonnull__));
+
+/**
+ * Makes the iterator yield tokens starting from the end of the text.
+ * Combined with TextSplitIterator_setMaxSplits, splits are counted from the end of the text.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The iterator.
+ * @param reverse true to iterate backward.
+ */
+extern void TextSplitIterator_setReverse(TextSplitIterator *self, bool reverse)
+__attribute__((__nonnull__));
+
+/**
+ * Advances the iterator.
+ *
+ * @attention self must not be NULL.
+ * @attention token must not be NULL.
+ *
+ * @param self The iterator.
+ * @param token The slice to be filled with the next token.
+ * @return true if a token was produced, false if the iterator is exhausted.
+ */
+extern bool TextSplitIterator_next(TextSplitIterator *self, TextSlice *token)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Enables recycling on the calling thread: Text_delete caches heap blocks, up to maxBytes in total,
+ * and the constructors reuse a cached block of sufficient capacity instead of allocating.
+ * Blocks are bucketed by the highest bit of their capacity, a reused one may have more capacity than requested.
+ * Calling it again changes the limit, trimming the cache if needed. The cache is freed when the thread exits.
+ *
+ * @attention texts must not be used after Text_delete, since their memory may be handed to new texts.
+ *
+ * @param maxBytes The maximum number of bytes kept by the cache of the calling thread.
+ */
+extern void Text_enableRecycling(size_t maxBytes);
+
+/**
+ * Disables recycling on the calling thread freeing its cache.
+ */
+extern void Text_disableRecycling(void);
+
+/**
+ * Frees cached blocks of the calling thread, largest first, until at most maxBytes are kept.
+ *
+ * @param maxBytes The maximum number of bytes to keep, 0 to free the whole cache.
+ */
+extern void Text_trimRecycled(size_t maxBytes);
+
+/**
+ * Gets the number of bytes cached by the calling thread.
+ */
+extern size_t Text_recycledBytes(void)
+__attribute__((__warn_unused_result__));
+
 /**
  * Deletes an instance of a text.
  * If NULL nothing will be done.
+ * If recycling is enabled on the calling thread, heap blocks are kept for reuse instead of being freed.
+ * The buffer of a text created by Text_withBuffer is left untouched.
  *
  * @param self The instance to be deleted.
  */
@@ -0,0 +1,508 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_async.h"
+#include "text_config.h"
+
+#if TEXT_ASYNC_THREADS < 1U
+    #error
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+    #if __has_include(<linux/io_uring.h>)
+        #include <sys/mman.h>
+        #include <sys/syscall.h>
+        #include <linux/io_uring.h>
+        #define TEXT_ASYNC_URING    1
+    #endif
+#endif
+
+enum OperationKind {
+    Operation_Read,
+    Operation_Write,
+};
+
+struct Operation {
+    struct Operation *next;
+    enum OperationKind kind;
+    int fd;
+    off_t offset;
+    Text text;          // reads only
+    size_t length;      // length of the text when queued
+    size_t maxBytes;
+    struct iovec *vectors;  // writes only
+    size_t count;
+    void *userData;
+    ssize_t result;
+};
+
+struct OperationQueue {
+    struct Operation *head;
+    struct Operation *tail;
+};
+
+static void OperationQueue_push(struct OperationQueue *const self, struct Operation *const operation) {
+    operation->next = NULL;
+    if (self->tail) {
+        self->tail->next = operation;
+    } else {
+        self->head = operation;
+    }
+    self->tail = operation;
+}
+
+static struct Operation *OperationQueue_pop(struct OperationQueue *const self) {
+    struct Operation *operation = self->head;
+    if (operation) {
+        self->head = operation->next;
+        if (NULL == self->head) {
+            self->tail = NULL;
+        }
+    }
+    return operation;
+}
+
+#ifdef TEXT_ASYNC_URING
+
+struct Uring {
+    int fd;
+    unsigned *sqTail;
+    unsigned *sqMask;
+    unsigned *sqArray;
+    struct io_uring_sqe *sqes;
+    unsigned *cqHead;
+    unsigned *cqTail;
+    unsigned *cqMask;
+    struct io_uring_cqe *cqes;
+    void *sqRing;
+    size_t sqRingSize;
+    void *cqRing;
+    size_t cqRingSize;
+    size_t sqesSize;
+};
+
+#endif
+
+struct TextAsync {
+    TextAsyncBackend backend;
+    unsigned depth;
+    size_t inFlight;
+    struct OperationQueue queued;
+#ifdef TEXT_ASYNC_URING
+    struct Uring uring;
+#endif
+    pthread_t threads[TEXT_ASYNC_THREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t workAvailable;
+    pthread_cond_t workCompleted;
+    struct OperationQueue work;
+    struct OperationQueue completed;
+    bool stopping;
+};
+
+static size_t clampSize(const size_t size, const size_t limit) {
+    return size > limit ? limit : size;
+}
+
+/*
+ * io_uring backend, driven through raw system calls so that no liburing is needed.
+ */
+#ifdef TEXT_ASYNC_URING
+
+static int Uring_enter(const struct Uring *const self, const unsigned toSubmit, const unsigned minComplete,
+                       const unsigned flags) {
+    long result;
+    do {
+        result = syscall(__NR_io_uring_enter, self->fd, toSubmit, minComplete, flags, NULL, 0);
+    } while (result < 0 && EINTR == errno);
+    return (int) result;
+}
+
+static bool Uring_init(struct Uring *const self, const unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const long fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+        return false;
+    }
+    self->fd = (int) fd;
+    if (!(params.features & IORING_FEAT_RW_CUR_POS)) {
+        close(self->fd);
+        return false;
+    }
+
+    self->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    self->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    self->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    const bool singleMap = 0 != (params.features & IORING_FEAT_SINGLE_MMAP);
+    if (singleMap) {
+        self->sqRingSize = self->cqRingSize = self->sqRingSize > self->cqRingSize ? self->sqRingSize : self->cqRingSize;
+    }
+
+    self->sqRing = mmap(NULL, self->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, self->fd,
+                        IORING_OFF_SQ_RING);
+    self->cqRing = singleMap || MAP_FAILED == self->sqRing
+                   ? self->sqRing
+                   : mmap(NULL, self->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, self->fd,
+                          IORING_OFF_CQ_RING);
+    self->sqes = MAP_FAILED == self->cqRing
+                 ? MAP_FAILED
+                 : mmap(NULL, self->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, self->fd,
+                        IORING_OFF_SQES);
+    if (MAP_FAILED == self->sqes) {
+        if (MAP_FAILED != self->cqRing && self->cqRing != self->sqRing) {
+            munmap(self->cqRing, self->cqRingSize);
+        }
+        if (MAP_FAILED != self->sqRing) {
+            munmap(self->sqRing, self->sqRingSize);
+        }
+        close(self->fd);
+        return false;
+    }
+
+    char *sqRing = self->sqRing, *cqRing = self->cqRing;
+    self->sqTail = (unsigned *) (sqRing + params.sq_off.tail);
+    self->sqMask = (unsigned *) (sqRing + params.sq_off.ring_mask);
+    self->sqArray = (unsigned *) (sqRing + params.sq_off.array);
+    self->cqHead = (unsigned *) (cqRing + params.cq_off.head);
+    self->cqTail = (unsigned *) (cqRing + params.cq_off.tail);
+    self->cqMask = (unsigned *) (cqRing + params.cq_off.ring_mask);
+    self->cqes = (struct io_uring_cqe *) (cqRing + params.cq_off.cqes);
+    return true;
+}
+
+static void Uring_teardown(struct Uring *const self) {
+    munmap(self->sqes, self->sqesSize);
+    if (self->cqRing != self->sqRing) {
+        munmap(self->cqRing, self->cqRingSize);
+    }
+    munmap(self->sqRing, self->sqRingSize);
+    close(self->fd);
+}
+
+static size_t Uring_submit(TextAsync *const self) {
+    struct Uring *uring = &self->uring;
+    unsigned tail = *uring->sqTail, submitted = 0;
+    while (self->queued.head && self->inFlight < self->depth) {
+        struct Operation *operation = OperationQueue_pop(&self->queued);
+        const unsigned index = tail & *uring->sqMask;
+        struct io_uring_sqe *sqe = &uring->sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->fd = operation->fd;
+        sqe->off = operation->offset < 0 ? UINT64_MAX : (uint64_t) operation->offset;
+        sqe->user_data = (uint64_t) (uintptr_t) operation;
+        if (Operation_Read == operation->kind) {
+            sqe->opcode = IORING_OP_READ;
+            sqe->addr = (uint64_t) (uintptr_t) (operation->text + operation->length);
+            sqe->len = (unsigned) clampSize(operation->maxBytes, INT_MAX);
+        } else {
+            sqe->opcode = IORING_OP_WRITEV;
+            sqe->addr = (uint64_t) (uintptr_t) operation->vectors;
+            sqe->len = (unsigned) operation->count;
+        }
+        uring->sqArray[index] = index;
+        tail++;
+        submitted++;
+        self->inFlight++;
+    }
+    __atomic_store_n(uring->sqTail, tail, __ATOMIC_RELEASE);
+
+    for (unsigned pending = submitted; pending > 0;) {
+        const int result = Uring_enter(uring, pending, 0, 0);
+        if (result < 0) {
+            Panic_terminate("Unable to submit to io_uring: %s", strerror(errno));
+        }
+        pending -= (unsigned) result;
+    }
+    return submitted;
+}
+
+static struct Operation *Uring_reap(TextAsync *const self) {
+    struct Uring *uring = &self->uring;
+    const unsigned head = *uring->cqHead;
+    while (head == __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE)) {
+        if (Uring_enter(uring, 0, 1, IORING_ENTER_GETEVENTS) < 0) {
+            Panic_terminate("Unable to wait on io_uring: %s", strerror(errno));
+        }
+    }
+    const struct io_uring_cqe *cqe = &uring->cqes[head & *uring->cqMask];
+    struct Operation *operation = (struct Operation *) (uintptr_t) cqe->user_data;
+    operation->result = cqe->res;
+    __atomic_store_n(uring->cqHead, head + 1, __ATOMIC_RELEASE);
+    return operation;
+}
+
+#endif
+
+/*
+ * Thread pool backend.
+ */
+static void execute(struct Operation *const operation) {
+    ssize_t result;
+    do {
+        if (Operation_Read == operation->kind) {
+            char *buffer = operation->text + operation->length;
+            const size_t size = clampSize(operation->maxBytes, SSIZE_MAX);
+            result = operation->offset < 0
+                     ? read(operation->fd, buffer, size)
+                     : pread(operation->fd, buffer, size, operation->offset);
+        } else {
+            const int count = (int) clampSize(operation->count, INT_MAX);
+            result = operation->offset < 0
+                     ? writev(operation->fd, operation->vectors, count)
+                     : pwritev(operation->fd, operation->vectors, count, operation->offset);
+        }
+    } while (result < 0 && EINTR == errno);
+    operation->result = result < 0 ? -errno : result;
+}
+
+static void *work(void *const argument) {
+    TextAsync *self = argument;
+    pthread_mutex_lock(&self->mutex);
+    for (;;) {
+        while (NULL == self->work.head && !self->stopping) {
+            pthread_cond_wait(&self->workAvailable, &self->mutex);
+        }
+        if (NULL == self->work.head) {
+            break;
+        }
+        struct Operation *operation = OperationQueue_pop(&self->work);
+        pthread_mutex_unlock(&self->mutex);
+        execute(operation);
+        pthread_mutex_lock(&self->mutex);
+        OperationQueue_push(&self->completed, operation);
+        pthread_cond_signal(&self->workCompleted);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+static void ThreadPool_init(TextAsync *const self) {
+    self->work.head = self->work.tail = NULL;
+    self->completed.head = self->completed.tail = NULL;
+    self->stopping = false;
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->workAvailable, NULL);
+    pthread_cond_init(&self->workCompleted, NULL);
+    for (unsigned i = 0; i < TEXT_ASYNC_THREADS; i++) {
+        if (0 != pthread_create(&self->threads[i], NULL, work, self)) {
+            Panic_terminate("Unable to create thread");
+        }
+    }
+}
+
+static void ThreadPool_teardown(TextAsync *const self) {
+    pthread_mutex_lock(&self->mutex);
+    self->stopping = true;
+    pthread_cond_broadcast(&self->workAvailable);
+    pthread_mutex_unlock(&self->mutex);
+    for (unsigned i = 0; i < TEXT_ASYNC_THREADS; i++) {
+        pthread_join(self->threads[i], NULL);
+    }
+    pthread_cond_destroy(&self->workCompleted);
+    pthread_cond_destroy(&self->workAvailable);
+    pthread_mutex_destroy(&self->mutex);
+}
+
+static size_t ThreadPool_submit(TextAsync *const self) {
+    size_t submitted = 0;
+    pthread_mutex_lock(&self->mutex);
+    while (self->queued.head && self->inFlight < self->depth) {
+        OperationQueue_push(&self->work, OperationQueue_pop(&self->queued));
+        self->inFlight++;
+        submitted++;
+    }
+    if (submitted > 0) {
+        pthread_cond_broadcast(&self->workAvailable);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return submitted;
+}
+
+static struct Operation *ThreadPool_reap(TextAsync *const self) {
+    pthread_mutex_lock(&self->mutex);
+    while (NULL == self->completed.head) {
+        pthread_cond_wait(&self->workCompleted, &self->mutex);
+    }
+    struct Operation *operation = OperationQueue_pop(&self->completed);
+    pthread_mutex_unlock(&self->mutex);
+    return operation;
+}
+
+/*
+ * Public interface.
+ */
+static TextAsync *makeAsync(const unsigned depth, const bool tryUring) {
+    assert(depth > 0);
+    TextAsync *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    self->depth = depth;
+    self->inFlight = 0;
+    self->queued.head = self->queued.tail = NULL;
+#ifdef TEXT_ASYNC_URING
+    if (tryUring && Uring_init(&self->uring, depth)) {
+        self->backend = TextAsyncBackend_Uring;
+        return self;
+    }
+#else
+    (void) tryUring;
+#endif
+    self->backend = TextAsyncBackend_ThreadPool;
+    ThreadPool_init(self);
+    return self;
+}
+
+TextAsync *TextAsync_new(const unsigned depth) {
+    assert(depth > 0);
+    return makeAsync(depth, true);
+}
+
+TextAsync *TextAsync_withThreadPool(const unsigned depth) {
+    assert(depth > 0);
+    return makeAsync(depth, false);
+}
+
+TextAsyncBackend TextAsync_backend(const TextAsync *const self) {
+    assert(self);
+    return self->backend;
+}
+
+static struct Operation *makeOperation(const enum OperationKind kind, const int fd, const off_t offset,
+                                       void *const userData) {
+    struct Operation *operation = Option_unwrap(Alligator_malloc(sizeof(*operation)));
+    memset(operation, 0, sizeof(*operation));
+    operation->kind = kind;
+    operation->fd = fd;
+    operation->offset = offset < 0 ? -1 : offset;
+    operation->userData = userData;
+    return operation;
+}
+
+void TextAsync_queueRead(TextAsync *const self, const int fd, const off_t offset, Text *const ref,
+                         const size_t maxBytes, void *const userData) {
+    assert(self);
+    assert(ref);
+    assert(*ref);
+    assert(maxBytes > 0);
+    assert(maxBytes < SIZE_MAX);
+    struct Operation *operation = makeOperation(Operation_Read, fd, offset, userData);
+    operation->length = Text_length(*ref);
+    operation->maxBytes = maxBytes;
+    operation->text = Text_expandToFit(ref, operation->length + maxBytes);
+    OperationQueue_push(&self->queued, operation);
+}
+
+void TextAsync_queueWrite(TextAsync *const self, const int fd, const off_t offset, const Text *const texts,
+                          const size_t count, void *const userData) {
+    assert(self);
+    assert(texts);
+    assert(count > 0);
+    struct Operation *operation = makeOperation(Operation_Write, fd, offset, userData);
+    operation->vectors = Option_unwrap(Alligator_malloc(sizeof(operation->vectors[0]) * count));
+    operation->count = count;
+    for (size_t i = 0; i < count; i++) {
+        assert(texts[i]);
+        operation->vectors[i].iov_base = texts[i];
+        operation->vectors[i].iov_len = Text_length(texts[i]);
+    }
+    OperationQueue_push(&self->queued, operation);
+}
+
+size_t TextAsync_submit(TextAsync *const self) {
+    assert(self);
+#ifdef TEXT_ASYNC_URING
+    if (TextAsyncBackend_Uring == self->backend) {
+        return Uring_submit(self);
+    }
+#endif
+    return ThreadPool_submit(self);
+}
+
+bool TextAsync_wait(TextAsync *const self, TextAsyncCompletion *const completion) {
+    assert(self);
+    assert(completion);
+    TextAsync_submit(self);
+    if (0 == self->inFlight) {
+        return false;
+    }
+
+    struct Operation *operation;
+#ifdef TEXT_ASYNC_URING
+    if (TextAsyncBackend_Uring == self->backend) {
+        operation = Uring_reap(self);
+    } else {
+        operation = ThreadPool_reap(self);
+    }
+#else
+    operation = ThreadPool_reap(self);
+#endif
+    self->inFlight--;
+
+    completion->userData = operation->userData;
+    completion->result = operation->result;
+    completion->text = operation->text;
+    if (Operation_Read == operation->kind && operation->result > 0) {
+        Text_setLength(operation->text, operation->length + (size_t) operation->result);
+    }
+    Alligator_free(operation->vectors);
+    Alligator_free(operation);
+    return true;
+}
+
+void TextAsync_delete(TextAsync *const self) {
+    if (self) {
+        struct Operation *operation;
+        while ((operation = OperationQueue_pop(&self->queued))) {
+            Text_delete(operation->text);
+            Alligator_free(operation->vectors);
+            Alligator_free(operation);
+        }
+        TextAsyncCompletion completion;
+        while (TextAsync_wait(self, &completion)) {
+            Text_delete(completion.text);
+        }
+#ifdef TEXT_ASYNC_URING
+        if (TextAsyncBackend_Uring == self->backend) {
+            Uring_teardown(&self->uring);
+        } else {
+            ThreadPool_teardown(self);
+        }
+#else
+        ThreadPool_teardown(self);
+#endif
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,169 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <sys/types.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Asynchronous reads into and writes from texts, allowing one thread to keep many files in flight.
+ * Operations are queued, submitted in batches and reaped as completions.
+ * On Linux io_uring is used when the kernel allows it, otherwise operations are run by a pool of threads.
+ *
+ * A TextAsync instance must be used by a single thread.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+typedef struct TextAsync TextAsync;
+
+typedef enum TextAsyncBackend {
+    TextAsyncBackend_Uring,
+    TextAsyncBackend_ThreadPool,
+} TextAsyncBackend;
+
+/**
+ * The outcome of an operation.
+ */
+typedef struct TextAsyncCompletion {
+    void *userData;     // as given on queueing
+    Text text;          // reads: the text handed over on queueing, owned again by the caller; writes: NULL
+    ssize_t result;     // number of bytes transferred, or the negated errno value on failure
+} TextAsyncCompletion;
+
+/**
+ * Creates an instance using io_uring if available, a thread pool otherwise.
+ *
+ * @attention depth must be greater than 0.
+ *
+ * @param depth The maximum number of operations in flight.
+ * @return a new instance.
+ */
+extern TextAsync *TextAsync_new(unsigned depth)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Creates an instance always using the thread pool.
+ *
+ * @attention depth must be greater than 0.
+ *
+ * @param depth The maximum number of operations in flight.
+ * @return a new instance.
+ */
+extern TextAsync *TextAsync_withThreadPool(unsigned depth)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Gets the backend in use.
+ *
+ * @attention self must not be NULL.
+ */
+extern TextAsyncBackend TextAsync_backend(const TextAsync *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Queues a read of at most maxBytes bytes appended into the spare capacity of the text.
+ * The capacity is expanded before queueing, when the operation completes the length of the text is updated and the
+ * text is handed back through the completion.
+ *
+ * @attention self must not be NULL.
+ * @attention ref and *ref must not be NULL.
+ * @attention maxBytes must be greater than 0 and less than SIZE_MAX.
+ *
+ * @attention the reference to the text will be invalidated after this call, the text is returned by the completion.
+ *
+ * @param self The instance.
+ * @param fd The file descriptor to read from.
+ * @param offset The file offset to read at, or -1 to read at the current file position.
+ * @param ref The text instance reference.
+ * @param maxBytes The maximum number of bytes to read.
+ * @param userData Opaque data handed back through the completion.
+ */
+extern void TextAsync_queueRead(TextAsync *self, int fd, off_t offset, Text *ref, size_t maxBytes, void *userData)
+__attribute__((__nonnull__(1, 4)));
+
+/**
+ * Queues a gathered write of the contents of the texts, like writev a single operation may write partially.
+ *
+ * @attention self must not be NULL.
+ * @attention texts must not be NULL and must hold count non NULL texts that must stay unchanged until completion.
+ * @attention count must be greater than 0.
+ *
+ * @param self The instance.
+ * @param fd The file descriptor to write to.
+ * @param offset The file offset to write at, or -1 to write at the current file position.
+ * @param texts The array of texts.
+ * @param count The number of texts.
+ * @param userData Opaque data handed back through the completion.
+ */
+extern void TextAsync_queueWrite(TextAsync *self, int fd, off_t offset, const Text *texts, size_t count,
+                                 void *userData)
+__attribute__((__nonnull__(1, 4)));
+
+/**
+ * Submits the queued operations, as many as the depth allows.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The instance.
+ * @return the number of operations submitted.
+ */
+extern size_t TextAsync_submit(TextAsync *self)
+__attribute__((__nonnull__));
+
+/**
+ * Submits the queued operations and waits for a completion.
+ *
+ * @attention self must not be NULL.
+ * @attention completion must not be NULL.
+ *
+ * @param self The instance.
+ * @param completion Filled with the outcome of the completed operation.
+ * @return true if an operation completed, false if there are no operations queued nor in flight.
+ */
+extern bool TextAsync_wait(TextAsync *self, TextAsyncCompletion *completion)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance waiting for the operations in flight, texts of pending reads are deleted.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextAsync_delete(TextAsync *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,721 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Generated by scripts/generate_case_tables.py from Unicode 14.0.0, do not edit.
+ *
+ * A code point below TEXT_CASE_LIMIT selects a block through TextCase_stage1 (cp >> TEXT_CASE_SHIFT),
+ * the block selects a record through TextCase_stage2. Code points at or above the limit are caseless.
+ * Single code point mappings are stored as deltas, longer ones as an index into TextCase_specials.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#define TEXT_CASE_SHIFT     7
+#define TEXT_CASE_LIMIT     0x1E980U
+
+struct TextCase_Record {
+    int32_t delta[3];       // lower, upper, fold
+    uint16_t special[3];    // lower, upper, fold
+};
+
+static const struct TextCase_Record TextCase_records[279] = {
+        {{0, 0, 0}, {0, 0, 0}},
+        {{32, 0, 32}, {0, 0, 0}},
+        {{0, -32, 0}, {0, 0, 0}},
+        {{0, 743, 775}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 1, 2}},
+        {{0, 121, 0}, {0, 0, 0}},
+        {{1, 0, 1}, {0, 0, 0}},
+        {{0, -1, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {3, 0, 3}},
+        {{0, -232, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 4, 5}},
+        {{-121, 0, -121}, {0, 0, 0}},
+        {{0, -300, -268}, {0, 0, 0}},
+        {{0, 195, 0}, {0, 0, 0}},
+        {{210, 0, 210}, {0, 0, 0}},
+        {{206, 0, 206}, {0, 0, 0}},
+        {{205, 0, 205}, {0, 0, 0}},
+        {{79, 0, 79}, {0, 0, 0}},
+        {{202, 0, 202}, {0, 0, 0}},
+        {{203, 0, 203}, {0, 0, 0}},
+        {{207, 0, 207}, {0, 0, 0}},
+        {{0, 97, 0}, {0, 0, 0}},
+        {{211, 0, 211}, {0, 0, 0}},
+        {{209, 0, 209}, {0, 0, 0}},
+        {{0, 163, 0}, {0, 0, 0}},
+        {{213, 0, 213}, {0, 0, 0}},
+        {{0, 130, 0}, {0, 0, 0}},
+        {{214, 0, 214}, {0, 0, 0}},
+        {{218, 0, 218}, {0, 0, 0}},
+        {{217, 0, 217}, {0, 0, 0}},
+        {{219, 0, 219}, {0, 0, 0}},
+        {{0, 56, 0}, {0, 0, 0}},
+        {{2, 0, 2}, {0, 0, 0}},
+        {{1, -1, 1}, {0, 0, 0}},
+        {{0, -2, 0}, {0, 0, 0}},
+        {{0, -79, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 6, 7}},
+        {{-97, 0, -97}, {0, 0, 0}},
+        {{-56, 0, -56}, {0, 0, 0}},
+        {{-130, 0, -130}, {0, 0, 0}},
+        {{10795, 0, 10795}, {0, 0, 0}},
+        {{-163, 0, -163}, {0, 0, 0}},
+        {{10792, 0, 10792}, {0, 0, 0}},
+        {{0, 10815, 0}, {0, 0, 0}},
+        {{-195, 0, -195}, {0, 0, 0}},
+        {{69, 0, 69}, {0, 0, 0}},
+        {{71, 0, 71}, {0, 0, 0}},
+        {{0, 10783, 0}, {0, 0, 0}},
+        {{0, 10780, 0}, {0, 0, 0}},
+        {{0, 10782, 0}, {0, 0, 0}},
+        {{0, -210, 0}, {0, 0, 0}},
+        {{0, -206, 0}, {0, 0, 0}},
+        {{0, -205, 0}, {0, 0, 0}},
+        {{0, -202, 0}, {0, 0, 0}},
+        {{0, -203, 0}, {0, 0, 0}},
+        {{0, 42319, 0}, {0, 0, 0}},
+        {{0, 42315, 0}, {0, 0, 0}},
+        {{0, -207, 0}, {0, 0, 0}},
+        {{0, 42280, 0}, {0, 0, 0}},
+        {{0, 42308, 0}, {0, 0, 0}},
+        {{0, -209, 0}, {0, 0, 0}},
+        {{0, -211, 0}, {0, 0, 0}},
+        {{0, 10743, 0}, {0, 0, 0}},
+        {{0, 42305, 0}, {0, 0, 0}},
+        {{0, 10749, 0}, {0, 0, 0}},
+        {{0, -213, 0}, {0, 0, 0}},
+        {{0, -214, 0}, {0, 0, 0}},
+        {{0, 10727, 0}, {0, 0, 0}},
+        {{0, -218, 0}, {0, 0, 0}},
+        {{0, 42307, 0}, {0, 0, 0}},
+        {{0, 42282, 0}, {0, 0, 0}},
+        {{0, -69, 0}, {0, 0, 0}},
+        {{0, -217, 0}, {0, 0, 0}},
+        {{0, -71, 0}, {0, 0, 0}},
+        {{0, -219, 0}, {0, 0, 0}},
+        {{0, 42261, 0}, {0, 0, 0}},
+        {{0, 42258, 0}, {0, 0, 0}},
+        {{0, 84, 116}, {0, 0, 0}},
+        {{116, 0, 116}, {0, 0, 0}},
+        {{38, 0, 38}, {0, 0, 0}},
+        {{37, 0, 37}, {0, 0, 0}},
+        {{64, 0, 64}, {0, 0, 0}},
+        {{63, 0, 63}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 8, 9}},
+        {{0, -38, 0}, {0, 0, 0}},
+        {{0, -37, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 10, 11}},
+        {{0, -31, 1}, {0, 0, 0}},
+        {{0, -64, 0}, {0, 0, 0}},
+        {{0, -63, 0}, {0, 0, 0}},
+        {{8, 0, 8}, {0, 0, 0}},
+        {{0, -62, -30}, {0, 0, 0}},
+        {{0, -57, -25}, {0, 0, 0}},
+        {{0, -47, -15}, {0, 0, 0}},
+        {{0, -54, -22}, {0, 0, 0}},
+        {{0, -8, 0}, {0, 0, 0}},
+        {{0, -86, -54}, {0, 0, 0}},
+        {{0, -80, -48}, {0, 0, 0}},
+        {{0, 7, 0}, {0, 0, 0}},
+        {{0, -116, 0}, {0, 0, 0}},
+        {{-60, 0, -60}, {0, 0, 0}},
+        {{0, -96, -64}, {0, 0, 0}},
+        {{-7, 0, -7}, {0, 0, 0}},
+        {{80, 0, 80}, {0, 0, 0}},
+        {{0, -80, 0}, {0, 0, 0}},
+        {{15, 0, 15}, {0, 0, 0}},
+        {{0, -15, 0}, {0, 0, 0}},
+        {{48, 0, 48}, {0, 0, 0}},
+        {{0, -48, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 12, 13}},
+        {{7264, 0, 7264}, {0, 0, 0}},
+        {{0, 3008, 0}, {0, 0, 0}},
+        {{38864, 0, 0}, {0, 0, 0}},
+        {{8, 0, 0}, {0, 0, 0}},
+        {{0, -8, -8}, {0, 0, 0}},
+        {{0, -6254, -6222}, {0, 0, 0}},
+        {{0, -6253, -6221}, {0, 0, 0}},
+        {{0, -6244, -6212}, {0, 0, 0}},
+        {{0, -6242, -6210}, {0, 0, 0}},
+        {{0, -6243, -6211}, {0, 0, 0}},
+        {{0, -6236, -6204}, {0, 0, 0}},
+        {{0, -6181, -6180}, {0, 0, 0}},
+        {{0, 35266, 35267}, {0, 0, 0}},
+        {{-3008, 0, -3008}, {0, 0, 0}},
+        {{0, 35332, 0}, {0, 0, 0}},
+        {{0, 3814, 0}, {0, 0, 0}},
+        {{0, 35384, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 14, 15}},
+        {{0, 0, 0}, {0, 16, 17}},
+        {{0, 0, 0}, {0, 18, 19}},
+        {{0, 0, 0}, {0, 20, 21}},
+        {{0, 0, 0}, {0, 22, 23}},
+        {{0, -59, -58}, {0, 0, 0}},
+        {{-7615, 0, 0}, {0, 0, 2}},
+        {{0, 8, 0}, {0, 0, 0}},
+        {{-8, 0, -8}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 24, 25}},
+        {{0, 0, 0}, {0, 26, 27}},
+        {{0, 0, 0}, {0, 28, 29}},
+        {{0, 0, 0}, {0, 30, 31}},
+        {{0, 74, 0}, {0, 0, 0}},
+        {{0, 86, 0}, {0, 0, 0}},
+        {{0, 100, 0}, {0, 0, 0}},
+        {{0, 128, 0}, {0, 0, 0}},
+        {{0, 112, 0}, {0, 0, 0}},
+        {{0, 126, 0}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 32, 33}},
+        {{0, 0, 0}, {0, 34, 35}},
+        {{0, 0, 0}, {0, 36, 37}},
+        {{0, 0, 0}, {0, 38, 39}},
+        {{0, 0, 0}, {0, 40, 41}},
+        {{0, 0, 0}, {0, 42, 43}},
+        {{0, 0, 0}, {0, 44, 45}},
+        {{0, 0, 0}, {0, 46, 47}},
+        {{-8, 0, 0}, {0, 32, 33}},
+        {{-8, 0, 0}, {0, 34, 35}},
+        {{-8, 0, 0}, {0, 36, 37}},
+        {{-8, 0, 0}, {0, 38, 39}},
+        {{-8, 0, 0}, {0, 40, 41}},
+        {{-8, 0, 0}, {0, 42, 43}},
+        {{-8, 0, 0}, {0, 44, 45}},
+        {{-8, 0, 0}, {0, 46, 47}},
+        {{0, 0, 0}, {0, 48, 49}},
+        {{0, 0, 0}, {0, 50, 51}},
+        {{0, 0, 0}, {0, 52, 53}},
+        {{0, 0, 0}, {0, 54, 55}},
+        {{0, 0, 0}, {0, 56, 57}},
+        {{0, 0, 0}, {0, 58, 59}},
+        {{0, 0, 0}, {0, 60, 61}},
+        {{0, 0, 0}, {0, 62, 63}},
+        {{-8, 0, 0}, {0, 48, 49}},
+        {{-8, 0, 0}, {0, 50, 51}},
+        {{-8, 0, 0}, {0, 52, 53}},
+        {{-8, 0, 0}, {0, 54, 55}},
+        {{-8, 0, 0}, {0, 56, 57}},
+        {{-8, 0, 0}, {0, 58, 59}},
+        {{-8, 0, 0}, {0, 60, 61}},
+        {{-8, 0, 0}, {0, 62, 63}},
+        {{0, 0, 0}, {0, 64, 65}},
+        {{0, 0, 0}, {0, 66, 67}},
+        {{0, 0, 0}, {0, 68, 69}},
+        {{0, 0, 0}, {0, 70, 71}},
+        {{0, 0, 0}, {0, 72, 73}},
+        {{0, 0, 0}, {0, 74, 75}},
+        {{0, 0, 0}, {0, 76, 77}},
+        {{0, 0, 0}, {0, 78, 79}},
+        {{-8, 0, 0}, {0, 64, 65}},
+        {{-8, 0, 0}, {0, 66, 67}},
+        {{-8, 0, 0}, {0, 68, 69}},
+        {{-8, 0, 0}, {0, 70, 71}},
+        {{-8, 0, 0}, {0, 72, 73}},
+        {{-8, 0, 0}, {0, 74, 75}},
+        {{-8, 0, 0}, {0, 76, 77}},
+        {{-8, 0, 0}, {0, 78, 79}},
+        {{0, 0, 0}, {0, 80, 81}},
+        {{0, 0, 0}, {0, 82, 83}},
+        {{0, 0, 0}, {0, 84, 85}},
+        {{0, 0, 0}, {0, 86, 87}},
+        {{0, 0, 0}, {0, 88, 89}},
+        {{-74, 0, -74}, {0, 0, 0}},
+        {{-9, 0, 0}, {0, 82, 83}},
+        {{0, -7205, -7173}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 90, 91}},
+        {{0, 0, 0}, {0, 92, 93}},
+        {{0, 0, 0}, {0, 94, 95}},
+        {{0, 0, 0}, {0, 96, 97}},
+        {{0, 0, 0}, {0, 98, 99}},
+        {{-86, 0, -86}, {0, 0, 0}},
+        {{-9, 0, 0}, {0, 92, 93}},
+        {{0, 0, 0}, {0, 100, 101}},
+        {{0, 0, 0}, {0, 102, 103}},
+        {{0, 0, 0}, {0, 104, 105}},
+        {{-100, 0, -100}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 106, 107}},
+        {{0, 0, 0}, {0, 108, 109}},
+        {{0, 0, 0}, {0, 110, 111}},
+        {{0, 0, 0}, {0, 112, 113}},
+        {{-112, 0, -112}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 114, 115}},
+        {{0, 0, 0}, {0, 116, 117}},
+        {{0, 0, 0}, {0, 118, 119}},
+        {{0, 0, 0}, {0, 120, 121}},
+        {{0, 0, 0}, {0, 122, 123}},
+        {{-128, 0, -128}, {0, 0, 0}},
+        {{-126, 0, -126}, {0, 0, 0}},
+        {{-9, 0, 0}, {0, 116, 117}},
+        {{-7517, 0, -7517}, {0, 0, 0}},
+        {{-8383, 0, -8383}, {0, 0, 0}},
+        {{-8262, 0, -8262}, {0, 0, 0}},
+        {{28, 0, 28}, {0, 0, 0}},
+        {{0, -28, 0}, {0, 0, 0}},
+        {{16, 0, 16}, {0, 0, 0}},
+        {{0, -16, 0}, {0, 0, 0}},
+        {{26, 0, 26}, {0, 0, 0}},
+        {{0, -26, 0}, {0, 0, 0}},
+        {{-10743, 0, -10743}, {0, 0, 0}},
+        {{-3814, 0, -3814}, {0, 0, 0}},
+        {{-10727, 0, -10727}, {0, 0, 0}},
+        {{0, -10795, 0}, {0, 0, 0}},
+        {{0, -10792, 0}, {0, 0, 0}},
+        {{-10780, 0, -10780}, {0, 0, 0}},
+        {{-10749, 0, -10749}, {0, 0, 0}},
+        {{-10783, 0, -10783}, {0, 0, 0}},
+        {{-10782, 0, -10782}, {0, 0, 0}},
+        {{-10815, 0, -10815}, {0, 0, 0}},
+        {{0, -7264, 0}, {0, 0, 0}},
+        {{-35332, 0, -35332}, {0, 0, 0}},
+        {{-42280, 0, -42280}, {0, 0, 0}},
+        {{0, 48, 0}, {0, 0, 0}},
+        {{-42308, 0, -42308}, {0, 0, 0}},
+        {{-42319, 0, -42319}, {0, 0, 0}},
+        {{-42315, 0, -42315}, {0, 0, 0}},
+        {{-42305, 0, -42305}, {0, 0, 0}},
+        {{-42258, 0, -42258}, {0, 0, 0}},
+        {{-42282, 0, -42282}, {0, 0, 0}},
+        {{-42261, 0, -42261}, {0, 0, 0}},
+        {{928, 0, 928}, {0, 0, 0}},
+        {{-48, 0, -48}, {0, 0, 0}},
+        {{-42307, 0, -42307}, {0, 0, 0}},
+        {{-35384, 0, -35384}, {0, 0, 0}},
+        {{0, -928, 0}, {0, 0, 0}},
+        {{0, -38864, -38864}, {0, 0, 0}},
+        {{0, 0, 0}, {0, 124, 125}},
+        {{0, 0, 0}, {0, 126, 127}},
+        {{0, 0, 0}, {0, 128, 129}},
+        {{0, 0, 0}, {0, 130, 131}},
+        {{0, 0, 0}, {0, 132, 133}},
+        {{0, 0, 0}, {0, 134, 135}},
+        {{0, 0, 0}, {0, 136, 137}},
+        {{0, 0, 0}, {0, 138, 139}},
+        {{0, 0, 0}, {0, 140, 141}},
+        {{0, 0, 0}, {0, 142, 143}},
+        {{0, 0, 0}, {0, 144, 145}},
+        {{40, 0, 40}, {0, 0, 0}},
+        {{0, -40, 0}, {0, 0, 0}},
+        {{39, 0, 39}, {0, 0, 0}},
+        {{0, -39, 0}, {0, 0, 0}},
+        {{34, 0, 34}, {0, 0, 0}},
+        {{0, -34, 0}, {0, 0, 0}}
+};
+
+static const uint32_t TextCase_specials[146][3] = {
+        {0x0000, 0x0000, 0x0000},
+        {0x0053, 0x0053, 0x0000},
+        {0x0073, 0x0073, 0x0000},
+        {0x0069, 0x0307, 0x0000},
+        {0x02BC, 0x004E, 0x0000},
+        {0x02BC, 0x006E, 0x0000},
+        {0x004A, 0x030C, 0x0000},
+        {0x006A, 0x030C, 0x0000},
+        {0x0399, 0x0308, 0x0301},
+        {0x03B9, 0x0308, 0x0301},
+        {0x03A5, 0x0308, 0x0301},
+        {0x03C5, 0x0308, 0x0301},
+        {0x0535, 0x0552, 0x0000},
+        {0x0565, 0x0582, 0x0000},
+        {0x0048, 0x0331, 0x0000},
+        {0x0068, 0x0331, 0x0000},
+        {0x0054, 0x0308, 0x0000},
+        {0x0074, 0x0308, 0x0000},
+        {0x0057, 0x030A, 0x0000},
+        {0x0077, 0x030A, 0x0000},
+        {0x0059, 0x030A, 0x0000},
+        {0x0079, 0x030A, 0x0000},
+        {0x0041, 0x02BE, 0x0000},
+        {0x0061, 0x02BE, 0x0000},
+        {0x03A5, 0x0313, 0x0000},
+        {0x03C5, 0x0313, 0x0000},
+        {0x03A5, 0x0313, 0x0300},
+        {0x03C5, 0x0313, 0x0300},
+        {0x03A5, 0x0313, 0x0301},
+        {0x03C5, 0x0313, 0x0301},
+        {0x03A5, 0x0313, 0x0342},
+        {0x03C5, 0x0313, 0x0342},
+        {0x1F08, 0x0399, 0x0000},
+        {0x1F00, 0x03B9, 0x0000},
+        {0x1F09, 0x0399, 0x0000},
+        {0x1F01, 0x03B9, 0x0000},
+        {0x1F0A, 0x0399, 0x0000},
+        {0x1F02, 0x03B9, 0x0000},
+        {0x1F0B, 0x0399, 0x0000},
+        {0x1F03, 0x03B9, 0x0000},
+        {0x1F0C, 0x0399, 0x0000},
+        {0x1F04, 0x03B9, 0x0000},
+        {0x1F0D, 0x0399, 0x0000},
+        {0x1F05, 0x03B9, 0x0000},
+        {0x1F0E, 0x0399, 0x0000},
+        {0x1F06, 0x03B9, 0x0000},
+        {0x1F0F, 0x0399, 0x0000},
+        {0x1F07, 0x03B9, 0x0000},
+        {0x1F28, 0x0399, 0x0000},
+        {0x1F20, 0x03B9, 0x0000},
+        {0x1F29, 0x0399, 0x0000},
+        {0x1F21, 0x03B9, 0x0000},
+        {0x1F2A, 0x0399, 0x0000},
+        {0x1F22, 0x03B9, 0x0000},
+        {0x1F2B, 0x0399, 0x0000},
+        {0x1F23, 0x03B9, 0x0000},
+        {0x1F2C, 0x0399, 0x0000},
+        {0x1F24, 0x03B9, 0x0000},
+        {0x1F2D, 0x0399, 0x0000},
+        {0x1F25, 0x03B9, 0x0000},
+        {0x1F2E, 0x0399, 0x0000},
+        {0x1F26, 0x03B9, 0x0000},
+        {0x1F2F, 0x0399, 0x0000},
+        {0x1F27, 0x03B9, 0x0000},
+        {0x1F68, 0x0399, 0x0000},
+        {0x1F60, 0x03B9, 0x0000},
+        {0x1F69, 0x0399, 0x0000},
+        {0x1F61, 0x03B9, 0x0000},
+        {0x1F6A, 0x0399, 0x0000},
+        {0x1F62, 0x03B9, 0x0000},
+        {0x1F6B, 0x0399, 0x0000},
+        {0x1F63, 0x03B9, 0x0000},
+        {0x1F6C, 0x0399, 0x0000},
+        {0x1F64, 0x03B9, 0x0000},
+        {0x1F6D, 0x0399, 0x0000},
+        {0x1F65, 0x03B9, 0x0000},
+        {0x1F6E, 0x0399, 0x0000},
+        {0x1F66, 0x03B9, 0x0000},
+        {0x1F6F, 0x0399, 0x0000},
+        {0x1F67, 0x03B9, 0x0000},
+        {0x1FBA, 0x0399, 0x0000},
+        {0x1F70, 0x03B9, 0x0000},
+        {0x0391, 0x0399, 0x0000},
+        {0x03B1, 0x03B9, 0x0000},
+        {0x0386, 0x0399, 0x0000},
+        {0x03AC, 0x03B9, 0x0000},
+        {0x0391, 0x0342, 0x0000},
+        {0x03B1, 0x0342, 0x0000},
+        {0x0391, 0x0342, 0x0399},
+        {0x03B1, 0x0342, 0x03B9},
+        {0x1FCA, 0x0399, 0x0000},
+        {0x1F74, 0x03B9, 0x0000},
+        {0x0397, 0x0399, 0x0000},
+        {0x03B7, 0x03B9, 0x0000},
+        {0x0389, 0x0399, 0x0000},
+        {0x03AE, 0x03B9, 0x0000},
+        {0x0397, 0x0342, 0x0000},
+        {0x03B7, 0x0342, 0x0000},
+        {0x0397, 0x0342, 0x0399},
+        {0x03B7, 0x0342, 0x03B9},
+        {0x0399, 0x0308, 0x0300},
+        {0x03B9, 0x0308, 0x0300},
+        {0x0399, 0x0342, 0x0000},
+        {0x03B9, 0x0342, 0x0000},
+        {0x0399, 0x0308, 0x0342},
+        {0x03B9, 0x0308, 0x0342},
+        {0x03A5, 0x0308, 0x0300},
+        {0x03C5, 0x0308, 0x0300},
+        {0x03A1, 0x0313, 0x0000},
+        {0x03C1, 0x0313, 0x0000},
+        {0x03A5, 0x0342, 0x0000},
+        {0x03C5, 0x0342, 0x0000},
+        {0x03A5, 0x0308, 0x0342},
+        {0x03C5, 0x0308, 0x0342},
+        {0x1FFA, 0x0399, 0x0000},
+        {0x1F7C, 0x03B9, 0x0000},
+        {0x03A9, 0x0399, 0x0000},
+        {0x03C9, 0x03B9, 0x0000},
+        {0x038F, 0x0399, 0x0000},
+        {0x03CE, 0x03B9, 0x0000},
+        {0x03A9, 0x0342, 0x0000},
+        {0x03C9, 0x0342, 0x0000},
+        {0x03A9, 0x0342, 0x0399},
+        {0x03C9, 0x0342, 0x03B9},
+        {0x0046, 0x0046, 0x0000},
+        {0x0066, 0x0066, 0x0000},
+        {0x0046, 0x0049, 0x0000},
+        {0x0066, 0x0069, 0x0000},
+        {0x0046, 0x004C, 0x0000},
+        {0x0066, 0x006C, 0x0000},
+        {0x0046, 0x0046, 0x0049},
+        {0x0066, 0x0066, 0x0069},
+        {0x0046, 0x0046, 0x004C},
+        {0x0066, 0x0066, 0x006C},
+        {0x0053, 0x0054, 0x0000},
+        {0x0073, 0x0074, 0x0000},
+        {0x0544, 0x0546, 0x0000},
+        {0x0574, 0x0576, 0x0000},
+        {0x0544, 0x0535, 0x0000},
+        {0x0574, 0x0565, 0x0000},
+        {0x0544, 0x053B, 0x0000},
+        {0x0574, 0x056B, 0x0000},
+        {0x054E, 0x0546, 0x0000},
+        {0x057E, 0x0576, 0x0000},
+        {0x0544, 0x053D, 0x0000},
+        {0x0574, 0x056D, 0x0000}
+};
+
+static const uint8_t TextCase_stage1[979] = {
+        0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 13, 12, 12, 12, 12, 12, 14, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 15, 16, 17, 18, 19, 20, 21,
+        12, 12, 22, 23, 12, 12, 12, 12, 12, 24, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 25, 26, 27, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 28, 29, 30, 31,
+        12, 12, 12, 12, 12, 12, 32, 33, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 34, 12, 12, 12, 12, 12, 12, 12, 35, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 36, 37, 38, 39, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 40, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 41, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 42, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12,
+        12, 12, 43
+};
+
+static const uint16_t TextCase_stage2[5632] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+        0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 4,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 2, 2, 2, 2, 2, 2, 2, 5,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 8, 9, 6, 7, 6, 7, 6, 7, 0, 6, 7, 6, 7, 6, 7, 6,
+        7, 6, 7, 6, 7, 6, 7, 6, 7, 10, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 11, 6, 7, 6, 7, 6, 7, 12,
+        13, 14, 6, 7, 6, 7, 15, 6, 7, 16, 16, 6, 7, 0, 17, 18, 19, 6, 7, 16, 20, 21, 22, 23, 6, 7, 24, 0, 22, 25, 26, 27,
+        6, 7, 6, 7, 6, 7, 28, 6, 7, 28, 0, 0, 6, 7, 28, 6, 7, 29, 29, 6, 7, 6, 7, 30, 6, 7, 0, 0, 6, 7, 0, 31,
+        0, 0, 0, 0, 32, 33, 34, 32, 33, 34, 32, 33, 34, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 35, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 36, 32, 33, 34, 6, 7, 37, 38, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        39, 0, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 0, 0, 0, 0, 40, 6, 7, 41, 42, 43,
+        43, 6, 7, 44, 45, 46, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 47, 48, 49, 50, 51, 0, 52, 52, 0, 53, 0, 54, 55, 0, 0, 0,
+        52, 56, 0, 57, 0, 58, 59, 0, 60, 61, 59, 62, 63, 0, 0, 61, 0, 64, 65, 0, 0, 66, 0, 0, 0, 0, 0, 0, 0, 67, 0, 0,
+        68, 0, 69, 68, 0, 0, 0, 70, 68, 71, 72, 72, 73, 0, 0, 0, 0, 0, 74, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 75, 76, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 77, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 7, 6, 7, 0, 0, 6, 7, 0, 0, 0, 26, 26, 26, 0, 78,
+        0, 0, 0, 0, 0, 0, 79, 0, 80, 80, 80, 0, 81, 0, 82, 82, 83, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 84, 85, 85, 85, 86, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 87, 2, 2, 2, 2, 2, 2, 2, 2, 2, 88, 89, 89, 90, 91, 92, 0, 0, 0, 93, 94, 95, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 96, 97, 98, 99, 100, 101, 0, 6, 7, 102, 6, 7, 0, 39, 39, 39,
+        103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 103, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104, 104,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        105, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 106, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107,
+        107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108,
+        108, 108, 108, 108, 108, 108, 108, 109, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110, 110,
+        110, 110, 110, 110, 110, 110, 0, 110, 0, 0, 0, 0, 0, 110, 0, 0, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111,
+        111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 111, 0, 0, 111, 111, 111,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112,
+        112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 112, 113, 113, 113, 113, 113, 113, 0, 0, 114, 114, 114, 114, 114, 114, 0, 0,
+        115, 116, 117, 118, 118, 119, 120, 121, 122, 0, 0, 0, 0, 0, 0, 0, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123,
+        123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 123, 0, 0, 123, 123, 123,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 124, 0, 0, 0, 125, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 126, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 127, 128, 129, 130, 131, 132, 0, 0, 133, 0,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135, 135, 134, 134, 134, 134, 134, 134, 0, 0, 135, 135, 135, 135, 135, 135, 0, 0,
+        134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135, 135, 134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135, 135,
+        134, 134, 134, 134, 134, 134, 0, 0, 135, 135, 135, 135, 135, 135, 0, 0, 136, 134, 137, 134, 138, 134, 139, 134, 0, 135, 0, 135, 0, 135, 0, 135,
+        134, 134, 134, 134, 134, 134, 134, 134, 135, 135, 135, 135, 135, 135, 135, 135, 140, 140, 141, 141, 141, 141, 142, 142, 143, 143, 144, 144, 145, 145, 0, 0,
+        146, 147, 148, 149, 150, 151, 152, 153, 154, 155, 156, 157, 158, 159, 160, 161, 162, 163, 164, 165, 166, 167, 168, 169, 170, 171, 172, 173, 174, 175, 176, 177,
+        178, 179, 180, 181, 182, 183, 184, 185, 186, 187, 188, 189, 190, 191, 192, 193, 134, 134, 194, 195, 196, 0, 197, 198, 135, 135, 199, 199, 200, 0, 201, 0,
+        0, 0, 202, 203, 204, 0, 205, 206, 207, 207, 207, 207, 208, 0, 0, 0, 134, 134, 209, 83, 0, 0, 210, 211, 135, 135, 212, 212, 0, 0, 0, 0,
+        134, 134, 213, 86, 214, 98, 215, 216, 135, 135, 217, 217, 102, 0, 0, 0, 0, 0, 218, 219, 220, 0, 221, 222, 223, 223, 224, 224, 225, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 226, 0, 0, 0, 227, 228, 0, 0, 0, 0, 0, 0, 229, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 230, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 231, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232, 232,
+        0, 0, 0, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233,
+        233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 233, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 234,
+        234, 234, 234, 234, 234, 234, 234, 234, 234, 234, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107,
+        107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 107, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108,
+        108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108, 108,
+        6, 7, 235, 236, 237, 238, 239, 6, 7, 6, 7, 6, 7, 240, 241, 242, 243, 0, 6, 7, 0, 6, 7, 0, 0, 0, 0, 0, 0, 0, 244, 244,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 0, 0, 0, 0, 0, 0, 0, 6, 7, 6, 7, 0, 0, 0, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245, 245,
+        245, 245, 245, 245, 245, 245, 0, 245, 0, 0, 0, 0, 0, 245, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 7, 6, 7, 246, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 0, 0, 0, 6, 7, 247, 0, 0, 6, 7, 6, 7, 248, 0, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 249, 250, 251, 252, 249, 0, 253, 254, 255, 256, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7, 6, 7,
+        6, 7, 6, 7, 257, 258, 259, 6, 7, 6, 7, 0, 0, 0, 0, 0, 6, 7, 0, 0, 0, 0, 6, 7, 6, 7, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 6, 7, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 260, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261,
+        261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261,
+        261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261, 261,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        262, 263, 264, 265, 266, 267, 267, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 268, 269, 270, 271, 272, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0,
+        0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273,
+        273, 273, 273, 273, 273, 273, 273, 273, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274,
+        274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273,
+        273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 273, 0, 0, 0, 0, 274, 274, 274, 274, 274, 274, 274, 274,
+        274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 274, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 275, 275, 275, 275, 275, 275, 275, 275, 275, 275, 275, 0, 275, 275, 275, 275,
+        275, 275, 275, 275, 275, 275, 275, 275, 275, 275, 275, 0, 275, 275, 275, 275, 275, 275, 275, 0, 275, 275, 0, 276, 276, 276, 276, 276, 276, 276, 276, 276,
+        276, 276, 0, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 276, 0, 276, 276, 276, 276, 276, 276, 276, 0, 276, 276, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81,
+        81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 81, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88,
+        88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 88, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277, 277,
+        277, 277, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278, 278,
+        278, 278, 278, 278, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
@@ -0,0 +1,539 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "text_codec.h"
+#include "text_header.h"
+#include "text_simd.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TEXT_CODEC_X86  1
+#endif
+
+#define INVALID     0xFF
+
+static const char BASE64_STANDARD[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static const char BASE64_URL_SAFE[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+static const char HEX_DIGITS[] = "0123456789abcdef";
+static const char UPPER_HEX_DIGITS[] = "0123456789ABCDEF";
+
+static bool hasSsse3(void) {
+#ifdef TEXT_CODEC_X86
+    static int supported = -1;
+    if (supported < 0) {
+        __builtin_cpu_init();
+        supported = __builtin_cpu_supports("ssse3") ? 1 : 0;
+    }
+    return 1 == supported;
+#else
+    return false;
+#endif
+}
+
+static const char *base64Symbols(const TextBase64Alphabet alphabet) {
+    return TextBase64Alphabet_UrlSafe == alphabet ? BASE64_URL_SAFE : BASE64_STANDARD;
+}
+
+static unsigned char base64Value(const char *const symbols, const unsigned char c) {
+    if (c >= 'A' && c <= 'Z') {
+        return (unsigned char) (c - 'A');
+    }
+    if (c >= 'a' && c <= 'z') {
+        return (unsigned char) (c - 'a' + 26);
+    }
+    if (c >= '0' && c <= '9') {
+        return (unsigned char) (c - '0' + 52);
+    }
+    if (c == (unsigned char) symbols[62]) {
+        return 62;
+    }
+    return c == (unsigned char) symbols[63] ? 63 : INVALID;
+}
+
+#ifdef TEXT_CODEC_X86
+
+/*
+ * Vectorized base64 following "Faster Base64 Encoding and Decoding Using AVX2 Instructions" (Muła, Lemire).
+ * Both routines process whole blocks only and return the number of input bytes consumed.
+ */
+
+/*
+ * Encodes 12 bytes into 16 characters per iteration, 16 bytes are loaded so 4 more bytes must be readable.
+ */
+__attribute__((__target__("ssse3")))
+static size_t encodeBase64Ssse3(char *out, const unsigned char *const bytes, const size_t size,
+                                const char *const symbols) {
+    const __m128i shifts = _mm_setr_epi8(
+            (char) ('a' - 26), (char) ('0' - 52), (char) ('0' - 52), (char) ('0' - 52), (char) ('0' - 52),
+            (char) ('0' - 52), (char) ('0' - 52), (char) ('0' - 52), (char) ('0' - 52), (char) ('0' - 52),
+            (char) ('0' - 52), (char) (symbols[62] - 62), (char) (symbols[63] - 63), 'A', 0, 0
+    );
+    size_t i = 0;
+    for (; i + 16 <= size; i += 12, out += 16) {
+        __m128i input = _mm_loadu_si128((const __m128i *) (bytes + i));
+        // spread each 3 bytes group over 4 bytes, then move each 6 bits index to its own byte
+        input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+        const __m128i high = _mm_mulhi_epu16(
+                _mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)
+        );
+        const __m128i low = _mm_mullo_epi16(
+                _mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)
+        );
+        const __m128i indices = _mm_or_si128(high, low);
+        // map each index to the offset of its range: 0..25 -> 13, 26..51 -> 0, 52..61 -> 1..10, 62 -> 11, 63 -> 12
+        __m128i ranges = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+        ranges = _mm_or_si128(ranges, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+        _mm_storeu_si128((__m128i *) out, _mm_add_epi8(indices, _mm_shuffle_epi8(shifts, ranges)));
+    }
+    return i;
+}
+
+static inline __m128i inRange(const __m128i input, const char first, const char last) {
+    return _mm_and_si128(
+            _mm_cmpgt_epi8(input, _mm_set1_epi8((char) (first - 1))),
+            _mm_cmplt_epi8(input, _mm_set1_epi8((char) (last + 1)))
+    );
+}
+
+/*
+ * Decodes 16 characters into 12 bytes per iteration, stopping at the first block having a character outside the
+ * alphabet (padding included). 16 bytes are stored so 4 more bytes of out must be writable.
+ */
+__attribute__((__target__("ssse3")))
+static size_t decodeBase64Ssse3(unsigned char *out, const unsigned char *const bytes, const size_t size,
+                                const char *const symbols) {
+    size_t i = 0;
+    for (; i + 16 <= size; i += 16, out += 12) {
+        const __m128i input = _mm_loadu_si128((const __m128i *) (bytes + i));
+        const __m128i upper = inRange(input, 'A', 'Z'), lower = inRange(input, 'a', 'z');
+        const __m128i digit = inRange(input, '0', '9');
+        const __m128i symbol62 = _mm_cmpeq_epi8(input, _mm_set1_epi8(symbols[62]));
+        const __m128i symbol63 = _mm_cmpeq_epi8(input, _mm_set1_epi8(symbols[63]));
+        const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(symbol62, symbol63)));
+        if (0xFFFF != _mm_movemask_epi8(valid)) {
+            break;
+        }
+        __m128i shifts = _mm_and_si128(upper, _mm_set1_epi8((char) -'A'));
+        shifts = _mm_or_si128(shifts, _mm_and_si128(lower, _mm_set1_epi8((char) (26 - 'a'))));
+        shifts = _mm_or_si128(shifts, _mm_and_si128(digit, _mm_set1_epi8((char) (52 - '0'))));
+        shifts = _mm_or_si128(shifts, _mm_and_si128(symbol62, _mm_set1_epi8((char) (62 - symbols[62]))));
+        shifts = _mm_or_si128(shifts, _mm_and_si128(symbol63, _mm_set1_epi8((char) (63 - symbols[63]))));
+        const __m128i values = _mm_add_epi8(input, shifts);
+        // join the 6 bits values in pairs, then the pairs into 24 bits words, then drop the fourth byte of each word
+        const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+        const __m128i words = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        _mm_storeu_si128((__m128i *) out, _mm_shuffle_epi8(
+                words, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+        ));
+    }
+    return i;
+}
+
+#endif
+
+Text Text_appendBase64(Text *const ref, const void *const bytes, const size_t size,
+                       const TextBase64Alphabet alphabet) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    const bool padded = TextBase64Alphabet_Standard == alphabet;
+    const char *const symbols = base64Symbols(alphabet);
+    const unsigned char *const data = bytes;
+    const size_t remainder = size % 3;
+    const size_t encodedSize = size / 3 * 4 + (remainder ? (padded ? 4 : remainder + 1) : 0);
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + encodedSize);
+    char *out = self + length;
+    size_t i = 0;
+
+#ifdef TEXT_CODEC_X86
+    if (hasSsse3()) {
+        i = encodeBase64Ssse3(out, data, size, symbols);
+        out += i / 3 * 4;
+    }
+#endif
+    for (; i + 3 <= size; i += 3) {
+        const uint32_t word = (uint32_t) data[i] << 16 | (uint32_t) data[i + 1] << 8 | data[i + 2];
+        *out++ = symbols[word >> 18];
+        *out++ = symbols[(word >> 12) & 0x3F];
+        *out++ = symbols[(word >> 6) & 0x3F];
+        *out++ = symbols[word & 0x3F];
+    }
+    if (remainder) {
+        const uint32_t word = (uint32_t) data[i] << 16 | (2 == remainder ? (uint32_t) data[i + 1] << 8 : 0);
+        *out++ = symbols[word >> 18];
+        *out++ = symbols[(word >> 12) & 0x3F];
+        if (2 == remainder) {
+            *out++ = symbols[(word >> 6) & 0x3F];
+        } else if (padded) {
+            *out++ = '=';
+        }
+        if (padded) {
+            *out++ = '=';
+        }
+    }
+
+    assert((size_t) (out - self) == length + encodedSize);
+    Text_setLength(self, length + encodedSize);
+    return self;
+}
+
+Text Text_appendFromBase64(Text *const ref, const void *const bytes, const size_t size,
+                           const TextBase64Alphabet alphabet, size_t *const invalidOffset) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    assert(invalidOffset);
+    const char *const symbols = base64Symbols(alphabet);
+    const unsigned char *const data = bytes;
+    size_t characters = size;
+
+    // padding is accepted only if it completes the last group
+    while (characters > 0 && size - characters < 2 && '=' == data[characters - 1]) {
+        characters--;
+    }
+    const size_t padding = size - characters, rest = characters % 4, required = rest > 1 ? 4 - rest : 0;
+    if (1 == rest || (padding > 0 && padding != required)) {
+        size_t i = 0;
+        while (i < characters && INVALID != base64Value(symbols, data[i])) {
+            i++;
+        }
+        if (i < characters) {
+            *invalidOffset = i;
+        } else if (1 == rest) {     // a lone last character: the end of the input or the '=' following it
+            *invalidOffset = characters;
+        } else {                    // the first '=' too many or the end of an incomplete padding
+            *invalidOffset = padding > required ? characters + required : size;
+        }
+        return Text_expandToFit(ref, Text_length(*ref));
+    }
+
+    const size_t decodedSize = characters / 4 * 3 + (characters % 4 ? characters % 4 - 1 : 0);
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + decodedSize);
+    unsigned char *out = (unsigned char *) self + length;
+    size_t i = 0;
+
+#ifdef TEXT_CODEC_X86
+    // the last 16 bytes store may exceed the decoded size by 4 bytes, keep 8 characters (6 bytes) in reserve
+    if (hasSsse3() && characters >= 8) {
+        i = decodeBase64Ssse3(out, data, characters - 8, symbols);
+        out += i / 4 * 3;
+    }
+#endif
+    uint32_t word = 0;
+    size_t pending = 0;
+    for (; i < characters; i++) {
+        const unsigned char value = base64Value(symbols, data[i]);
+        if (INVALID == value) {
+            *invalidOffset = i;
+            Text_setLength(self, length);
+            return self;
+        }
+        word = word << 6 | value;
+        if (4 == ++pending) {
+            *out++ = (unsigned char) (word >> 16);
+            *out++ = (unsigned char) (word >> 8);
+            *out++ = (unsigned char) word;
+            word = 0;
+            pending = 0;
+        }
+    }
+    if (pending > 1) {
+        word <<= 6 * (4 - pending);
+        *out++ = (unsigned char) (word >> 16);
+        if (3 == pending) {
+            *out++ = (unsigned char) (word >> 8);
+        }
+    }
+
+    assert((size_t) (out - (unsigned char *) self) == length + decodedSize);
+    *invalidOffset = SIZE_MAX;
+    Text_setLength(self, length + decodedSize);
+    return self;
+}
+
+/*
+ * Encodes size bytes into 2 * size digits, the SSE2 path encodes 16 bytes per iteration.
+ */
+static void encodeHex(char *out, const unsigned char *bytes, size_t size) {
+#ifdef TEXT_SIMD_SSE2
+    const __m128i nibble = _mm_set1_epi8(0x0F), nine = _mm_set1_epi8(9);
+    for (; size >= 16; size -= 16, bytes += 16, out += 32) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) bytes);
+        const __m128i high = _mm_and_si128(_mm_srli_epi16(block, 4), nibble), low = _mm_and_si128(block, nibble);
+        __m128i first = _mm_unpacklo_epi8(high, low), second = _mm_unpackhi_epi8(high, low);
+        // '0' + n, plus the distance between '9' + 1 and 'a' for letters
+        first = _mm_add_epi8(_mm_add_epi8(first, _mm_set1_epi8('0')),
+                             _mm_and_si128(_mm_cmpgt_epi8(first, nine), _mm_set1_epi8('a' - '9' - 1)));
+        second = _mm_add_epi8(_mm_add_epi8(second, _mm_set1_epi8('0')),
+                              _mm_and_si128(_mm_cmpgt_epi8(second, nine), _mm_set1_epi8('a' - '9' - 1)));
+        _mm_storeu_si128((__m128i *) out, first);
+        _mm_storeu_si128((__m128i *) (out + 16), second);
+    }
+#endif
+    for (; size > 0; size--, bytes++) {
+        *out++ = HEX_DIGITS[*bytes >> 4];
+        *out++ = HEX_DIGITS[*bytes & 0x0F];
+    }
+}
+
+#ifdef TEXT_SIMD_SSE2
+
+/*
+ * Converts 16 hexadecimal digits to their values, returns false if any of them is not a digit.
+ */
+static bool hexValues(const __m128i digits, __m128i *const values) {
+    const __m128i decimal = _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8('0' - 1)),
+                                          _mm_cmplt_epi8(digits, _mm_set1_epi8('9' + 1)));
+    const __m128i folded = _mm_or_si128(digits, _mm_set1_epi8(0x20));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(folded, _mm_set1_epi8('a' - 1)),
+                                         _mm_cmplt_epi8(folded, _mm_set1_epi8('f' + 1)));
+    if (0xFFFF != _mm_movemask_epi8(_mm_or_si128(decimal, letter))) {
+        return false;
+    }
+    *values = _mm_or_si128(_mm_and_si128(decimal, _mm_sub_epi8(digits, _mm_set1_epi8('0'))),
+                           _mm_and_si128(letter, _mm_sub_epi8(folded, _mm_set1_epi8('a' - 10))));
+    return true;
+}
+
+#endif
+
+/*
+ * Decodes pairs of digits, returns the offset of the first digit that can't be decoded, an unpaired last one included,
+ * or size if all of them were.
+ */
+static size_t decodeHex(unsigned char *out, const unsigned char *const digits, const size_t size) {
+    size_t i = 0;
+#ifdef TEXT_SIMD_SSE2
+    for (; i + 32 <= size; i += 32, out += 16) {
+        __m128i first, second;
+        if (!hexValues(_mm_loadu_si128((const __m128i *) (digits + i)), &first) ||
+            !hexValues(_mm_loadu_si128((const __m128i *) (digits + i + 16)), &second)) {
+            break;
+        }
+        // each 16 bits lane holds the high digit in its low byte and the low digit in its high byte
+        const __m128i mask = _mm_set1_epi16(0x00FF);
+        first = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(first, mask), 4), _mm_srli_epi16(first, 8));
+        second = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(second, mask), 4), _mm_srli_epi16(second, 8));
+        _mm_storeu_si128((__m128i *) out, _mm_packus_epi16(first, second));
+    }
+#endif
+    for (; i + 2 <= size; i += 2) {
+        const int high = TextSimd_hexValue(digits[i]), low = TextSimd_hexValue(digits[i + 1]);
+        if (high < 0) {
+            return i;
+        }
+        if (low < 0) {
+            return i + 1;
+        }
+        *out++ = (unsigned char) (high << 4 | low);
+    }
+    return i;
+}
+
+Text Text_appendHex(Text *const ref, const void *const bytes, const size_t size) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    assert(size <= (SIZE_MAX - 1 - Text_length(*ref)) / 2);
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + 2 * size);
+    encodeHex(self + length, bytes, size);
+    Text_setLength(self, length + 2 * size);
+    return self;
+}
+
+Text Text_appendFromHex(Text *const ref, const void *const bytes, const size_t size, size_t *const invalidOffset) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    assert(invalidOffset);
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + size / 2);
+    const size_t decoded = decodeHex((unsigned char *) self + length, bytes, size);
+    if (decoded < size) {
+        *invalidOffset = decoded;
+        Text_setLength(self, length);
+        return self;
+    }
+    *invalidOffset = SIZE_MAX;
+    Text_setLength(self, length + size / 2);
+    return self;
+}
+
+#define HEXDUMP_LINE_BYTES  16
+
+Text Text_appendHexdump(Text *const ref, const void *const bytes, const size_t size) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    const unsigned char *const data = bytes;
+    const size_t lines = (size + HEXDUMP_LINE_BYTES - 1) / HEXDUMP_LINE_BYTES;
+    size_t offsetDigits = 8;
+    while (size > 0 && offsetDigits < 2 * sizeof(size_t) && (size - 1) >> (4 * offsetDigits)) {
+        offsetDigits++;
+    }
+    // offset, 2 spaces, 16 hex columns of 3 characters, the group separator, " |", the ASCII column, "|\n"
+    const size_t lineOverhead = offsetDigits + 2 + 3 * HEXDUMP_LINE_BYTES + 1 + 2 + 2;
+    const size_t length = Text_length(*ref), dumpSize = lines * lineOverhead + size;
+    Text self = Text_expandToFit(ref, length + dumpSize);
+    char *out = self + length;
+
+    for (size_t offset = 0; offset < size; offset += HEXDUMP_LINE_BYTES) {
+        const size_t count = size - offset < HEXDUMP_LINE_BYTES ? size - offset : HEXDUMP_LINE_BYTES;
+        char digits[2 * HEXDUMP_LINE_BYTES];
+        encodeHex(digits, data + offset, count);
+        for (size_t i = offsetDigits; i > 0; i--) {
+            *out++ = HEX_DIGITS[(offset >> (4 * (i - 1))) & 0x0F];
+        }
+        *out++ = ' ';
+        for (size_t i = 0; i < HEXDUMP_LINE_BYTES; i++) {
+            if (HEXDUMP_LINE_BYTES / 2 == i) {
+                *out++ = ' ';
+            }
+            *out++ = ' ';
+            *out++ = i < count ? digits[2 * i] : ' ';
+            *out++ = i < count ? digits[2 * i + 1] : ' ';
+        }
+        *out++ = ' ';
+        *out++ = ' ';
+        *out++ = '|';
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char c = data[offset + i];
+            *out++ = c >= 0x20 && c < 0x7F ? (char) c : '.';
+        }
+        *out++ = '|';
+        *out++ = '\n';
+    }
+
+    assert((size_t) (out - self) == length + dumpSize);
+    Text_setLength(self, length + dumpSize);
+    return self;
+}
+
+/*
+ * Bytes left unencoded, bit i is set if the byte is safe in the TextUrlEncoding of value i.
+ */
+static const unsigned char URL_SAFE[256] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 2, 0, 0, 2, 0, 2, 2, 2, 2, 6, 2, 2, 7, 7, 2,
+        7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 2, 2, 0, 2, 0, 0,
+        2, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 0, 0, 0, 0, 7,
+        0, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+        7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 0, 0, 0, 3, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+static bool isUrlSafe(const unsigned char c, const TextUrlEncoding encoding) {
+    return 0 != (URL_SAFE[c] & (1U << encoding));
+}
+
+Text Text_appendUrlEncoded(Text *const ref, const void *const bytes, const size_t size,
+                           const TextUrlEncoding encoding) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    const unsigned char *const data = bytes;
+    const bool form = TextUrlEncoding_Form == encoding;
+    size_t encodedSize = size;
+    for (size_t i = 0; i < size; i++) {
+        if (!isUrlSafe(data[i], encoding) && !(form && ' ' == data[i])) {
+            encodedSize += 2;
+        }
+    }
+
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + encodedSize);
+    char *out = self + length;
+    size_t i = 0;
+    while (i < size) {
+        // copy the run of safe bytes at once
+        size_t run = i;
+        while (run < size && isUrlSafe(data[run], encoding)) {
+            run++;
+        }
+        memcpy(out, data + i, run - i);
+        out += run - i;
+        for (i = run; i < size && !isUrlSafe(data[i], encoding); i++) {
+            if (form && ' ' == data[i]) {
+                *out++ = '+';
+            } else {
+                *out++ = '%';
+                *out++ = UPPER_HEX_DIGITS[data[i] >> 4];
+                *out++ = UPPER_HEX_DIGITS[data[i] & 0x0F];
+            }
+        }
+    }
+
+    assert((size_t) (out - self) == length + encodedSize);
+    Text_setLength(self, length + encodedSize);
+    return self;
+}
+
+void Text_urlDecodeInPlace(Text self, const TextUrlEncoding encoding) {
+    assert(self);
+    Text_Header_getMutable(self);
+    struct Text_ByteSet escapes;
+    TextSimd_byteSetInit(&escapes, "%+", TextUrlEncoding_Form == encoding ? 2 : 1);
+    const char *cursor = self, *const end = self + Text_length(self);
+    char *out = self;
+
+    for (const char *escape; NULL != (escape = TextSimd_findFirstOf(cursor, end, &escapes)); ) {
+        memmove(out, cursor, (size_t) (escape - cursor));
+        out += escape - cursor;
+        cursor = escape + 1;
+        if ('+' == *escape) {
+            *out++ = ' ';
+            continue;
+        }
+        const int high = end - cursor >= 2 ? TextSimd_hexValue((unsigned char) cursor[0]) : -1;
+        const int low = high >= 0 ? TextSimd_hexValue((unsigned char) cursor[1]) : -1;
+        if (low < 0) {
+            *out++ = '%';
+        } else {
+            *out++ = (char) (high << 4 | low);
+            cursor += 2;
+        }
+    }
+    memmove(out, cursor, (size_t) (end - cursor));
+    out += end - cursor;
+    Text_setLength(self, (size_t) (out - self));
+}
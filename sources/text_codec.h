@@ -0,0 +1,193 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Binary-to-text encodings for texts.
+ * Encoders and decoders compute the exact size of their output and expand the text at most once.
+ *
+ * @attention Unless otherwise stated, every function in this module terminates the program in case of out of memory
+ * while malformed input is reported through the return value or an output parameter.
+ */
+
+/**
+ * Base64 alphabets (RFC 4648).
+ */
+typedef enum TextBase64Alphabet {
+    TextBase64Alphabet_Standard,    // '+' and '/', padded with '='
+    TextBase64Alphabet_UrlSafe,     // '-' and '_', not padded
+} TextBase64Alphabet;
+
+/**
+ * Appends the base64 encoding of the bytes.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The bytes to encode.
+ * @param size The number of bytes.
+ * @param alphabet The alphabet to encode with.
+ * @return the modified text instance
+ */
+extern Text Text_appendBase64(Text *ref, const void *bytes, size_t size, TextBase64Alphabet alphabet)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Appends the bytes decoded from base64, padding is optional for both alphabets.
+ * On malformed input nothing is appended.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ * @attention invalidOffset must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The base64 characters.
+ * @param size The number of characters.
+ * @param alphabet The alphabet to decode with.
+ * @param invalidOffset Set to SIZE_MAX on success, or to the offset of the first character that can't be decoded,
+ * that is a character out of the alphabet or a misplaced '=', or to size if the input ends in the middle of a group.
+ * @return the modified text instance
+ */
+extern Text Text_appendFromBase64(Text *ref, const void *bytes, size_t size, TextBase64Alphabet alphabet,
+                                  size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Appends the lowercase hexadecimal encoding of the bytes, two digits per byte.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The bytes to encode.
+ * @param size The number of bytes.
+ * @return the modified text instance
+ */
+extern Text Text_appendHex(Text *ref, const void *bytes, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Appends the bytes decoded from hexadecimal digits, both cases are accepted.
+ * On malformed input nothing is appended.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ * @attention invalidOffset must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The hexadecimal digits.
+ * @param size The number of digits.
+ * @param invalidOffset Set to SIZE_MAX on success, or to the offset of the first character that can't be decoded.
+ * @return the modified text instance
+ */
+extern Text Text_appendFromHex(Text *ref, const void *bytes, size_t size, size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Appends a canonical hexdump of the bytes: one line every 16 bytes made of the offset, the hexadecimal column
+ * split in two groups of 8 bytes and the printable ASCII column (other bytes are shown as '.'), e.g.
+ *
+ * 00000000  4c 6f 72 65 6d 20 69 70  73 75 6d 0a              |Lorem ipsum.|
+ *
+ * Offsets take 8 digits, or more when the size requires them.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The bytes to dump.
+ * @param size The number of bytes.
+ * @return the modified text instance
+ */
+extern Text Text_appendHexdump(Text *ref, const void *bytes, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Percent-encoding flavours, each one leaving a different set of bytes unencoded.
+ */
+typedef enum TextUrlEncoding {
+    TextUrlEncoding_Component,  // unreserved characters only (RFC 3986): ALPHA DIGIT - . _ ~
+    TextUrlEncoding_Path,       // unreserved characters, sub-delims, ':', '@' and '/'
+    TextUrlEncoding_Form,       // application/x-www-form-urlencoded: ALPHA DIGIT * - . _ and space as '+'
+} TextUrlEncoding;
+
+/**
+ * Appends the bytes percent-encoded, encoded bytes are written as '%' followed by two uppercase digits.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The bytes to encode.
+ * @param size The number of bytes.
+ * @param encoding The set of bytes left unencoded.
+ * @return the modified text instance
+ */
+extern Text Text_appendUrlEncoded(Text *ref, const void *bytes, size_t size, TextUrlEncoding encoding)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Decodes the percent-encoded content in place, the text can only shrink so it's never reallocated.
+ * Malformed sequences (a '%' not followed by two hexadecimal digits) are left as they are,
+ * in form encoding '+' is decoded as space.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The text instance.
+ * @param encoding The encoding the content has been produced with.
+ */
+extern void Text_urlDecodeInPlace(Text self, TextUrlEncoding encoding)
+__attribute__((__nonnull__));
+
+#ifdef __cplusplus
+}
+#endif
@@ -38,6 +38,15 @@ extern "C" {
 #define TEXT_DEFAULT_CAPACITY   128UL   // must be greater or equal than 32UL and less than SIZE_MAX
 #define TEXT_LOAD_FACTOR        1.6F    // must be greater than 1.1F
 
+#define TEXT_LINE_INDEX_BLOCK_LINES     64UL    // lines per delta-encoded block, must be greater than 1UL
+#define TEXT_LINE_READER_BLOCK_SIZE     65536UL // bytes requested to the kernel per refill, must be greater than 0UL
+#define TEXT_ASYNC_THREADS              4U      // workers of the thread pool used when io_uring is unavailable, must be greater than 0U
+#define TEXT_CODE_POINT_INDEX_STRIDE    4096UL  // bytes between code point index checkpoints, must be greater than 0UL
+#define TEXT_REGEX_CACHE_SIZE           2097152UL // bytes of lazily built DFA states per automaton, must be greater than 0UL
+#define TEXT_REGEX_MAX_INSTRUCTIONS     65536UL // size limit of compiled programs, must be greater than 0UL
+#define TEXT_SORT_PARALLEL_GRAIN        16384UL // elements below which a partition is sorted by one thread, must be greater than 0UL
+#define TEXT_PARALLEL_CHUNK_SIZE        262144UL // bytes per chunk of TextExecutor operations, must be greater or equal than 4UL
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,278 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <alligator/alligator.h>
+#include "text_csv.h"
+#include "text_simd.h"
+
+#define CHUNK_SIZE  64
+
+/*
+ * Checks the delimiter leaves quoting and record ends unambiguous; only used by assertions.
+ */
+__attribute__((__unused__))
+static bool isValidDelimiter(const char delimiter) {
+    return '"' != delimiter && '\r' != delimiter && '\n' != delimiter;
+}
+
+/*
+ * Gets the size of the field once written, quotes included.
+ */
+static size_t csvFieldSize(const char *const bytes, const size_t size, const char delimiter) {
+    struct Text_ByteSet specials;
+    const char set[] = {delimiter, '"', '\r', '\n'};
+    TextSimd_byteSetInit(&specials, set, sizeof(set));
+    if (NULL == TextSimd_findFirstOf(bytes, bytes + size, &specials)) {
+        return size;
+    }
+    size_t quotes = 0;
+    for (const char *cursor = bytes, *const end = bytes + size;
+         NULL != (cursor = memchr(cursor, '"', (size_t) (end - cursor))); cursor++) {
+        quotes++;
+    }
+    return size + quotes + 2;
+}
+
+/*
+ * Writes the field given its written size, returns the position following it.
+ */
+static char *writeCsvField(char *out, const char *const bytes, const size_t size, const size_t fieldSize) {
+    if (fieldSize == size) {
+        memcpy(out, bytes, size);
+        return out + size;
+    }
+    const char *cursor = bytes, *const end = bytes + size;
+    *out++ = '"';
+    for (const char *quote; NULL != (quote = memchr(cursor, '"', (size_t) (end - cursor))); cursor = quote + 1) {
+        memcpy(out, cursor, (size_t) (quote + 1 - cursor));
+        out += quote + 1 - cursor;
+        *out++ = '"';
+    }
+    memcpy(out, cursor, (size_t) (end - cursor));
+    out += end - cursor;
+    *out++ = '"';
+    return out;
+}
+
+Text Text_appendCsvField(Text *const ref, const void *const bytes, const size_t size, const char delimiter) {
+    assert(ref);
+    assert(*ref);
+    assert(bytes);
+    assert(isValidDelimiter(delimiter));
+    const size_t length = Text_length(*ref), fieldSize = csvFieldSize(bytes, size, delimiter);
+    Text self = Text_expandToFit(ref, length + fieldSize);
+    writeCsvField(self + length, bytes, size, fieldSize);
+    Text_setLength(self, length + fieldSize);
+    return self;
+}
+
+Text Text_appendCsvRecord(Text *const ref, const TextSlice *const fields, const size_t count, const char delimiter) {
+    assert(ref);
+    assert(*ref);
+    assert(fields);
+    assert(isValidDelimiter(delimiter));
+    size_t recordSize = (count > 0 ? count - 1 : 0) + 2;
+    for (size_t i = 0; i < count; i++) {
+        assert(fields[i].bytes);
+        recordSize += csvFieldSize(fields[i].bytes, fields[i].size, delimiter);
+    }
+
+    const size_t length = Text_length(*ref);
+    Text self = Text_expandToFit(ref, length + recordSize);
+    char *out = self + length;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0) {
+            *out++ = delimiter;
+        }
+        const size_t fieldSize = csvFieldSize(fields[i].bytes, fields[i].size, delimiter);
+        out = writeCsvField(out, fields[i].bytes, fields[i].size, fieldSize);
+    }
+    *out++ = '\r';
+    *out++ = '\n';
+
+    assert((size_t) (out - self) == length + recordSize);
+    Text_setLength(self, length + recordSize);
+    return self;
+}
+
+/*
+ * Separators (delimiters and line breaks outside quotes) are indexed one chunk of 64 bytes at a time, chunks are
+ * indexed in order because whether a chunk starts inside quotes depends on the previous one.
+ */
+struct TextCsvReader {
+    const char *text;
+    size_t length;
+    size_t fieldStart;
+    size_t chunkBase;
+    uint64_t separators;
+    uint64_t insideQuotes;  // all ones if the indexed chunk ends inside quotes
+    bool fieldPending;      // a delimiter has been consumed, a field follows even if empty
+    char delimiter;
+    Text buffer;
+};
+
+/*
+ * Computes the xor of each bit with all the lower ones, turning the quote positions into the quoted regions.
+ */
+static uint64_t prefixXor(uint64_t mask) {
+    mask ^= mask << 1;
+    mask ^= mask << 2;
+    mask ^= mask << 4;
+    mask ^= mask << 8;
+    mask ^= mask << 16;
+    mask ^= mask << 32;
+    return mask;
+}
+
+static void indexChunk(TextCsvReader *const self) {
+    const char *bytes = self->text + self->chunkBase;
+    const size_t available = self->length - self->chunkBase;
+    char padded[CHUNK_SIZE];
+    if (available < CHUNK_SIZE) {
+        memcpy(padded, bytes, available);
+        memset(padded + available, 0, CHUNK_SIZE - available);
+        bytes = padded;
+    }
+    const uint64_t quoted = prefixXor(TextSimd_matchMask64(bytes, '"')) ^ self->insideQuotes;
+    uint64_t separators = TextSimd_matchMask64(bytes, self->delimiter) |
+                          TextSimd_matchMask64(bytes, '\n') | TextSimd_matchMask64(bytes, '\r');
+    if (available < CHUNK_SIZE) {
+        separators &= (UINT64_C(1) << available) - 1;
+    }
+    self->insideQuotes = (uint64_t) 0 - (quoted >> 63);
+    self->separators = separators & ~quoted;
+}
+
+/*
+ * Finds the first separator at or after offset, returns the length of the text if there is none.
+ */
+static size_t findSeparator(TextCsvReader *const self, const size_t offset) {
+    if (offset >= self->length) {
+        return self->length;
+    }
+    while (offset >= self->chunkBase + CHUNK_SIZE) {
+        self->chunkBase += CHUNK_SIZE;
+        indexChunk(self);
+    }
+    uint64_t separators = self->separators & (~UINT64_C(0) << (offset - self->chunkBase));
+    while (0 == separators) {
+        self->chunkBase += CHUNK_SIZE;
+        if (self->chunkBase >= self->length) {
+            self->chunkBase -= CHUNK_SIZE;
+            return self->length;
+        }
+        indexChunk(self);
+        separators = self->separators;
+    }
+    return self->chunkBase + (size_t) __builtin_ctzll(separators);
+}
+
+TextCsvReader *TextCsvReader_new(const TextView text, const char delimiter) {
+    assert(text);
+    assert(isValidDelimiter(delimiter));
+    TextCsvReader *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    self->text = text;
+    self->length = Text_length(text);
+    self->fieldStart = 0;
+    self->chunkBase = 0;
+    self->separators = 0;
+    self->insideQuotes = 0;
+    self->fieldPending = false;
+    self->delimiter = delimiter;
+    self->buffer = Text_new();
+    if (self->length > 0) {
+        indexChunk(self);
+    }
+    return self;
+}
+
+bool TextCsvReader_next(TextCsvReader *const self, TextSlice *const field, bool *const endOfRecord) {
+    assert(self);
+    assert(field);
+    assert(endOfRecord);
+    const size_t start = self->fieldStart;
+    if (start >= self->length && !self->fieldPending) {
+        return false;
+    }
+
+    const size_t separator = findSeparator(self, start);
+    self->fieldPending = false;
+    if (separator >= self->length) {
+        *endOfRecord = true;
+        self->fieldStart = self->length;
+    } else if (self->delimiter == self->text[separator]) {
+        *endOfRecord = false;
+        self->fieldStart = separator + 1;
+        self->fieldPending = true;
+    } else {
+        const bool crlf = '\r' == self->text[separator] && separator + 1 < self->length &&
+                          '\n' == self->text[separator + 1];
+        *endOfRecord = true;
+        self->fieldStart = separator + 1 + crlf;
+    }
+
+    const char *bytes = self->text + start;
+    size_t size = separator - start;
+    if (size > 0 && '"' == bytes[0]) {
+        bytes += 1;
+        size -= 1;
+        if (size > 0 && '"' == bytes[size - 1]) {
+            size -= 1;
+        }
+        const char *quote = memchr(bytes, '"', size);
+        if (NULL != quote) {
+            // unescape doubled quotes, the content is copied only in this case
+            const char *const end = bytes + size;
+            Text_clear(self->buffer);
+            self->buffer = Text_expandToFit(&self->buffer, size);
+            char *out = self->buffer;
+            do {
+                memcpy(out, bytes, (size_t) (quote + 1 - bytes));
+                out += quote + 1 - bytes;
+                bytes = quote + 1 < end && '"' == quote[1] ? quote + 2 : quote + 1;
+            } while (NULL != (quote = memchr(bytes, '"', (size_t) (end - bytes))));
+            memcpy(out, bytes, (size_t) (end - bytes));
+            out += end - bytes;
+            Text_setLength(self->buffer, (size_t) (out - self->buffer));
+            bytes = self->buffer;
+            size = Text_length(self->buffer);
+        }
+    }
+    field->bytes = bytes;
+    field->size = size;
+    return true;
+}
+
+void TextCsvReader_delete(TextCsvReader *const self) {
+    if (self) {
+        Text_delete(self->buffer);
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,136 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Comma separated values (RFC 4180) for texts.
+ * The delimiter is configurable, fields are enclosed in double quotes when needed and embedded quotes are doubled.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+
+/**
+ * Reads the fields of a CSV content one at a time without copying them.
+ * The positions of delimiters and line breaks outside quotes are computed 64 bytes at once: quotes are matched into a
+ * bitmask whose prefix-xor gives the quoted regions, doubled quotes cancel out by construction.
+ */
+typedef struct TextCsvReader TextCsvReader;
+
+/**
+ * Appends a field, enclosing it in double quotes only if it contains the delimiter, a double quote or a line break.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention bytes must not be NULL.
+ * @attention delimiter must not be a double quote or a line break.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param bytes The content of the field.
+ * @param size The size of the content.
+ * @param delimiter The field delimiter, usually ','.
+ * @return the modified text instance
+ */
+extern Text Text_appendCsvField(Text *ref, const void *bytes, size_t size, char delimiter)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Appends a record: the fields separated by the delimiter and terminated by CRLF.
+ * The text is expanded only once to fit the whole record.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention fields must not be NULL.
+ * @attention delimiter must not be a double quote or a line break.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param fields The fields of the record.
+ * @param count The number of fields.
+ * @param delimiter The field delimiter, usually ','.
+ * @return the modified text instance
+ */
+extern Text Text_appendCsvRecord(Text *ref, const TextSlice *fields, size_t count, char delimiter)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates a reader over the CSV content of text.
+ *
+ * @attention text must not be NULL.
+ * @attention delimiter must not be a double quote or a line break.
+ *
+ * @param text The text instance, it must outlive the reader and must not be modified meanwhile.
+ * @param delimiter The field delimiter, usually ','.
+ * @return a new reader instance.
+ */
+extern TextCsvReader *TextCsvReader_new(TextView text, char delimiter)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Reads the next field. Records are terminated by LF, CRLF or CR, a line break at the end of the content doesn't
+ * start a new record.
+ * Quoted fields are yielded without the enclosing quotes: if they contain doubled quotes they are unescaped into a
+ * buffer owned by the reader, otherwise the slice points into the text.
+ * Malformed fields are yielded leniently: an unterminated quote extends to the end of the content and the content
+ * of a quoted field includes what follows its closing quote.
+ *
+ * @attention self must not be NULL.
+ * @attention field must not be NULL.
+ * @attention endOfRecord must not be NULL.
+ *
+ * @param self The reader instance.
+ * @param field The slice to be filled with the field, valid until the next call on the reader.
+ * @param endOfRecord Set to true if the field is the last one of its record.
+ * @return true if a field was read, false at the end of the content.
+ */
+extern bool TextCsvReader_next(TextCsvReader *self, TextSlice *field, bool *endOfRecord)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a reader.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextCsvReader_delete(TextCsvReader *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Private layout of the block preceding the content of every text.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <panic/panic.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum Text_Storage {
+    Text_Storage_Heap,      // allocated with Alligator, owned by the text
+    Text_Storage_Mapped,    // read-only file mapping, see Text_mapFile
+    Text_Storage_Inline,    // caller provided buffer, see Text_withBuffer
+};
+
+struct Text_Header {
+    size_t capacity;
+    size_t length;
+    char *content;
+    enum Text_Storage storage;
+};
+
+/*
+ * Gets the header of a text.
+ */
+static inline struct Text_Header *Text_Header_get(const char *const text) {
+    return (struct Text_Header *) text - 1;
+}
+
+/*
+ * Gets the header of a text about to be written, terminates the program if the text is read-only.
+ */
+static inline struct Text_Header *Text_Header_getMutable(char *const text) {
+    struct Text_Header *header = Text_Header_get(text);
+    if (Text_Storage_Mapped == header->storage) {
+        Panic_terminate("Read-only text");
+    }
+    return header;
+}
+
+/*
+ * Releases the mapping backing a text created by Text_mapFile.
+ */
+extern void Text_Header_unmap(struct Text_Header *header)
+__attribute__((__nonnull__));
+
+#ifdef __cplusplus
+}
+#endif
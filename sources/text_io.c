@@ -0,0 +1,367 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <string.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_io.h"
+#include "text_simd.h"
+#include "text_config.h"
+#include "text_header.h"
+
+#if TEXT_LINE_READER_BLOCK_SIZE < 1UL
+    #error
+#endif
+
+#if defined(IOV_MAX)
+#define WRITE_BATCH     IOV_MAX
+#else
+#define WRITE_BATCH     16
+#endif
+
+static size_t pageSize(void) {
+    const long size = sysconf(_SC_PAGESIZE);
+    return size > 0 ? (size_t) size : 4096;
+}
+
+static size_t roundUp(const size_t size, const size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/*
+ * Returns the number of bytes between the current offset and the end of a regular file, or 0 if unknown.
+ */
+static size_t remainingBytes(const int fd) {
+    struct stat status;
+    if (fstat(fd, &status) < 0 || !S_ISREG(status.st_mode)) {
+        return 0;
+    }
+    const off_t offset = lseek(fd, 0, SEEK_CUR);
+    if (offset < 0 || offset >= status.st_size || (uintmax_t) (status.st_size - offset) >= SIZE_MAX / 2) {
+        return 0;
+    }
+    return (size_t) (status.st_size - offset);
+}
+
+Text Text_appendFromFd(Text *ref, const int fd, const size_t maxBytes, int *const error) {
+    assert(ref);
+    assert(*ref);
+    assert(error);
+    Text self = *ref;
+    size_t length = Text_length(self), remaining = remainingBytes(fd), appended = 0;
+
+    if (remaining > 0) {
+        if (remaining > maxBytes) {
+            remaining = maxBytes;
+        }
+        self = Text_expandToFit(ref, length + remaining);
+#if defined(POSIX_FADV_SEQUENTIAL)
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    }
+
+    *error = 0;
+    while (appended < maxBytes) {
+        size_t spare = Text_capacity(self) - length;
+        if (0 == spare) {
+            if (remaining > 0 && appended >= remaining) {
+                break;  // the whole file has been read, avoid growing just to hit end of file
+            }
+            self = Text_expandToFit(&self, length + 1);
+            spare = Text_capacity(self) - length;
+        }
+        if (spare > maxBytes - appended) {
+            spare = maxBytes - appended;
+        }
+        if (spare > SSIZE_MAX) {
+            spare = SSIZE_MAX;
+        }
+        const ssize_t result = read(fd, self + length, spare);
+        if (result < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            *error = errno;
+            break;
+        }
+        if (0 == result) {
+            break;
+        }
+        length += (size_t) result;
+        appended += (size_t) result;
+    }
+
+    Text_setLength(self, length);
+    *ref = NULL;
+    return self;
+}
+
+Text Text_readFile(const char *const path) {
+    assert(path);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    int error;
+    Text self = Text_withCapacity(remainingBytes(fd));
+    self = Text_appendFromFd(&self, fd, SIZE_MAX, &error);
+    close(fd);
+    if (error) {
+        Text_delete(self);
+        errno = error;
+        return NULL;
+    }
+    return self;
+}
+
+/*
+ * Writes all the vectors resuming after partial writes, vectors are modified in the process.
+ */
+static bool writeVectors(const int fd, struct iovec *vectors, size_t count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, vectors, (int) count);
+        if (written < 0) {
+            if (EINTR == errno) {
+                continue;
+            }
+            return false;
+        }
+        while (count > 0 && (size_t) written >= vectors->iov_len) {
+            written -= (ssize_t) vectors->iov_len;
+            vectors++;
+            count--;
+        }
+        if (count > 0) {
+            vectors->iov_base = (char *) vectors->iov_base + written;
+            vectors->iov_len -= (size_t) written;
+        }
+    }
+    return true;
+}
+
+bool Text_writeAll(const int fd, const Text *const texts, const size_t count) {
+    assert(texts);
+    struct iovec vectors[WRITE_BATCH];
+    for (size_t i = 0; i < count;) {
+        size_t batch = 0;
+        for (; batch < WRITE_BATCH && i < count; batch++, i++) {
+            assert(texts[i]);
+            vectors[batch].iov_base = (void *) texts[i];
+            vectors[batch].iov_len = Text_length(texts[i]);
+        }
+        if (!writeVectors(fd, vectors, batch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Text_writeSlices(const int fd, const TextSlice *const slices, const size_t count) {
+    assert(slices);
+    struct iovec vectors[WRITE_BATCH];
+    for (size_t i = 0; i < count;) {
+        size_t batch = 0;
+        for (; batch < WRITE_BATCH && i < count; batch++, i++) {
+            vectors[batch].iov_base = (void *) slices[i].bytes;
+            vectors[batch].iov_len = slices[i].size;
+        }
+        if (!writeVectors(fd, vectors, batch)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+struct TextLineReader {
+    Text buffer;
+    size_t start;       // offset of the first byte not yet yielded
+    size_t scanned;     // offset of the first byte not yet searched for a newline
+    size_t blockSize;
+    int fd;
+    int error;
+    bool eof;
+};
+
+TextLineReader *TextLineReader_new(const int fd) {
+    return TextLineReader_withBlockSize(fd, TEXT_LINE_READER_BLOCK_SIZE);
+}
+
+TextLineReader *TextLineReader_withBlockSize(const int fd, const size_t blockSize) {
+    assert(blockSize > 0);
+    assert(blockSize < SIZE_MAX);
+    TextLineReader *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    self->buffer = Text_withCapacity(blockSize);
+    self->start = 0;
+    self->scanned = 0;
+    self->blockSize = blockSize;
+    self->fd = fd;
+    self->error = 0;
+    self->eof = false;
+    return self;
+}
+
+static void refill(TextLineReader *const self) {
+    size_t length = Text_length(self->buffer);
+    if (self->start > 0) {
+        length -= self->start;
+        memmove(self->buffer, self->buffer + self->start, length);
+        self->scanned -= self->start;
+        self->start = 0;
+    }
+    if (Text_capacity(self->buffer) - length < self->blockSize / 2 + 1) {
+        self->buffer = Text_expandToFit(&self->buffer, length + self->blockSize);
+    }
+
+    ssize_t result;
+    do {
+        size_t spare = Text_capacity(self->buffer) - length;
+        result = read(self->fd, self->buffer + length, spare > SSIZE_MAX ? SSIZE_MAX : spare);
+    } while (result < 0 && EINTR == errno);
+
+    if (result <= 0) {
+        self->error = result < 0 ? errno : 0;
+        self->eof = true;
+    } else {
+        length += (size_t) result;
+    }
+    Text_setLength(self->buffer, length);
+}
+
+bool TextLineReader_next(TextLineReader *const self, TextSlice *const line) {
+    assert(self);
+    assert(line);
+    for (;;) {
+        const char *const end = self->buffer + Text_length(self->buffer);
+        const char *newline = TextSimd_findByte(self->buffer + self->scanned, end, '\n');
+        if (newline) {
+            line->bytes = self->buffer + self->start;
+            line->size = (size_t) (newline - line->bytes);
+            self->start = self->scanned = (size_t) (newline - self->buffer) + 1;
+            return true;
+        }
+        self->scanned = Text_length(self->buffer);
+        if (self->eof) {
+            if (self->start < self->scanned) {
+                line->bytes = self->buffer + self->start;
+                line->size = self->scanned - self->start;
+                self->start = self->scanned;
+                return true;
+            }
+            return false;
+        }
+        refill(self);
+    }
+}
+
+int TextLineReader_error(const TextLineReader *const self) {
+    assert(self);
+    return self->error;
+}
+
+void TextLineReader_delete(TextLineReader *const self) {
+    if (self) {
+        Text_delete(self->buffer);
+        Alligator_free(self);
+    }
+}
+
+/*
+ * A mapped text is laid out as: [guard page holding the header][file pages][zeroed page]
+ * so that the header lies right before the content and the content is always followed by a NUL byte.
+ */
+TextView Text_mapFile(const char *const path) {
+    assert(path);
+    const int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    struct stat status;
+    if (fstat(fd, &status) < 0) {
+        const int error = errno;
+        close(fd);
+        errno = error;
+        return NULL;
+    }
+    if (!S_ISREG(status.st_mode) || (uintmax_t) status.st_size >= SIZE_MAX / 2) {
+        close(fd);
+        errno = S_ISREG(status.st_mode) ? EFBIG : EINVAL;
+        return NULL;
+    }
+
+    const size_t size = (size_t) status.st_size, page = pageSize();
+    const size_t total = page + roundUp(size, page) + page;
+    char *base = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == base) {
+        const int error = errno;
+        close(fd);
+        errno = error;
+        return NULL;
+    }
+    if (size > 0 && MAP_FAILED == mmap(base + page, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0)) {
+        const int error = errno;
+        munmap(base, total);
+        close(fd);
+        errno = error;
+        return NULL;
+    }
+    close(fd);
+
+    struct Text_Header *header = (struct Text_Header *) (base + page) - 1;
+    header->content = base + page;
+    header->capacity = header->length = size;
+    header->storage = Text_Storage_Mapped;
+    mprotect(base, page, PROT_READ);
+    mprotect(base + total - page, page, PROT_READ);
+    return header->content;
+}
+
+void Text_unmapFile(const TextView self) {
+    if (self) {
+        struct Text_Header *header = (struct Text_Header *) self - 1;
+        if (Text_Storage_Mapped != header->storage) {
+            Panic_terminate("Not a mapped text");
+        }
+        Text_Header_unmap(header);
+    }
+}
+
+void Text_Header_unmap(struct Text_Header *const header) {
+    assert(header);
+    assert(Text_Storage_Mapped == header->storage);
+    const size_t page = pageSize();
+    munmap(header->content - page, page + roundUp(header->length, page) + page);
+}
@@ -0,0 +1,194 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Input/output facilities for texts.
+ *
+ * @attention Unless otherwise stated, every function in this module terminates the program in case of out of memory
+ * while I/O errors are reported through the return value and errno.
+ */
+
+/**
+ * Appends to the text the bytes read from the file descriptor until end of file or until maxBytes bytes are read.
+ * Bytes are read straight into the spare capacity of the text, for regular files the capacity is expanded
+ * only once to fit the remaining size of the file and a sequential readahead hint is given to the kernel.
+ * Interrupted reads are retried, on failure the bytes read so far are kept.
+ *
+ * @attention ref and *ref must not be NULL.
+ * @attention error must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The text instance reference.
+ * @param fd The file descriptor to read from.
+ * @param maxBytes The maximum number of bytes to read, SIZE_MAX reads until end of file.
+ * @param error Set to 0 on success, or to the errno value of the failed read.
+ * @return the modified text instance
+ */
+extern Text Text_appendFromFd(Text *ref, int fd, size_t maxBytes, int *error)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Reads the whole file into a new text using exactly one allocation for regular files.
+ *
+ * @attention path must not be NULL.
+ *
+ * @param path The path of the file.
+ * @return a new text instance, or NULL with errno set on failure.
+ */
+extern Text Text_readFile(const char *path)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Writes the content of the texts, in order, to the file descriptor without concatenating them.
+ * Texts are gathered with writev in batches of at most IOV_MAX entries, partial and interrupted writes are resumed.
+ *
+ * @attention texts must not be NULL and must hold count non NULL texts.
+ *
+ * @param fd The file descriptor to write to.
+ * @param texts The array of texts.
+ * @param count The number of texts.
+ * @return true on success, false with errno set on failure.
+ */
+extern bool Text_writeAll(int fd, const Text *texts, size_t count)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Writes the slices, in order, to the file descriptor without concatenating them.
+ * Behaves like Text_writeAll but takes slices.
+ *
+ * @attention slices must not be NULL and must hold count slices.
+ *
+ * @param fd The file descriptor to write to.
+ * @param slices The array of slices.
+ * @param count The number of slices.
+ * @return true on success, false with errno set on failure.
+ */
+extern bool Text_writeSlices(int fd, const TextSlice *slices, size_t count)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Reads newline delimited records from a file descriptor yielding lines as slices into an internal buffer.
+ * The buffer is refilled reading large blocks, the pending partial line is compacted to the front with a single
+ * memmove per refill and the buffer grows to accommodate lines longer than it.
+ */
+typedef struct TextLineReader TextLineReader;
+
+/**
+ * Creates a line reader using the default block size.
+ * The reader does not take ownership of the file descriptor.
+ *
+ * @param fd The file descriptor to read from.
+ * @return a new line reader instance.
+ */
+extern TextLineReader *TextLineReader_new(int fd)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Creates a line reader requesting at least blockSize bytes per refill.
+ * The reader does not take ownership of the file descriptor.
+ *
+ * @attention blockSize must be greater than 0 and less than SIZE_MAX.
+ *
+ * @param fd The file descriptor to read from.
+ * @param blockSize The size of a refill.
+ * @return a new line reader instance.
+ */
+extern TextLineReader *TextLineReader_withBlockSize(int fd, size_t blockSize)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Reads the next line, the trailing newline is not part of it.
+ * The last line is yielded even if it is not terminated by a newline.
+ * The slice is valid until the next call on the reader.
+ *
+ * @attention self must not be NULL.
+ * @attention line must not be NULL.
+ *
+ * @param self The line reader instance.
+ * @param line The slice to be filled with the next line.
+ * @return true if a line was read, false on end of file or failure (see TextLineReader_error).
+ */
+extern bool TextLineReader_next(TextLineReader *self, TextSlice *line)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the errno value of the read that stopped the reader, 0 if none failed.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The line reader instance.
+ * @return the error.
+ */
+extern int TextLineReader_error(const TextLineReader *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a line reader.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextLineReader_delete(TextLineReader *self);
+
+/**
+ * Maps the file in memory creating a read-only text without copying its content.
+ * The returned view is NUL terminated and can be used with every function taking a TextView.
+ * Every attempt to modify the mapped text terminates execution.
+ *
+ * @attention path must not be NULL.
+ * @attention the file must not be truncated while mapped.
+ *
+ * @param path The path of a regular file.
+ * @return the mapped text, or NULL with errno set on failure.
+ */
+extern TextView Text_mapFile(const char *path)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Releases a text created by Text_mapFile.
+ * If NULL nothing will be done.
+ *
+ * @param self The mapped text.
+ */
+extern void Text_unmapFile(TextView self);
+
+#ifdef __cplusplus
+}
+#endif
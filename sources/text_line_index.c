@@ -0,0 +1,233 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_line_index.h"
+#include "text_config.h"
+#include "text_simd.h"
+
+#if TEXT_LINE_INDEX_BLOCK_LINES < 2UL
+    #error
+#endif
+
+#define WIDE_DELTA  UINT32_MAX
+
+struct WideOffset {
+    size_t line;
+    size_t offset;
+};
+
+/*
+ * Line starts are grouped in blocks of TEXT_LINE_INDEX_BLOCK_LINES lines: the first line of each block stores its
+ * absolute offset in bases, the following ones store their distance from it in deltas.
+ * Distances not fitting 32 bits (lines longer than 4GiB) are marked with WIDE_DELTA and stored in wideOffsets.
+ */
+struct TextLineIndex {
+    size_t count;
+    size_t scanned;
+    size_t blocksCapacity;
+    size_t *bases;
+    uint32_t *deltas;
+    size_t wideSize;
+    size_t wideCapacity;
+    struct WideOffset *wideOffsets;
+};
+
+static void reserveBlock(TextLineIndex *const self, const size_t block) {
+    if (block >= self->blocksCapacity) {
+        const size_t capacity = self->blocksCapacity * 2;
+        self->bases = Option_unwrap(Alligator_realloc(self->bases, sizeof(self->bases[0]) * capacity));
+        self->deltas = Option_unwrap(Alligator_realloc(
+                self->deltas, sizeof(self->deltas[0]) * capacity * (TEXT_LINE_INDEX_BLOCK_LINES - 1)
+        ));
+        self->blocksCapacity = capacity;
+    }
+}
+
+static void pushWideOffset(TextLineIndex *const self, const size_t line, const size_t offset) {
+    if (self->wideSize >= self->wideCapacity) {
+        self->wideCapacity = self->wideCapacity ? self->wideCapacity * 2 : 8;
+        self->wideOffsets = Option_unwrap(Alligator_realloc(
+                self->wideOffsets, sizeof(self->wideOffsets[0]) * self->wideCapacity
+        ));
+    }
+    self->wideOffsets[self->wideSize].line = line;
+    self->wideOffsets[self->wideSize].offset = offset;
+    self->wideSize += 1;
+}
+
+static void pushLineStart(TextLineIndex *const self, const size_t offset) {
+    const size_t line = self->count;
+    const size_t block = line / TEXT_LINE_INDEX_BLOCK_LINES, slot = line % TEXT_LINE_INDEX_BLOCK_LINES;
+    if (0 == slot) {
+        reserveBlock(self, block);
+        self->bases[block] = offset;
+    } else {
+        const size_t delta = offset - self->bases[block];
+        uint32_t *entry = self->deltas + block * (TEXT_LINE_INDEX_BLOCK_LINES - 1) + (slot - 1);
+        if (delta < WIDE_DELTA) {
+            *entry = (uint32_t) delta;
+        } else {
+            *entry = WIDE_DELTA;
+            pushWideOffset(self, line, offset);
+        }
+    }
+    self->count += 1;
+}
+
+static size_t findWideOffset(const TextLineIndex *const self, const size_t line) {
+    size_t low = 0, high = self->wideSize;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (self->wideOffsets[middle].line < line) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    assert(low < self->wideSize && self->wideOffsets[low].line == line);
+    return self->wideOffsets[low].offset;
+}
+
+static size_t offsetOf(const TextLineIndex *const self, const size_t line) {
+    const size_t block = line / TEXT_LINE_INDEX_BLOCK_LINES, slot = line % TEXT_LINE_INDEX_BLOCK_LINES;
+    if (0 == slot) {
+        return self->bases[block];
+    }
+    const uint32_t delta = self->deltas[block * (TEXT_LINE_INDEX_BLOCK_LINES - 1) + (slot - 1)];
+    return WIDE_DELTA == delta ? findWideOffset(self, line) : self->bases[block] + delta;
+}
+
+TextLineIndex *TextLineIndex_new(const TextView text) {
+    assert(text);
+    TextLineIndex *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    self->count = 0;
+    self->scanned = 0;
+    self->blocksCapacity = 4;
+    self->bases = Option_unwrap(Alligator_malloc(sizeof(self->bases[0]) * self->blocksCapacity));
+    self->deltas = Option_unwrap(Alligator_malloc(
+            sizeof(self->deltas[0]) * self->blocksCapacity * (TEXT_LINE_INDEX_BLOCK_LINES - 1)
+    ));
+    self->wideSize = 0;
+    self->wideCapacity = 0;
+    self->wideOffsets = NULL;
+    pushLineStart(self, 0);
+    TextLineIndex_extend(self, text);
+    return self;
+}
+
+void TextLineIndex_extend(TextLineIndex *const self, const TextView text) {
+    assert(self);
+    assert(text);
+    const size_t length = Text_length(text);
+    assert(length >= self->scanned);
+    const char *cursor = text + self->scanned, *const end = text + length;
+
+    while (end - cursor >= 64) {
+        uint64_t mask = TextSimd_matchMask64(cursor, '\n');
+        while (mask) {
+            pushLineStart(self, (size_t) (cursor - text) + (size_t) __builtin_ctzll(mask) + 1);
+            mask &= mask - 1;
+        }
+        cursor += 64;
+    }
+    while ((cursor = TextSimd_findByte(cursor, end, '\n'))) {
+        cursor += 1;
+        pushLineStart(self, (size_t) (cursor - text));
+    }
+
+    self->scanned = length;
+}
+
+size_t TextLineIndex_count(const TextLineIndex *const self) {
+    assert(self);
+    return self->count;
+}
+
+size_t TextLineIndex_offsetOf(const TextLineIndex *const self, const size_t line) {
+    assert(self);
+    if (line >= self->count) {
+        Panic_terminate("Out of range");
+    }
+    return offsetOf(self, line);
+}
+
+size_t TextLineIndex_lineAt(const TextLineIndex *const self, const size_t offset) {
+    assert(self);
+    if (offset > self->scanned) {
+        Panic_terminate("Out of range");
+    }
+    // find the first block starting after offset, then the last line in the previous block starting at or before it
+    size_t low = 0, high = (self->count + TEXT_LINE_INDEX_BLOCK_LINES - 1) / TEXT_LINE_INDEX_BLOCK_LINES;
+    while (low < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (self->bases[middle] <= offset) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    assert(low > 0);
+    low = (low - 1) * TEXT_LINE_INDEX_BLOCK_LINES;
+    high = low + TEXT_LINE_INDEX_BLOCK_LINES < self->count ? low + TEXT_LINE_INDEX_BLOCK_LINES : self->count;
+    while (low + 1 < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (offsetOf(self, middle) <= offset) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return low;
+}
+
+TextSlice TextLineIndex_line(const TextLineIndex *const self, const TextView text, const size_t line) {
+    assert(self);
+    assert(text);
+    assert(Text_length(text) >= self->scanned);
+    if (line >= self->count) {
+        Panic_terminate("Out of range");
+    }
+    TextSlice slice;
+    const size_t start = offsetOf(self, line);
+    const size_t end = line + 1 < self->count ? offsetOf(self, line + 1) - 1 : self->scanned;
+    slice.bytes = text + start;
+    slice.size = end - start;
+    return slice;
+}
+
+void TextLineIndex_delete(TextLineIndex *const self) {
+    if (self) {
+        Alligator_free(self->bases);
+        Alligator_free(self->deltas);
+        Alligator_free(self->wideOffsets);
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maps line numbers to byte offsets of a text allowing random access to its lines.
+ * Lines are separated by '\n', a text having n newlines has n + 1 lines (the last one may be empty).
+ * Offsets are stored delta-encoded in fixed size blocks so that lookups by line number take constant time.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+typedef struct TextLineIndex TextLineIndex;
+
+/**
+ * Creates the line index of the text.
+ *
+ * @attention text must not be NULL.
+ *
+ * @param text The text instance.
+ * @return a new line index instance.
+ */
+extern TextLineIndex *TextLineIndex_new(TextView text)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Extends the index scanning only the bytes appended to the text since the last indexing.
+ * The text may have been reallocated (e.g. by Text_appendBytes) but its already indexed content must be unchanged.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention the length of text must be greater or equal than the already indexed length.
+ *
+ * @param self The line index instance.
+ * @param text The text instance.
+ */
+extern void TextLineIndex_extend(TextLineIndex *self, TextView text)
+__attribute__((__nonnull__));
+
+/**
+ * Gets the number of lines.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The line index instance.
+ * @return the number of lines (always greater than 0).
+ */
+extern size_t TextLineIndex_count(const TextLineIndex *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the byte offset where the line starts.
+ *
+ * @attention self must not be NULL.
+ * @attention terminates execution if line is greater or equals the number of lines.
+ *
+ * @param self The line index instance.
+ * @param line The zero based line number.
+ * @return the offset of the first byte of the line.
+ */
+extern size_t TextLineIndex_offsetOf(const TextLineIndex *self, size_t line)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the number of the line containing the byte at offset, takes logarithmic time.
+ *
+ * @attention self must not be NULL.
+ * @attention terminates execution if offset is greater than the indexed length.
+ *
+ * @param self The line index instance.
+ * @param offset The byte offset.
+ * @return the zero based line number.
+ */
+extern size_t TextLineIndex_lineAt(const TextLineIndex *self, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the content of the line, excluding the trailing newline.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL and must be the indexed text.
+ * @attention terminates execution if line is greater or equals the number of lines.
+ *
+ * @param self The line index instance.
+ * @param text The indexed text instance.
+ * @param line The zero based line number.
+ * @return a slice into the content of text.
+ */
+extern TextSlice TextLineIndex_line(const TextLineIndex *self, TextView text, size_t line)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a line index.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextLineIndex_delete(TextLineIndex *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,303 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_matcher.h"
+#include "text_simd.h"
+
+#define MATCH_FLAG  UINT32_C(0x80000000)    // set on transitions leading to states that report occurrences
+#define STATE_MASK  UINT32_C(0x7FFFFFFF)
+#define NO_PATTERN  UINT32_MAX
+
+struct TextMatcher {
+    uint32_t *delta;        // rows of (1 << shift) transitions, one per state, the root being state 0
+    uint32_t *outputs;      // the pattern spelled by each state or NO_PATTERN
+    uint32_t *links;        // the longest proper suffix state spelling a pattern or 0
+    uint32_t *depths;       // the size of the prefix spelled by each state
+    size_t *sizes;          // the size of each pattern
+    struct Text_ByteSet starts;
+    bool prefilter;
+    bool ignoreCase;
+    unsigned shift;
+    unsigned char classes[256];
+};
+
+static unsigned char fold(const unsigned char c, const bool ignoreCase) {
+    return (ignoreCase && c >= 'A' && c <= 'Z') ? (unsigned char) (c + ('a' - 'A')) : c;
+}
+
+static void compileClasses(TextMatcher *const self, const TextView *const patterns, const size_t count) {
+    bool used[256] = {false};
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char *bytes = (const unsigned char *) patterns[i];
+        for (size_t j = 0, size = self->sizes[i]; j < size; j++) {
+            used[fold(bytes[j], self->ignoreCase)] = true;
+        }
+    }
+
+    unsigned classes = 0, unused = 256;
+    for (unsigned c = 0; c < 256; c++) {
+        if (!used[c] && !(self->ignoreCase && c >= 'A' && c <= 'Z')) {
+            unused = classes++;
+            break;
+        }
+    }
+    for (unsigned c = 0; c < 256; c++) {
+        self->classes[c] = (unsigned char) (used[c] ? classes++ : unused);
+    }
+    if (self->ignoreCase) {
+        for (unsigned c = 'A'; c <= 'Z'; c++) {
+            self->classes[c] = self->classes[c + ('a' - 'A')];
+        }
+    }
+
+    self->shift = 0;
+    while ((1U << self->shift) < classes) {
+        self->shift++;
+    }
+}
+
+static void compileStarts(TextMatcher *const self, const TextView *const patterns, const size_t count) {
+    bool seen[256] = {false};
+    unsigned char starts[256];
+    size_t size = 0;
+    for (size_t i = 0; i < count; i++) {
+        seen[fold((unsigned char) patterns[i][0], self->ignoreCase)] = true;
+    }
+    for (unsigned c = 0; c < 256; c++) {
+        if (seen[fold((unsigned char) c, self->ignoreCase)]) {
+            starts[size++] = (unsigned char) c;
+        }
+    }
+    TextSimd_byteSetInit(&self->starts, starts, size);
+    // skipping to candidate starts pays off only if vectorized, otherwise the automaton is just as fast
+    self->prefilter = self->starts.size <= TEXT_BYTE_SET_SMALL;
+}
+
+static uint32_t longestOutput(const TextMatcher *const self, const uint32_t state) {
+    return NO_PATTERN != self->outputs[state] ? state : self->links[state];
+}
+
+TextMatcher *TextMatcher_new(const TextView *const patterns, const size_t count, const bool ignoreCase) {
+    assert(patterns);
+    assert(count < NO_PATTERN);
+    TextMatcher *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    self->ignoreCase = ignoreCase;
+    self->sizes = Option_unwrap(Alligator_malloc((count > 0 ? count : 1) * sizeof(self->sizes[0])));
+
+    size_t capacity = 1;    // the trie has at most one state per pattern byte plus the root
+    for (size_t i = 0; i < count; i++) {
+        assert(patterns[i]);
+        self->sizes[i] = Text_length(patterns[i]);
+        assert(self->sizes[i] > 0);
+        capacity += self->sizes[i];
+        if (capacity > STATE_MASK) {
+            Panic_terminate("Out of range");
+        }
+    }
+    compileClasses(self, patterns, count);
+    compileStarts(self, patterns, count);
+    if (capacity > (SIZE_MAX / sizeof(uint32_t)) >> self->shift) {
+        Panic_terminate("Out of range");
+    }
+
+    // trie: a zero transition means missing since no pattern leads back to the root
+    const size_t stride = (size_t) 1 << self->shift;
+    self->delta = Option_unwrap(Alligator_calloc(capacity << self->shift, sizeof(self->delta[0])));
+    self->outputs = Option_unwrap(Alligator_malloc(capacity * sizeof(self->outputs[0])));
+    self->depths = Option_unwrap(Alligator_malloc(capacity * sizeof(self->depths[0])));
+    self->outputs[0] = NO_PATTERN;
+    self->depths[0] = 0;
+    uint32_t states = 1;
+    for (size_t i = 0; i < count; i++) {
+        const unsigned char *bytes = (const unsigned char *) patterns[i];
+        uint32_t state = 0;
+        for (size_t j = 0; j < self->sizes[i]; j++) {
+            uint32_t *transition = &self->delta[((size_t) state << self->shift) | self->classes[bytes[j]]];
+            if (0 == *transition) {
+                self->outputs[states] = NO_PATTERN;
+                self->depths[states] = (uint32_t) (j + 1);
+                *transition = states++;
+            }
+            state = *transition;
+        }
+        if (NO_PATTERN == self->outputs[state]) {
+            self->outputs[state] = (uint32_t) i;
+        }
+    }
+
+    // breadth first: missing transitions of each state are borrowed from its failure state, already complete
+    uint32_t *failures = Option_unwrap(Alligator_malloc(states * sizeof(failures[0])));
+    uint32_t *queue = Option_unwrap(Alligator_malloc(states * sizeof(queue[0])));
+    self->links = Option_unwrap(Alligator_malloc(states * sizeof(self->links[0])));
+    size_t head = 0, tail = 0;
+    self->links[0] = 0;
+    for (size_t c = 0; c < stride; c++) {
+        const uint32_t child = self->delta[c];
+        if (child) {
+            failures[child] = 0;
+            self->links[child] = 0;
+            queue[tail++] = child;
+        }
+    }
+    while (head < tail) {
+        const uint32_t state = queue[head++];
+        uint32_t *const row = &self->delta[(size_t) state << self->shift];
+        const uint32_t *const fallback = &self->delta[(size_t) failures[state] << self->shift];
+        for (size_t c = 0; c < stride; c++) {
+            const uint32_t child = row[c];
+            if (child) {
+                const uint32_t failure = fallback[c];
+                failures[child] = failure;
+                self->links[child] = NO_PATTERN != self->outputs[failure] ? failure : self->links[failure];
+                queue[tail++] = child;
+            } else {
+                row[c] = fallback[c];
+            }
+        }
+    }
+    Alligator_free(queue);
+    Alligator_free(failures);
+
+    for (size_t i = 0, size = (size_t) states << self->shift; i < size; i++) {
+        if (0 != longestOutput(self, self->delta[i])) {
+            self->delta[i] |= MATCH_FLAG;
+        }
+    }
+    if (states < capacity) {
+        const size_t size = ((size_t) states << self->shift) * sizeof(self->delta[0]);
+        self->delta = Option_unwrap(Alligator_realloc(self->delta, size));
+        self->outputs = Option_unwrap(Alligator_realloc(self->outputs, states * sizeof(self->outputs[0])));
+        self->depths = Option_unwrap(Alligator_realloc(self->depths, states * sizeof(self->depths[0])));
+    }
+    return self;
+}
+
+static uint32_t step(const TextMatcher *const self, const uint32_t state, const char c) {
+    return self->delta[((size_t) state << self->shift) | self->classes[(unsigned char) c]];
+}
+
+bool TextMatcher_find(const TextMatcher *const self, const TextView text, const size_t offset, TextMatch *const match) {
+    assert(self);
+    assert(text);
+    assert(match);
+    const size_t length = Text_length(text);
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+
+    const char *cursor = text + offset, *const end = text + length;
+    bool found = false;
+    uint32_t state = 0;
+    while (cursor < end) {
+        if (0 == state) {
+            if (found) {
+                break;
+            }
+            if (self->prefilter && NULL == (cursor = TextSimd_findFirstOf(cursor, end, &self->starts))) {
+                break;
+            }
+        }
+        const uint32_t transition = step(self, state, *cursor++);
+        state = transition & STATE_MASK;
+        if (transition & MATCH_FLAG) {
+            const uint32_t pattern = self->outputs[longestOutput(self, state)];
+            const size_t size = self->sizes[pattern], start = (size_t) (cursor - text) - size;
+            // at each position only the longest occurrence can start first, a later one starting as first is longer
+            if (!found || start < match->offset || (start == match->offset && size > match->size)) {
+                found = true;
+                match->pattern = pattern;
+                match->offset = start;
+                match->size = size;
+            }
+        }
+        if (found && (size_t) (cursor - text) - self->depths[state] > match->offset) {
+            break;  // no partial occurrence starting at or before the best one is alive
+        }
+    }
+    return found;
+}
+
+TextMatchIterator TextMatcher_matches(const TextMatcher *const self, const TextView text, const size_t offset) {
+    assert(self);
+    assert(text);
+    const size_t length = Text_length(text);
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+    return (TextMatchIterator) {
+            .matcher = self, .begin = text, .cursor = text + offset, .end = text + length, .state = 0, .output = 0
+    };
+}
+
+bool TextMatchIterator_next(TextMatchIterator *const self, TextMatch *const match) {
+    assert(self);
+    assert(match);
+    const TextMatcher *const matcher = self->matcher;
+    if (0 == self->output) {
+        const char *cursor = self->cursor, *const end = self->end;
+        uint32_t state = self->state, transition = 0;
+        while (cursor < end) {
+            if (0 == state && matcher->prefilter &&
+                NULL == (cursor = TextSimd_findFirstOf(cursor, end, &matcher->starts))) {
+                cursor = end;
+                break;
+            }
+            transition = step(matcher, state, *cursor++);
+            state = transition & STATE_MASK;
+            if (transition & MATCH_FLAG) {
+                break;
+            }
+        }
+        self->cursor = cursor;
+        self->state = state;
+        if (0 == (transition & MATCH_FLAG)) {
+            return false;
+        }
+        self->output = longestOutput(matcher, state);
+    }
+    match->pattern = matcher->outputs[self->output];
+    match->size = matcher->sizes[match->pattern];
+    match->offset = (size_t) (self->cursor - self->begin) - match->size;
+    self->output = matcher->links[self->output];
+    return true;
+}
+
+void TextMatcher_delete(TextMatcher *const self) {
+    if (self) {
+        Alligator_free(self->delta);
+        Alligator_free(self->outputs);
+        Alligator_free(self->links);
+        Alligator_free(self->depths);
+        Alligator_free(self->sizes);
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,152 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Multi-pattern search over texts (Aho-Corasick).
+ * The patterns are compiled once into a dense automaton that finds the occurrences of all of them in a single pass
+ * over the content, regardless of their number.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+
+/**
+ * A compiled set of patterns.
+ * Bytes are first mapped to equivalence classes, the bytes not occurring in any pattern sharing a single class, then
+ * each state of the automaton owns a row of transitions indexed by class. Failure links are resolved at compile time
+ * so that scanning takes exactly one table lookup per byte.
+ */
+typedef struct TextMatcher TextMatcher;
+
+/**
+ * An occurrence of a pattern.
+ */
+typedef struct TextMatch {
+    size_t pattern;     // the index of the pattern, duplicated patterns are reported by their first index
+    size_t offset;      // the byte offset of the occurrence
+    size_t size;        // the size of the occurrence
+} TextMatch;
+
+/**
+ * Iterates over all the occurrences of the patterns, overlapping ones included.
+ * This struct must be treated as opaque, its members must not be accessed directly.
+ */
+typedef struct TextMatchIterator {
+    const TextMatcher *matcher;
+    const char *begin;
+    const char *cursor;
+    const char *end;
+    uint32_t state;
+    uint32_t output;
+} TextMatchIterator;
+
+/**
+ * Compiles the patterns into a new matcher.
+ * The case insensitive mode folds ASCII letters only, other bytes are always compared exactly.
+ *
+ * @attention patterns must not be NULL.
+ * @attention each pattern must not be NULL nor empty.
+ *
+ * @param patterns The patterns to search, they are not referenced after this call.
+ * @param count The number of patterns.
+ * @param ignoreCase Whether ASCII letters must be compared ignoring their case.
+ * @return a new matcher instance.
+ */
+extern TextMatcher *TextMatcher_new(const TextView *patterns, size_t count, bool ignoreCase)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Finds the leftmost-longest occurrence at or after offset: among the occurrences starting first, the longest one.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention match must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The matcher instance.
+ * @param text The text instance to be scanned.
+ * @param offset The byte offset where scanning starts.
+ * @param match The occurrence, set only if found.
+ * @return true if an occurrence was found, false otherwise.
+ */
+extern bool TextMatcher_find(const TextMatcher *self, TextView text, size_t offset, TextMatch *match)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over all the occurrences at or after offset.
+ * Occurrences are yielded by ending position, the longest first when several patterns end at the same position.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The matcher instance, it must outlive the iterator.
+ * @param text The text instance to be scanned.
+ * @param offset The byte offset where scanning starts.
+ * @return a new iterator, the text must outlive it and must not be modified meanwhile.
+ */
+extern TextMatchIterator TextMatcher_matches(const TextMatcher *self, TextView text, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the next occurrence.
+ *
+ * @attention self must not be NULL.
+ * @attention match must not be NULL.
+ *
+ * @param self The iterator instance.
+ * @param match The occurrence, set only if found.
+ * @return true if an occurrence was found, false when the text is over.
+ */
+extern bool TextMatchIterator_next(TextMatchIterator *self, TextMatch *match)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a matcher.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextMatcher_delete(TextMatcher *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,414 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <ctype.h>
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_parallel.h"
+#include "text_config.h"
+#include "text_header.h"
+#include "text_simd.h"
+#include "text_utf8.h"
+
+#if TEXT_PARALLEL_CHUNK_SIZE < 4UL
+    #error
+#endif
+
+#define NOT_FOUND   SIZE_MAX
+
+typedef void (*ChunkTask)(void *context, size_t chunk);
+
+/*
+ * The chunks still to be run by a worker: the owner takes them from the front, thieves from the back.
+ * Both ends are packed in a single word so that either side claims a chunk with one compare and swap.
+ */
+struct Range {
+    uint64_t bounds;    // first chunk in the upper half, end chunk in the lower half
+    char padding[64 - sizeof(uint64_t)];    // one cache line per worker
+};
+
+struct Worker {
+    TextExecutor *executor;
+    unsigned index;
+};
+
+struct TextExecutor {
+    struct Range *ranges;
+    struct Worker *workers;
+    pthread_t *threads;     // indexed like workers, the first one being the calling thread
+    unsigned size;
+    pthread_mutex_t mutex;
+    pthread_cond_t started;
+    pthread_cond_t finished;
+    unsigned long generation;
+    unsigned running;       // threads still working on the current operation
+    bool stopping;
+    ChunkTask task;
+    void *context;
+};
+
+static bool Range_takeFront(struct Range *const self, size_t *const chunk) {
+    uint64_t bounds = __atomic_load_n(&self->bounds, __ATOMIC_ACQUIRE);
+    for (;;) {
+        const uint64_t first = bounds >> 32, end = bounds & UINT32_MAX;
+        if (first >= end) {
+            return false;
+        }
+        if (__atomic_compare_exchange_n(&self->bounds, &bounds, ((first + 1) << 32) | end, true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *chunk = (size_t) first;
+            return true;
+        }
+    }
+}
+
+static bool Range_takeBack(struct Range *const self, size_t *const chunk) {
+    uint64_t bounds = __atomic_load_n(&self->bounds, __ATOMIC_ACQUIRE);
+    for (;;) {
+        const uint64_t first = bounds >> 32, end = bounds & UINT32_MAX;
+        if (first >= end) {
+            return false;
+        }
+        if (__atomic_compare_exchange_n(&self->bounds, &bounds, (first << 32) | (end - 1), true,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *chunk = (size_t) end - 1;
+            return true;
+        }
+    }
+}
+
+static void TextExecutor_drain(TextExecutor *const self, const unsigned index) {
+    size_t chunk;
+    while (Range_takeFront(&self->ranges[index], &chunk)) {
+        self->task(self->context, chunk);
+    }
+    for (unsigned i = 1; i < self->size; i++) {
+        struct Range *const victim = &self->ranges[(index + i) % self->size];
+        while (Range_takeBack(victim, &chunk)) {
+            self->task(self->context, chunk);
+        }
+    }
+}
+
+static void *TextExecutor_work(void *const arg) {
+    const struct Worker *const worker = arg;
+    TextExecutor *const self = worker->executor;
+    unsigned long generation = 0;
+    pthread_mutex_lock(&self->mutex);
+    for (;;) {
+        while (!self->stopping && generation == self->generation) {
+            pthread_cond_wait(&self->started, &self->mutex);
+        }
+        if (self->stopping) {
+            break;
+        }
+        generation = self->generation;
+        pthread_mutex_unlock(&self->mutex);
+        TextExecutor_drain(self, worker->index);
+        pthread_mutex_lock(&self->mutex);
+        if (0 == --self->running) {
+            pthread_cond_signal(&self->finished);
+        }
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+/*
+ * Runs task once for each chunk in [0, chunks), returning when all of them are done.
+ */
+static void TextExecutor_run(TextExecutor *const self, const size_t chunks, const ChunkTask task, void *const context) {
+    assert(chunks <= UINT32_MAX);
+    if (1 == self->size || chunks < 2) {
+        for (size_t i = 0; i < chunks; i++) {
+            task(context, i);
+        }
+        return;
+    }
+    for (unsigned i = 0; i < self->size; i++) {
+        const uint64_t first = chunks * i / self->size, end = chunks * (i + 1) / self->size;
+        __atomic_store_n(&self->ranges[i].bounds, (first << 32) | end, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_lock(&self->mutex);
+    self->task = task;
+    self->context = context;
+    self->running = self->size - 1;
+    self->generation += 1;
+    pthread_cond_broadcast(&self->started);
+    pthread_mutex_unlock(&self->mutex);
+    TextExecutor_drain(self, 0);
+    pthread_mutex_lock(&self->mutex);
+    while (self->running > 0) {
+        pthread_cond_wait(&self->finished, &self->mutex);
+    }
+    pthread_mutex_unlock(&self->mutex);
+}
+
+/*
+ * Chunks are made larger on huge inputs so that their number always fits the bounds of a range.
+ */
+static size_t chunkSizeOf(const size_t size) {
+    const size_t minimum = size / UINT32_MAX + 1;
+    return minimum > TEXT_PARALLEL_CHUNK_SIZE ? minimum : TEXT_PARALLEL_CHUNK_SIZE;
+}
+
+static void storeMinimum(size_t *const target, const size_t value) {
+    size_t current = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (value < current && !__atomic_compare_exchange_n(target, &current, value, true,
+                                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {}
+}
+
+TextExecutor *TextExecutor_new(unsigned threads) {
+    if (0 == threads) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned) online : 1;
+    }
+    TextExecutor *self = Option_unwrap(Alligator_calloc(1, sizeof(*self)));
+    self->size = threads;
+    self->ranges = Option_unwrap(Alligator_calloc(threads, sizeof(self->ranges[0])));
+    self->workers = Option_unwrap(Alligator_calloc(threads, sizeof(self->workers[0])));
+    self->threads = Option_unwrap(Alligator_calloc(threads, sizeof(self->threads[0])));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->started, NULL);
+    pthread_cond_init(&self->finished, NULL);
+    for (unsigned i = 0; i < threads; i++) {
+        self->workers[i] = (struct Worker) {.executor=self, .index=i};
+    }
+    for (unsigned i = 1; i < threads; i++) {
+        if (0 != pthread_create(&self->threads[i], NULL, TextExecutor_work, &self->workers[i])) {
+            Panic_terminate("Unable to create thread");
+        }
+    }
+    return self;
+}
+
+unsigned TextExecutor_threads(const TextExecutor *const self) {
+    assert(self);
+    return self->size;
+}
+
+struct CaseContext {
+    Text text;
+    size_t length;
+    size_t chunkSize;
+    int (*map)(int);
+};
+
+static void mapCase(void *const arg, const size_t chunk) {
+    const struct CaseContext *const context = arg;
+    const size_t begin = chunk * context->chunkSize;
+    const size_t end = context->length - begin < context->chunkSize ? context->length : begin + context->chunkSize;
+    for (size_t i = begin; i < end; i++) {
+        context->text[i] = (char) context->map(context->text[i]);
+    }
+}
+
+static void TextExecutor_mapCase(TextExecutor *const self, const Text text, int (*const map)(int)) {
+    assert(self);
+    assert(text);
+    Text_Header_getMutable(text);
+    struct CaseContext context = {.text=text, .length=Text_length(text), .map=map};
+    context.chunkSize = chunkSizeOf(context.length);
+    TextExecutor_run(self, (context.length + context.chunkSize - 1) / context.chunkSize, mapCase, &context);
+}
+
+void TextExecutor_lower(TextExecutor *const self, const Text text) {
+    TextExecutor_mapCase(self, text, tolower);
+}
+
+void TextExecutor_upper(TextExecutor *const self, const Text text) {
+    TextExecutor_mapCase(self, text, toupper);
+}
+
+struct CountContext {
+    TextView text;
+    size_t length;
+    size_t chunkSize;
+    size_t *counts;     // one per chunk
+    char c;
+};
+
+static void countByte(void *const arg, const size_t chunk) {
+    const struct CountContext *const context = arg;
+    const size_t begin = chunk * context->chunkSize;
+    const size_t end = context->length - begin < context->chunkSize ? context->length : begin + context->chunkSize;
+    size_t count = 0, i = begin;
+    for (; end - i >= 64; i += 64) {
+        count += (size_t) __builtin_popcountll(TextSimd_matchMask64(context->text + i, context->c));
+    }
+    for (; i < end; i++) {
+        count += context->c == context->text[i];
+    }
+    context->counts[chunk] = count;
+}
+
+size_t TextExecutor_countByte(TextExecutor *const self, const TextView text, const char c) {
+    assert(self);
+    assert(text);
+    struct CountContext context = {.text=text, .length=Text_length(text), .c=c};
+    context.chunkSize = chunkSizeOf(context.length);
+    const size_t chunks = (context.length + context.chunkSize - 1) / context.chunkSize;
+    context.counts = Option_unwrap(Alligator_malloc(sizeof(context.counts[0]) * (chunks + 1)));
+    TextExecutor_run(self, chunks, countByte, &context);
+    size_t count = 0;
+    for (size_t i = 0; i < chunks; i++) {
+        count += context.counts[i];
+    }
+    Alligator_free(context.counts);
+    return count;
+}
+
+/*
+ * Chunks split the starting positions of the occurrences, each one searching up to size - 1 bytes past its end.
+ */
+struct FindContext {
+    TextView text;
+    size_t offset;
+    size_t positions;
+    size_t chunkSize;
+    const char *needle;
+    size_t size;
+    size_t found;   // the smallest index found so far
+};
+
+static void findNeedle(void *const arg, const size_t chunk) {
+    struct FindContext *const context = arg;
+    const size_t begin = context->offset + chunk * context->chunkSize;
+    const size_t last = context->offset + context->positions;
+    const size_t end = last - begin < context->chunkSize ? last : begin + context->chunkSize;
+    if (begin >= __atomic_load_n(&context->found, __ATOMIC_RELAXED)) {
+        return;
+    }
+    const char *const match = TextSimd_find(
+            context->text + begin, context->text + end + context->size - 1, context->needle, context->size
+    );
+    if (match) {
+        storeMinimum(&context->found, (size_t) (match - context->text));
+    }
+}
+
+size_t TextExecutor_find(TextExecutor *const self, const TextView text, const size_t offset,
+                         const void *const needle, const size_t size) {
+    assert(self);
+    assert(text);
+    assert(needle);
+    const size_t length = Text_length(text);
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+    if (0 == size) {
+        return offset;
+    }
+    if (size > length - offset) {
+        return NOT_FOUND;
+    }
+    struct FindContext context = {
+            .text=text, .offset=offset, .positions=length - offset - size + 1, .needle=needle, .size=size,
+            .found=NOT_FOUND
+    };
+    context.chunkSize = chunkSizeOf(context.positions);
+    TextExecutor_run(self, (context.positions + context.chunkSize - 1) / context.chunkSize, findNeedle, &context);
+    return context.found;
+}
+
+/*
+ * Chunk boundaries are moved forward past at most three continuation bytes: a sequence starting before a boundary
+ * ends before it, a continuation byte still found there is invalid wherever the validation would have started.
+ */
+struct ValidateContext {
+    TextView text;
+    size_t length;
+    size_t chunkSize;
+    size_t chunks;
+    size_t invalidOffset;   // the smallest offset found so far
+};
+
+static size_t boundaryOf(const struct ValidateContext *const context, const size_t chunk) {
+    if (0 == chunk || chunk >= context->chunks) {
+        return 0 == chunk ? 0 : context->length;
+    }
+    size_t boundary = chunk * context->chunkSize;    // the terminator stops the loop at the end of the text
+    for (size_t i = 0; i < 3 && 0x80 == (context->text[boundary] & 0xC0); i++) {
+        boundary++;
+    }
+    return boundary;
+}
+
+static void validateChunk(void *const arg, const size_t chunk) {
+    struct ValidateContext *const context = arg;
+    const size_t begin = boundaryOf(context, chunk), end = boundaryOf(context, chunk + 1);
+    if (begin >= __atomic_load_n(&context->invalidOffset, __ATOMIC_RELAXED)) {
+        return;
+    }
+    size_t invalidOffset;
+    TextUtf8Validator validator;
+    TextUtf8Validator_init(&validator);
+    TextUtf8Validator_update(&validator, context->text + begin, end - begin);
+    if (!TextUtf8Validator_finish(&validator, &invalidOffset)) {
+        storeMinimum(&context->invalidOffset, begin + invalidOffset);
+    }
+}
+
+bool TextExecutor_isValidUtf8(TextExecutor *const self, const TextView text, size_t *const invalidOffset) {
+    assert(self);
+    assert(text);
+    struct ValidateContext context = {.text=text, .length=Text_length(text), .invalidOffset=NOT_FOUND};
+    context.chunkSize = chunkSizeOf(context.length);
+    context.chunks = (context.length + context.chunkSize - 1) / context.chunkSize;
+    TextExecutor_run(self, context.chunks, validateChunk, &context);
+    if (NOT_FOUND == context.invalidOffset) {
+        return true;
+    }
+    if (invalidOffset) {
+        *invalidOffset = context.invalidOffset;
+    }
+    return false;
+}
+
+void TextExecutor_delete(TextExecutor *const self) {
+    if (self) {
+        pthread_mutex_lock(&self->mutex);
+        self->stopping = true;
+        pthread_cond_broadcast(&self->started);
+        pthread_mutex_unlock(&self->mutex);
+        for (unsigned i = 1; i < self->size; i++) {
+            pthread_join(self->threads[i], NULL);
+        }
+        pthread_cond_destroy(&self->finished);
+        pthread_cond_destroy(&self->started);
+        pthread_mutex_destroy(&self->mutex);
+        Alligator_free(self->threads);
+        Alligator_free(self->workers);
+        Alligator_free(self->ranges);
+        Alligator_free(self);
+    }
+}
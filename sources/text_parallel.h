@@ -0,0 +1,133 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A fixed pool of threads running bulk operations over huge texts.
+ * Texts are cut in chunks of TEXT_PARALLEL_CHUNK_SIZE bytes, each thread starts from its own share of chunks and
+ * steals from the others once done. Results never depend on the number of threads nor on the scheduling.
+ *
+ * A TextExecutor instance must be used by a single thread, which takes part in every operation.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+typedef struct TextExecutor TextExecutor;
+
+/**
+ * Creates an executor starting its threads.
+ *
+ * @param threads The number of threads including the caller, 0 to use one per online processor.
+ * @return a new instance.
+ */
+extern TextExecutor *TextExecutor_new(unsigned threads)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Gets the number of threads including the caller.
+ *
+ * @attention self must not be NULL.
+ */
+extern unsigned TextExecutor_threads(const TextExecutor *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Like Text_lower.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ */
+extern void TextExecutor_lower(TextExecutor *self, Text text)
+__attribute__((__nonnull__));
+
+/**
+ * Like Text_upper.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ */
+extern void TextExecutor_upper(TextExecutor *self, Text text)
+__attribute__((__nonnull__));
+
+/**
+ * Counts the occurrences of a byte in the text.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ */
+extern size_t TextExecutor_countByte(TextExecutor *self, TextView text, char c)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Finds the first occurrence of needle starting from offset.
+ * Chunks past an occurrence already found are skipped. An empty needle is found at offset.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention needle must not be NULL.
+ * @attention terminates execution if offset is greater than the text's length.
+ *
+ * @return the index of the occurrence, SIZE_MAX if not found.
+ */
+extern size_t TextExecutor_find(TextExecutor *self, TextView text, size_t offset, const void *needle, size_t size)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Like Text_isValidUtf8, chunk boundaries are moved past continuation bytes so that sequences are never split.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ *
+ * @param invalidOffset If not NULL and the content is invalid, set to the offset of the first invalid sequence.
+ * @return true if the content is valid UTF-8.
+ */
+extern bool TextExecutor_isValidUtf8(TextExecutor *self, TextView text, size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__(1, 2)));
+
+/**
+ * Stops the threads and deletes the executor.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextExecutor_delete(TextExecutor *self);
+
+#ifdef __cplusplus
+}
+#endif
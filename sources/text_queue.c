@@ -0,0 +1,202 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <alligator/alligator.h>
+#include "text_queue.h"
+#include "text_header.h"
+
+/*
+ * Bounded ring of cells where each cell's sequence tells whose turn it is: a cell at position pos can be written
+ * when its sequence equals pos and read when it equals pos + 1, reading hands it to position pos + size.
+ */
+struct Cell {
+    size_t sequence;
+    Text text;
+};
+
+struct Ring {
+    struct Cell *cells;
+    size_t mask;
+    char padding0[64 - sizeof(struct Cell *) - sizeof(size_t)];
+    size_t tail;    // next position to be written
+    char padding1[64 - sizeof(size_t)];
+    size_t head;    // next position to be read
+    char padding2[64 - sizeof(size_t)];
+};
+
+struct TextQueue {
+    struct Ring ring;
+};
+
+struct TextPool {
+    struct Ring ring;
+    size_t capacity;
+};
+
+static void Ring_init(struct Ring *const self, const size_t capacity) {
+    assert(capacity > 0);
+    assert(capacity <= SIZE_MAX / 2);
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    self->cells = Option_unwrap(Alligator_malloc(sizeof(self->cells[0]) * size));
+    for (size_t i = 0; i < size; i++) {
+        self->cells[i].sequence = i;
+        self->cells[i].text = NULL;
+    }
+    self->mask = size - 1;
+    self->tail = self->head = 0;
+}
+
+static bool Ring_push(struct Ring *const self, const Text text) {
+    size_t position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+    struct Cell *cell;
+    for (;;) {
+        cell = &self->cells[position & self->mask];
+        const size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        const intptr_t difference = (intptr_t) sequence - (intptr_t) position;
+        if (0 == difference) {
+            if (__atomic_compare_exchange_n(&self->tail, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return false;   // the cell still holds the text pushed a lap ago
+        } else {
+            position = __atomic_load_n(&self->tail, __ATOMIC_RELAXED);
+        }
+    }
+    cell->text = text;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+/*
+ * With a single consumer the head is never contended and is advanced without compare and swap.
+ */
+static Text Ring_pop(struct Ring *const self, const bool singleConsumer) {
+    size_t position = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+    struct Cell *cell;
+    for (;;) {
+        cell = &self->cells[position & self->mask];
+        const size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        const intptr_t difference = (intptr_t) sequence - (intptr_t) (position + 1);
+        if (0 == difference) {
+            if (singleConsumer) {
+                __atomic_store_n(&self->head, position + 1, __ATOMIC_RELAXED);
+                break;
+            }
+            if (__atomic_compare_exchange_n(&self->head, &position, position + 1, true,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (difference < 0) {
+            return NULL;    // the cell is not written yet
+        } else {
+            position = __atomic_load_n(&self->head, __ATOMIC_RELAXED);
+        }
+    }
+    const Text text = cell->text;
+    __atomic_store_n(&cell->sequence, position + self->mask + 1, __ATOMIC_RELEASE);
+    return text;
+}
+
+static void Ring_teardown(struct Ring *const self) {
+    for (Text text = Ring_pop(self, true); text; text = Ring_pop(self, true)) {
+        Text_delete(text);
+    }
+    Alligator_free(self->cells);
+}
+
+TextQueue *TextQueue_new(const size_t capacity) {
+    TextQueue *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    Ring_init(&self->ring, capacity);
+    return self;
+}
+
+bool TextQueue_push(TextQueue *const self, Text *const ref) {
+    assert(self);
+    assert(ref);
+    assert(*ref);
+    if (Ring_push(&self->ring, *ref)) {
+        *ref = NULL;
+        return true;
+    }
+    return false;
+}
+
+Text TextQueue_pop(TextQueue *const self) {
+    assert(self);
+    return Ring_pop(&self->ring, true);
+}
+
+void TextQueue_delete(TextQueue *const self) {
+    if (self) {
+        Ring_teardown(&self->ring);
+        Alligator_free(self);
+    }
+}
+
+TextPool *TextPool_new(const size_t size, const size_t capacity) {
+    assert(capacity < SIZE_MAX);
+    TextPool *self = Option_unwrap(Alligator_malloc(sizeof(*self)));
+    Ring_init(&self->ring, size);
+    self->capacity = capacity;
+    return self;
+}
+
+Text TextPool_take(TextPool *const self) {
+    assert(self);
+    const Text text = Ring_pop(&self->ring, false);
+    return text ? text : Text_withCapacity(self->capacity);
+}
+
+void TextPool_recycle(TextPool *const self, Text *const ref) {
+    assert(self);
+    assert(ref);
+    assert(*ref);
+    const Text text = *ref;
+    *ref = NULL;
+    if (Text_Storage_Heap != Text_Header_get(text)->storage) {
+        Text_delete(text);
+        return;
+    }
+    Text_clear(text);
+    if (!Ring_push(&self->ring, text)) {
+        Text_delete(text);
+    }
+}
+
+void TextPool_delete(TextPool *const self) {
+    if (self) {
+        Ring_teardown(&self->ring);
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,150 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * A bounded lock-free queue handing texts from many producer threads to a single consumer thread.
+ * Pushing transfers the ownership of the text to the queue, popping transfers it to the consumer.
+ *
+ * Together with a TextPool the buffers travel back to the producers keeping their capacity:
+ *
+ *      producers: text = TextPool_take(pool); text = Text_appendFormat(&text, ...); TextQueue_push(queue, &text);
+ *      consumer:  text = TextQueue_pop(queue); write(fd, text, Text_length(text)); TextPool_recycle(pool, &text);
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ */
+typedef struct TextQueue TextQueue;
+
+/**
+ * A bounded lock-free stock of empty texts shared by any number of threads.
+ */
+typedef struct TextPool TextPool;
+
+/**
+ * Creates a queue.
+ *
+ * @attention capacity must be greater than 0 and less or equal than SIZE_MAX / 2.
+ *
+ * @param capacity The maximum number of queued texts, rounded up to a power of two.
+ * @return a new instance.
+ */
+extern TextQueue *TextQueue_new(size_t capacity)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Appends a text to the queue, can be called by any thread.
+ *
+ * @attention self must not be NULL.
+ * @attention ref and *ref must not be NULL.
+ *
+ * @param self The queue.
+ * @param ref The text to push, set to NULL on success and left untouched if the queue is full.
+ * @return false if the queue is full.
+ */
+extern bool TextQueue_push(TextQueue *self, Text *ref)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Removes the oldest text from the queue, must be called by a single thread at a time.
+ *
+ * @attention self must not be NULL.
+ *
+ * @return the text now owned by the caller, NULL if the queue is empty.
+ */
+extern Text TextQueue_pop(TextQueue *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes a queue and the texts left in it.
+ * If NULL nothing will be done.
+ *
+ * @attention no thread must be using the queue.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextQueue_delete(TextQueue *self);
+
+/**
+ * Creates a pool.
+ *
+ * @attention size must be greater than 0 and less or equal than SIZE_MAX / 2.
+ * @attention capacity must be less than SIZE_MAX.
+ *
+ * @param size The maximum number of texts kept, rounded up to a power of two.
+ * @param capacity The capacity of the texts created when the pool is empty.
+ * @return a new instance.
+ */
+extern TextPool *TextPool_new(size_t size, size_t capacity)
+__attribute__((__warn_unused_result__));
+
+/**
+ * Takes an empty text from the pool, creating one if the pool is empty. Can be called by any thread.
+ *
+ * @attention self must not be NULL.
+ *
+ * @return an empty text owned by the caller.
+ */
+extern Text TextPool_take(TextPool *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Clears a text and gives it back to the pool keeping its capacity, the text is deleted if the pool is full.
+ * Can be called by any thread.
+ *
+ * @attention self must not be NULL.
+ * @attention ref and *ref must not be NULL.
+ * @attention the reference to the text will be invalidated after this call.
+ */
+extern void TextPool_recycle(TextPool *self, Text *ref)
+__attribute__((__nonnull__));
+
+/**
+ * Deletes a pool and the texts kept in it.
+ * If NULL nothing will be done.
+ *
+ * @attention no thread must be using the pool.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextPool_delete(TextPool *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,1417 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_regex.h"
+#include "text_config.h"
+#include "text_simd.h"
+
+#if TEXT_REGEX_CACHE_SIZE < 1UL
+    #error
+#endif
+
+#if TEXT_REGEX_MAX_INSTRUCTIONS < 1UL
+    #error
+#endif
+
+#define NONE            SIZE_MAX
+#define UNBOUNDED       SIZE_MAX
+#define MAX_REPEAT      1000U   // greatest bound accepted by {n,m}
+#define MAX_DEPTH       1000U   // greatest nesting of groups
+#define PREFIX_LIMIT    64U     // greatest size of the literal prefix
+
+/*
+ * Abstract syntax tree.
+ */
+
+enum NodeKind {
+    NODE_EMPTY,
+    NODE_SET,
+    NODE_BEGIN,
+    NODE_END,
+    NODE_CONCAT,
+    NODE_ALTERNATE,
+    NODE_REPEAT,
+    NODE_GROUP,
+};
+
+struct Node {
+    enum NodeKind kind;
+    size_t offset;      // the position of the node in the pattern
+    size_t child;       // the first child of concatenations, alternations, repetitions and groups
+    size_t sibling;     // the next child of the parent or NONE
+    size_t value;       // the set of NODE_SET, the index of NODE_GROUP
+    size_t min;         // the bounds of NODE_REPEAT
+    size_t max;
+    bool greedy;
+};
+
+struct ByteSet {
+    uint32_t bitmap[8];
+};
+
+struct Parser {
+    const char *pattern;
+    size_t length;
+    size_t cursor;
+    size_t depth;
+    size_t groups;
+    size_t error;
+    struct Node *nodes;
+    size_t nodesSize;
+    size_t nodesCapacity;
+    struct ByteSet *sets;
+    size_t setsSize;
+    size_t setsCapacity;
+};
+
+static void ByteSet_add(struct ByteSet *const self, const unsigned char c) {
+    self->bitmap[c >> 5] |= UINT32_C(1) << (c & 31);
+}
+
+static void ByteSet_addRange(struct ByteSet *const self, const unsigned char lo, const unsigned char hi) {
+    for (unsigned c = lo; c <= hi; c++) {
+        ByteSet_add(self, (unsigned char) c);
+    }
+}
+
+static bool ByteSet_contains(const struct ByteSet *const self, const unsigned char c) {
+    return 0 != (self->bitmap[c >> 5] & (UINT32_C(1) << (c & 31)));
+}
+
+static void ByteSet_invert(struct ByteSet *const self) {
+    for (size_t i = 0; i < 8; i++) {
+        self->bitmap[i] = ~self->bitmap[i];
+    }
+}
+
+static void ByteSet_merge(struct ByteSet *const self, const struct ByteSet *const other) {
+    for (size_t i = 0; i < 8; i++) {
+        self->bitmap[i] |= other->bitmap[i];
+    }
+}
+
+/*
+ * Returns the only byte of the set or -1 if the set holds zero or many bytes.
+ */
+static int ByteSet_single(const struct ByteSet *const self) {
+    int single = -1;
+    for (size_t i = 0; i < 8; i++) {
+        if (self->bitmap[i]) {
+            if (single >= 0 || (self->bitmap[i] & (self->bitmap[i] - 1))) {
+                return -1;
+            }
+            single = (int) (i * 32 + TextSimd_countTrailingZeros(self->bitmap[i]));
+        }
+    }
+    return single;
+}
+
+static size_t Parser_fail(struct Parser *const self, const size_t offset) {
+    if (NONE == self->error) {
+        self->error = offset;
+    }
+    return NONE;
+}
+
+static size_t Parser_node(struct Parser *const self, const enum NodeKind kind, const size_t offset) {
+    if (self->nodesSize == self->nodesCapacity) {
+        self->nodesCapacity = self->nodesCapacity > 0 ? self->nodesCapacity * 2 : 16;
+        self->nodes = Option_unwrap(Alligator_realloc(self->nodes, self->nodesCapacity * sizeof(self->nodes[0])));
+    }
+    self->nodes[self->nodesSize] = (struct Node) {
+            .kind = kind, .offset = offset, .child = NONE, .sibling = NONE, .value = 0, .min = 0, .max = 0,
+            .greedy = true
+    };
+    return self->nodesSize++;
+}
+
+static size_t Parser_set(struct Parser *const self, const struct ByteSet *const set, const size_t offset) {
+    if (self->setsSize == self->setsCapacity) {
+        self->setsCapacity = self->setsCapacity > 0 ? self->setsCapacity * 2 : 16;
+        self->sets = Option_unwrap(Alligator_realloc(self->sets, self->setsCapacity * sizeof(self->sets[0])));
+    }
+    self->sets[self->setsSize] = *set;
+    const size_t node = Parser_node(self, NODE_SET, offset);
+    self->nodes[node].value = self->setsSize++;
+    return node;
+}
+
+static bool isAlphanumeric(const char c) {
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+/*
+ * Parses the escape following a backslash: returns the escaped byte or -1 if the escape denotes a class, stored in
+ * set, or -2 if the escape is malformed.
+ */
+static int Parser_escape(struct Parser *const self, struct ByteSet *const set) {
+    const size_t offset = self->cursor - 1;
+    if (self->cursor >= self->length) {
+        Parser_fail(self, offset);
+        return -2;
+    }
+    const char c = self->pattern[self->cursor++];
+    memset(set, 0, sizeof(*set));
+    switch (c) {
+        case 'd':
+        case 'D':
+            ByteSet_addRange(set, '0', '9');
+            break;
+        case 'w':
+        case 'W':
+            ByteSet_addRange(set, '0', '9');
+            ByteSet_addRange(set, 'a', 'z');
+            ByteSet_addRange(set, 'A', 'Z');
+            ByteSet_add(set, '_');
+            break;
+        case 's':
+        case 'S':
+            ByteSet_addRange(set, '\t', '\r');
+            ByteSet_add(set, ' ');
+            break;
+        case 'n':
+            return '\n';
+        case 'r':
+            return '\r';
+        case 't':
+            return '\t';
+        case 'f':
+            return '\f';
+        case 'v':
+            return '\v';
+        case '0':
+            return '\0';
+        case 'x': {
+            const unsigned char *const digits = (const unsigned char *) self->pattern + self->cursor;
+            const int high = self->cursor < self->length ? TextSimd_hexValue(digits[0]) : -1;
+            const int low = self->cursor + 1 < self->length ? TextSimd_hexValue(digits[1]) : -1;
+            if (high < 0 || low < 0) {
+                Parser_fail(self, offset);
+                return -2;
+            }
+            self->cursor += 2;
+            return high * 16 + low;
+        }
+        default:
+            if (isAlphanumeric(c)) {
+                Parser_fail(self, offset);
+                return -2;
+            }
+            return (unsigned char) c;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        ByteSet_invert(set);
+    }
+    return -1;
+}
+
+/*
+ * Parses a bracket expression, the cursor is past the opening bracket.
+ */
+static size_t Parser_class(struct Parser *const self) {
+    const size_t offset = self->cursor - 1;
+    struct ByteSet set = {{0}}, escaped;
+    const bool negated = self->cursor < self->length && '^' == self->pattern[self->cursor];
+    self->cursor += negated;
+    for (bool first = true;; first = false) {
+        if (self->cursor >= self->length) {
+            return Parser_fail(self, offset);
+        }
+        if (']' == self->pattern[self->cursor] && !first) {
+            self->cursor++;
+            break;
+        }
+        int lo = (unsigned char) self->pattern[self->cursor++];
+        if ('\\' == lo && (lo = Parser_escape(self, &escaped)) < 0) {
+            if (-2 == lo) {
+                return NONE;
+            }
+            ByteSet_merge(&set, &escaped);
+            continue;
+        }
+        if (self->cursor + 1 < self->length && '-' == self->pattern[self->cursor] &&
+            ']' != self->pattern[self->cursor + 1]) {
+            const size_t rangeOffset = self->cursor++;
+            int hi = (unsigned char) self->pattern[self->cursor++];
+            if ('\\' == hi && (hi = Parser_escape(self, &escaped)) < 0) {
+                return Parser_fail(self, rangeOffset);
+            }
+            if (hi < lo) {
+                return Parser_fail(self, rangeOffset);
+            }
+            ByteSet_addRange(&set, (unsigned char) lo, (unsigned char) hi);
+        } else {
+            ByteSet_add(&set, (unsigned char) lo);
+        }
+    }
+    if (negated) {
+        ByteSet_invert(&set);
+    }
+    return Parser_set(self, &set, offset);
+}
+
+/*
+ * Parses {n}, {n,} or {n,m} at the cursor, returns false leaving the cursor untouched if the syntax doesn't match.
+ */
+static bool Parser_bounds(struct Parser *const self, size_t *const min, size_t *const max) {
+    size_t cursor = self->cursor + 1, values[2] = {0, 0}, count = 0;
+    bool comma = false;
+    for (; cursor < self->length; cursor++) {
+        const char c = self->pattern[cursor];
+        if (c >= '0' && c <= '9') {
+            values[comma] = values[comma] * 10 + (size_t) (c - '0');
+            if (values[comma] > MAX_REPEAT) {
+                values[comma] = MAX_REPEAT + 1;     // reported as too large by the caller
+            }
+            count++;
+        } else if (',' == c && !comma) {
+            if (0 == count) {
+                return false;
+            }
+            comma = true;
+            count = 0;
+        } else if ('}' == c) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    if (cursor >= self->length || (0 == count && !comma)) {
+        return false;
+    }
+    *min = values[0];
+    *max = comma ? (count > 0 ? values[1] : UNBOUNDED) : values[0];
+    self->cursor = cursor + 1;
+    return true;
+}
+
+static size_t Parser_alternation(struct Parser *self);
+
+static size_t Parser_atom(struct Parser *const self) {
+    const size_t offset = self->cursor;
+    struct ByteSet set = {{0}};
+    size_t min, max;
+    switch (self->pattern[self->cursor++]) {
+        case '(': {
+            bool capturing = true;
+            if (self->cursor < self->length && '?' == self->pattern[self->cursor]) {
+                if (self->cursor + 1 >= self->length || ':' != self->pattern[self->cursor + 1]) {
+                    return Parser_fail(self, offset);
+                }
+                self->cursor += 2;
+                capturing = false;
+            }
+            if (++self->depth > MAX_DEPTH) {
+                return Parser_fail(self, offset);
+            }
+            const size_t index = capturing ? ++self->groups : 0;
+            const size_t child = Parser_alternation(self);
+            if (NONE == child) {
+                return NONE;
+            }
+            if (self->cursor >= self->length || ')' != self->pattern[self->cursor]) {
+                return Parser_fail(self, offset);
+            }
+            self->cursor++;
+            self->depth--;
+            if (!capturing) {
+                return child;
+            }
+            const size_t node = Parser_node(self, NODE_GROUP, offset);
+            self->nodes[node].child = child;
+            self->nodes[node].value = index;
+            return node;
+        }
+        case '[':
+            return Parser_class(self);
+        case '.':
+            ByteSet_add(&set, '\n');
+            ByteSet_invert(&set);
+            return Parser_set(self, &set, offset);
+        case '^':
+            return Parser_node(self, NODE_BEGIN, offset);
+        case '$':
+            return Parser_node(self, NODE_END, offset);
+        case '\\': {
+            const int c = Parser_escape(self, &set);
+            if (-2 == c) {
+                return NONE;
+            }
+            if (c >= 0) {
+                ByteSet_add(&set, (unsigned char) c);
+            }
+            return Parser_set(self, &set, offset);
+        }
+        case '*':
+        case '+':
+        case '?':
+            return Parser_fail(self, offset);   // nothing to repeat
+        case '{':
+            self->cursor--;
+            if (Parser_bounds(self, &min, &max)) {
+                return Parser_fail(self, offset);
+            }
+            self->cursor++;
+            ByteSet_add(&set, '{');
+            return Parser_set(self, &set, offset);
+        default:
+            ByteSet_add(&set, (unsigned char) self->pattern[offset]);
+            return Parser_set(self, &set, offset);
+    }
+}
+
+static bool Parser_quantifier(struct Parser *const self, size_t *const min, size_t *const max) {
+    switch (self->cursor < self->length ? self->pattern[self->cursor] : '\0') {
+        case '*':
+            *min = 0, *max = UNBOUNDED, self->cursor++;
+            return true;
+        case '+':
+            *min = 1, *max = UNBOUNDED, self->cursor++;
+            return true;
+        case '?':
+            *min = 0, *max = 1, self->cursor++;
+            return true;
+        case '{':
+            return Parser_bounds(self, min, max);
+        default:
+            return false;
+    }
+}
+
+static size_t Parser_repetition(struct Parser *const self) {
+    const size_t node = Parser_atom(self), offset = self->cursor;
+    size_t min, max;
+    if (NONE == node || !Parser_quantifier(self, &min, &max)) {
+        return node;
+    }
+    if (min > MAX_REPEAT || (UNBOUNDED != max && (max > MAX_REPEAT || max < min))) {
+        return Parser_fail(self, offset);
+    }
+    const bool greedy = !(self->cursor < self->length && '?' == self->pattern[self->cursor]);
+    self->cursor += !greedy;
+    if (Parser_quantifier(self, &min, &max)) {
+        return Parser_fail(self, offset);   // multiple repetition
+    }
+    const size_t repeat = Parser_node(self, NODE_REPEAT, offset);
+    self->nodes[repeat].child = node;
+    self->nodes[repeat].min = min;
+    self->nodes[repeat].max = max;
+    self->nodes[repeat].greedy = greedy;
+    return repeat;
+}
+
+static size_t Parser_concatenation(struct Parser *const self) {
+    const size_t offset = self->cursor;
+    size_t first = NONE, last = NONE, count = 0;
+    while (self->cursor < self->length && '|' != self->pattern[self->cursor] && ')' != self->pattern[self->cursor]) {
+        const size_t node = Parser_repetition(self);
+        if (NONE == node) {
+            return NONE;
+        }
+        if (NONE == first) {
+            first = node;
+        } else {
+            self->nodes[last].sibling = node;
+        }
+        last = node;
+        count++;
+    }
+    if (count <= 1) {
+        return NONE == first ? Parser_node(self, NODE_EMPTY, offset) : first;
+    }
+    const size_t node = Parser_node(self, NODE_CONCAT, offset);
+    self->nodes[node].child = first;
+    return node;
+}
+
+static size_t Parser_alternation(struct Parser *const self) {
+    const size_t offset = self->cursor;
+    const size_t first = Parser_concatenation(self);
+    if (NONE == first || self->cursor >= self->length || '|' != self->pattern[self->cursor]) {
+        return first;
+    }
+    size_t last = first;
+    while (self->cursor < self->length && '|' == self->pattern[self->cursor]) {
+        self->cursor++;
+        const size_t node = Parser_concatenation(self);
+        if (NONE == node) {
+            return NONE;
+        }
+        self->nodes[last].sibling = node;
+        last = node;
+    }
+    const size_t node = Parser_node(self, NODE_ALTERNATE, offset);
+    self->nodes[node].child = first;
+    return node;
+}
+
+/*
+ * Thompson NFA programs.
+ */
+
+enum Opcode {
+    OP_SET,         // consumes a byte of the set arg then continues to next
+    OP_SPLIT,       // continues to next, then to alt with lower priority
+    OP_JUMP,        // continues to next
+    OP_SAVE,        // records the position in the slot arg then continues to next
+    OP_BEGIN,       // continues to next at the start of the text
+    OP_END,         // continues to next at the end of the text
+    OP_MATCH,
+};
+
+struct Instruction {
+    uint32_t opcode;
+    uint32_t arg;
+    uint32_t next;
+    uint32_t alt;
+};
+
+struct Program {
+    struct Instruction *instructions;
+    size_t size;
+    size_t capacity;
+};
+
+struct Compiler {
+    const struct Node *nodes;
+    struct Program *program;
+    bool reverse;       // concatenations are reversed, anchors swapped and groups ignored
+    size_t error;
+};
+
+static uint32_t Compiler_emit(struct Compiler *const self, const enum Opcode opcode, const size_t arg,
+                              const size_t offset) {
+    struct Program *const program = self->program;
+    if (program->size >= TEXT_REGEX_MAX_INSTRUCTIONS) {
+        if (NONE == self->error) {
+            self->error = offset;
+        }
+        program->size = 0;  // keeps emitting harmlessly until the compilation unwinds
+    }
+    if (program->size == program->capacity) {
+        program->capacity = program->capacity > 0 ? program->capacity * 2 : 16;
+        program->instructions = Option_unwrap(
+                Alligator_realloc(program->instructions, program->capacity * sizeof(program->instructions[0]))
+        );
+    }
+    const uint32_t pc = (uint32_t) program->size++;
+    program->instructions[pc] = (struct Instruction) {
+            .opcode = opcode, .arg = (uint32_t) arg, .next = pc + 1, .alt = pc + 1
+    };
+    return pc;
+}
+
+/*
+ * Tells whether the node can match the empty string.
+ * An empty iteration of x* leads back to the loop split at the same position and is dropped as a revisit, losing its
+ * captures and priority: such stars are compiled as (x+)? instead, as Go and RE2 do, so ()* captures an empty group.
+ */
+static bool isNullable(const struct Node *const nodes, const size_t index) {
+    const struct Node *const node = &nodes[index];
+    switch (node->kind) {
+        case NODE_SET:
+            return false;
+        case NODE_CONCAT:
+            for (size_t child = node->child; NONE != child; child = nodes[child].sibling) {
+                if (!isNullable(nodes, child)) {
+                    return false;
+                }
+            }
+            return true;
+        case NODE_ALTERNATE:
+            for (size_t child = node->child; NONE != child; child = nodes[child].sibling) {
+                if (isNullable(nodes, child)) {
+                    return true;
+                }
+            }
+            return false;
+        case NODE_REPEAT:
+            return 0 == node->min || isNullable(nodes, node->child);
+        case NODE_GROUP:
+            return isNullable(nodes, node->child);
+        case NODE_EMPTY:
+        case NODE_BEGIN:
+        case NODE_END:
+            return true;
+    }
+    return true;
+}
+
+static void Compiler_node(struct Compiler *const self, const size_t index) {
+    const struct Node *const node = &self->nodes[index];
+    struct Instruction *instructions;
+    if (NONE != self->error) {
+        return;
+    }
+    switch (node->kind) {
+        case NODE_EMPTY:
+            break;
+        case NODE_SET:
+            Compiler_emit(self, OP_SET, node->value, node->offset);
+            break;
+        case NODE_BEGIN:
+            Compiler_emit(self, self->reverse ? OP_END : OP_BEGIN, 0, node->offset);
+            break;
+        case NODE_END:
+            Compiler_emit(self, self->reverse ? OP_BEGIN : OP_END, 0, node->offset);
+            break;
+        case NODE_GROUP:
+            if (!self->reverse) {
+                Compiler_emit(self, OP_SAVE, 2 * node->value, node->offset);
+            }
+            Compiler_node(self, node->child);
+            if (!self->reverse) {
+                Compiler_emit(self, OP_SAVE, 2 * node->value + 1, node->offset);
+            }
+            break;
+        case NODE_CONCAT:
+            if (self->reverse) {
+                size_t count = 0, *children;
+                for (size_t child = node->child; NONE != child; child = self->nodes[child].sibling) {
+                    count++;
+                }
+                children = Option_unwrap(Alligator_malloc(count * sizeof(children[0])));
+                for (size_t child = node->child, i = count; NONE != child; child = self->nodes[child].sibling) {
+                    children[--i] = child;
+                }
+                for (size_t i = 0; i < count; i++) {
+                    Compiler_node(self, children[i]);
+                }
+                Alligator_free(children);
+            } else {
+                for (size_t child = node->child; NONE != child; child = self->nodes[child].sibling) {
+                    Compiler_node(self, child);
+                }
+            }
+            break;
+        case NODE_ALTERNATE: {
+            uint32_t jumps = UINT32_MAX;    // the pending jumps are chained through their arg
+            size_t child = node->child;
+            for (; NONE != self->nodes[child].sibling; child = self->nodes[child].sibling) {
+                const uint32_t split = Compiler_emit(self, OP_SPLIT, 0, node->offset);
+                Compiler_node(self, child);
+                const uint32_t jump = Compiler_emit(self, OP_JUMP, jumps, node->offset);
+                jumps = jump;
+                self->program->instructions[split].alt = jump + 1;
+            }
+            Compiler_node(self, child);
+            instructions = self->program->instructions;
+            while (NONE == self->error && UINT32_MAX != jumps) {
+                const uint32_t previous = instructions[jumps].arg;
+                instructions[jumps].next = (uint32_t) self->program->size;
+                jumps = previous;
+            }
+            break;
+        }
+        case NODE_REPEAT: {
+            const bool unbounded = UNBOUNDED == node->max;
+            const size_t copies = unbounded && node->min > 0 ? node->min - 1 : node->min;
+            for (size_t i = 0; i < copies; i++) {
+                Compiler_node(self, node->child);
+            }
+            if (unbounded && node->min > 0) {   // x+: x; split back
+                const uint32_t body = (uint32_t) self->program->size;
+                Compiler_node(self, node->child);
+                const uint32_t split = Compiler_emit(self, OP_SPLIT, 0, node->offset);
+                instructions = self->program->instructions;
+                instructions[split].next = node->greedy ? body : split + 1;
+                instructions[split].alt = node->greedy ? split + 1 : body;
+            } else if (unbounded && isNullable(self->nodes, node->child)) {   // x* as (x+)?, see isNullable
+                const uint32_t skip = Compiler_emit(self, OP_SPLIT, 0, node->offset);
+                Compiler_node(self, node->child);
+                const uint32_t split = Compiler_emit(self, OP_SPLIT, 0, node->offset);
+                instructions = self->program->instructions;
+                instructions[split].next = node->greedy ? skip + 1 : split + 1;
+                instructions[split].alt = node->greedy ? split + 1 : skip + 1;
+                instructions[skip].next = node->greedy ? skip + 1 : split + 1;
+                instructions[skip].alt = node->greedy ? split + 1 : skip + 1;
+            } else if (unbounded) {             // x*: split forward; x; jump back
+                const uint32_t split = Compiler_emit(self, OP_SPLIT, 0, node->offset);
+                Compiler_node(self, node->child);
+                const uint32_t jump = Compiler_emit(self, OP_JUMP, 0, node->offset);
+                instructions = self->program->instructions;
+                instructions[jump].next = split;
+                instructions[split].next = node->greedy ? split + 1 : jump + 1;
+                instructions[split].alt = node->greedy ? jump + 1 : split + 1;
+            } else {                            // x{0,n}: n nested optional copies all skipping to the end
+                uint32_t splits = UINT32_MAX;   // the pending splits are chained through their arg
+                for (size_t i = node->min; i < node->max; i++) {
+                    splits = Compiler_emit(self, OP_SPLIT, splits, node->offset);
+                    Compiler_node(self, node->child);
+                }
+                instructions = self->program->instructions;
+                const uint32_t end = (uint32_t) self->program->size;
+                while (NONE == self->error && UINT32_MAX != splits) {
+                    const uint32_t previous = instructions[splits].arg;
+                    instructions[splits].next = node->greedy ? splits + 1 : end;
+                    instructions[splits].alt = node->greedy ? end : splits + 1;
+                    splits = previous;
+                }
+            }
+            break;
+        }
+    }
+}
+
+/*
+ * Sparse set of program counters, cleared in constant time.
+ */
+struct SparseSet {
+    uint32_t *dense;
+    uint32_t *sparse;
+    size_t size;
+};
+
+static bool SparseSet_insert(struct SparseSet *const self, const uint32_t pc) {
+    const uint32_t i = self->sparse[pc];
+    if (i < self->size && self->dense[i] == pc) {
+        return false;
+    }
+    self->sparse[pc] = (uint32_t) self->size;
+    self->dense[self->size++] = pc;
+    return true;
+}
+
+/*
+ * Lazily built DFA: each state is the list of the threads of the program, in priority order, waiting on a byte or on
+ * the end of the text. Transitions are computed the first time they are taken and cached in a table indexed by byte
+ * class, the extra class standing for the end of the text. States are referred to by the offset of their row in the
+ * table, sparing a multiplication per byte. The cache is flushed when it outgrows its budget, at most one state per
+ * byte is built so the scan stays linear anyway.
+ */
+
+#define DFA_DEAD        UINT32_C(0)             // the state without threads
+#define DFA_UNKNOWN     UINT32_MAX              // a transition not computed yet
+#define DFA_MATCH       UINT32_C(0x80000000)    // set on transitions to states having reached a match
+#define DFA_ROW         UINT32_C(0x7FFFFFFF)
+#define DFA_BEGIN       UINT32_C(1)             // the state was built at the start of the text
+#define DFA_MIN_STATES  8U                      // states kept regardless of the budget
+
+struct DfaState {
+    size_t threads;     // offset of the threads in the pool
+    uint32_t size;
+    uint32_t flags;
+};
+
+struct Dfa {
+    const struct Program *program;
+    bool longest;               // matches don't cut the lower priority threads
+    size_t generation;          // incremented on each flush
+    uint32_t starts[2];         // the start states, not at and at the start of the text, or DFA_UNKNOWN
+    size_t memory;
+    struct DfaState *states;
+    size_t statesSize;
+    size_t statesCapacity;
+    uint32_t *transitions;
+    uint32_t *pool;
+    size_t poolSize;
+    size_t poolCapacity;
+    uint32_t *buckets;          // open addressing on state indexes, UINT32_MAX for empty buckets
+    size_t bucketsCapacity;
+};
+
+struct TextRegex {
+    struct Program forward;     // entries: unanchoredEntry, anchoredEntry
+    struct Program backward;    // the reversed pattern matched backward from the end of a match
+    uint32_t unanchoredEntry;
+    uint32_t anchoredEntry;
+    struct ByteSet *sets;
+    size_t groups;
+    size_t classesSize;         // the end of the text class included
+    unsigned char classes[256];
+    unsigned char representatives[256];
+    bool anchored;              // all the matches start at the start of the text
+    size_t prefixSize;
+    char prefix[PREFIX_LIMIT];
+    struct Dfa search;          // forward leftmost-first
+    struct Dfa full;            // forward longest
+    struct Dfa reverse;         // backward longest
+    struct SparseSet visited;
+    uint32_t *stack;
+    uint32_t *threads;
+    size_t *slots;              // Pike VM captures, allocated on first use
+    uint32_t *pikeThreads;
+    struct PikeFrame *frames;
+};
+
+static uint32_t Dfa_hash(const uint32_t *const threads, const size_t size, const uint32_t flags) {
+    uint32_t hash = UINT32_C(2166136261) ^ flags;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ threads[i]) * UINT32_C(16777619);
+    }
+    return hash;
+}
+
+static void Dfa_rehash(struct Dfa *const self, const size_t capacity) {
+    Alligator_free(self->buckets);
+    self->bucketsCapacity = capacity;
+    self->buckets = Option_unwrap(Alligator_malloc(capacity * sizeof(self->buckets[0])));
+    memset(self->buckets, 0xFF, capacity * sizeof(self->buckets[0]));
+    for (uint32_t i = 0; i < self->statesSize; i++) {
+        const struct DfaState *const state = &self->states[i];
+        size_t bucket = Dfa_hash(self->pool + state->threads, state->size, state->flags) & (capacity - 1);
+        while (UINT32_MAX != self->buckets[bucket]) {
+            bucket = (bucket + 1) & (capacity - 1);
+        }
+        self->buckets[bucket] = i;
+    }
+}
+
+static uint32_t Dfa_insert(struct Dfa *self, size_t stride, const uint32_t *threads, size_t size, uint32_t flags);
+
+static void Dfa_flush(struct Dfa *const self, const size_t stride) {
+    self->generation++;
+    self->memory = 0;
+    self->statesSize = 0;
+    self->poolSize = 0;
+    self->starts[0] = self->starts[1] = DFA_UNKNOWN;
+    memset(self->buckets, 0xFF, self->bucketsCapacity * sizeof(self->buckets[0]));
+    Dfa_insert(self, stride, NULL, 0, 0);   // DFA_DEAD
+}
+
+static void Dfa_init(struct Dfa *const self, const struct Program *const program, const bool longest,
+                     const size_t stride) {
+    memset(self, 0, sizeof(*self));
+    self->program = program;
+    self->longest = longest;
+    self->starts[0] = self->starts[1] = DFA_UNKNOWN;
+    Dfa_rehash(self, 64);
+    Dfa_insert(self, stride, NULL, 0, 0);   // DFA_DEAD
+}
+
+static void Dfa_destroy(struct Dfa *const self) {
+    Alligator_free(self->states);
+    Alligator_free(self->transitions);
+    Alligator_free(self->pool);
+    Alligator_free(self->buckets);
+}
+
+/*
+ * Gets the index of the state having the given threads and flags, creating it if needed.
+ */
+static uint32_t Dfa_insert(struct Dfa *const self, const size_t stride, const uint32_t *const threads,
+                           const size_t size, const uint32_t flags) {
+    const uint32_t hash = Dfa_hash(threads, size, flags);
+    size_t bucket = hash & (self->bucketsCapacity - 1);
+    for (uint32_t i; UINT32_MAX != (i = self->buckets[bucket]); bucket = (bucket + 1) & (self->bucketsCapacity - 1)) {
+        const struct DfaState *const state = &self->states[i];
+        if (state->flags == flags && state->size == size &&
+            (0 == size || 0 == memcmp(self->pool + state->threads, threads, size * sizeof(threads[0])))) {
+            return i;
+        }
+    }
+
+    const size_t memory = sizeof(struct DfaState) + (stride + size + 2) * sizeof(uint32_t);
+    if (self->memory + memory > TEXT_REGEX_CACHE_SIZE && self->statesSize >= DFA_MIN_STATES) {
+        Dfa_flush(self, stride);
+        return Dfa_insert(self, stride, threads, size, flags);
+    }
+    if ((self->statesSize + 1) * stride > DFA_ROW) {
+        Panic_terminate("Out of range");
+    }
+    if (self->statesSize == self->statesCapacity) {
+        self->statesCapacity = self->statesCapacity > 0 ? self->statesCapacity * 2 : 16;
+        self->states = Option_unwrap(Alligator_realloc(self->states, self->statesCapacity * sizeof(self->states[0])));
+        self->transitions = Option_unwrap(
+                Alligator_realloc(self->transitions, self->statesCapacity * stride * sizeof(self->transitions[0]))
+        );
+    }
+    if (self->poolSize + size > self->poolCapacity) {
+        const size_t needed = self->poolSize + size;
+        self->poolCapacity = self->poolCapacity * 2 > needed ? self->poolCapacity * 2 : needed;
+        self->pool = Option_unwrap(Alligator_realloc(self->pool, self->poolCapacity * sizeof(self->pool[0])));
+    }
+
+    const uint32_t index = (uint32_t) self->statesSize++;
+    if (size > 0) {
+        memcpy(self->pool + self->poolSize, threads, size * sizeof(threads[0]));
+    }
+    self->states[index] = (struct DfaState) {.threads = self->poolSize, .size = (uint32_t) size, .flags = flags};
+    self->poolSize += size;
+    self->memory += memory;
+    memset(self->transitions + index * stride, 0xFF, stride * sizeof(self->transitions[0]));
+    if (2 * self->statesSize > self->bucketsCapacity) {
+        Dfa_rehash(self, self->bucketsCapacity * 2);
+    } else {
+        self->buckets[bucket] = index;
+    }
+    return index;
+}
+
+/*
+ * Follows the empty transitions from pc appending the threads reached to the regex threads buffer.
+ * Returns true if a match was reached, in which case leftmost-first automata stop at once: the threads yet to be
+ * reached have lower priority than the match.
+ */
+static bool Dfa_closure(TextRegex *const regex, const struct Dfa *const self, const uint32_t pc,
+                        const bool atBegin, const bool atEnd, size_t *const size) {
+    const struct Instruction *const instructions = self->program->instructions;
+    uint32_t *const stack = regex->stack;
+    size_t top = 0;
+    bool matched = false;
+    stack[top++] = pc;
+    while (top > 0) {
+        const uint32_t current = stack[--top];
+        if (!SparseSet_insert(&regex->visited, current)) {
+            continue;
+        }
+        const struct Instruction *const instruction = &instructions[current];
+        switch (instruction->opcode) {
+            case OP_SET:
+                if (!atEnd) {
+                    regex->threads[(*size)++] = current;
+                }
+                break;
+            case OP_SPLIT:
+                stack[top++] = instruction->alt;
+                stack[top++] = instruction->next;
+                break;
+            case OP_JUMP:
+            case OP_SAVE:
+                stack[top++] = instruction->next;
+                break;
+            case OP_BEGIN:
+                if (atBegin) {
+                    stack[top++] = instruction->next;
+                }
+                break;
+            case OP_END:
+                if (atEnd) {
+                    stack[top++] = instruction->next;
+                } else {
+                    regex->threads[(*size)++] = current;
+                }
+                break;
+            default:
+                if (!self->longest) {
+                    return true;
+                }
+                matched = true;
+                break;
+        }
+    }
+    return matched;
+}
+
+/*
+ * Gets the start state, each automaton is always entered at the same program counter.
+ */
+static uint32_t Dfa_start(TextRegex *const regex, struct Dfa *const self, const uint32_t entry, const bool atBegin) {
+    if (DFA_UNKNOWN != self->starts[atBegin]) {
+        return self->starts[atBegin];
+    }
+    size_t size = 0;
+    regex->visited.size = 0;
+    const bool matched = Dfa_closure(regex, self, entry, atBegin, false, &size);
+    const size_t stride = regex->classesSize;
+    const uint32_t row = (uint32_t) (Dfa_insert(self, stride, regex->threads, size, atBegin ? DFA_BEGIN : 0) * stride);
+    self->starts[atBegin] = matched ? row | DFA_MATCH : row;
+    return self->starts[atBegin];
+}
+
+/*
+ * Computes the transition of the state at row on the byte class, flagged with DFA_MATCH if the target reached a match.
+ * The last class stands for the end of the text: only the threads waiting on it survive.
+ */
+static uint32_t Dfa_next(TextRegex *const regex, struct Dfa *const self, const uint32_t row, const size_t class) {
+    const size_t stride = regex->classesSize, generation = self->generation;
+    if (DFA_UNKNOWN != self->transitions[row + class]) {
+        return self->transitions[row + class];
+    }
+
+    const struct Instruction *const instructions = self->program->instructions;
+    const struct DfaState from = self->states[row / stride];
+    const bool atEnd = class + 1 == stride;
+    const unsigned char c = regex->representatives[atEnd ? 0 : class];
+    size_t size = 0;
+    bool matched = false;
+    regex->visited.size = 0;
+    for (size_t i = 0; i < from.size; i++) {
+        const struct Instruction *const instruction = &instructions[self->pool[from.threads + i]];
+        bool reached = false;
+        if (atEnd) {
+            if (OP_END == instruction->opcode) {
+                reached = Dfa_closure(regex, self, instruction->next, from.flags & DFA_BEGIN, true, &size);
+            }
+        } else if (OP_SET == instruction->opcode && ByteSet_contains(&regex->sets[instruction->arg], c)) {
+            reached = Dfa_closure(regex, self, instruction->next, false, false, &size);
+        }
+        if (reached) {
+            matched = true;
+            if (!self->longest) {
+                break;
+            }
+        }
+    }
+
+    uint32_t target = (uint32_t) (Dfa_insert(self, stride, regex->threads, size, 0) * stride);
+    target = matched ? target | DFA_MATCH : target;
+    if (generation == self->generation) {
+        self->transitions[row + class] = target;
+    }
+    return target;
+}
+
+/*
+ * Gets the end of the leftmost-first match starting at or after offset.
+ */
+static bool TextRegex_searchEnd(TextRegex *const self, const char *const text, const size_t length,
+                                const size_t offset, size_t *const end) {
+    struct Dfa *const dfa = &self->search;
+    if (self->anchored && offset > 0) {
+        return false;
+    }
+    const uint32_t entry = self->anchored ? self->anchoredEntry : self->unanchoredEntry;
+    const size_t stride = self->classesSize;
+    const bool prefiltered = self->prefixSize > 0 && !self->anchored;
+    size_t generation = dfa->generation;
+    uint32_t restart = prefiltered ? Dfa_start(self, dfa, entry, false) & DFA_ROW : DFA_DEAD;
+    uint32_t state = Dfa_start(self, dfa, entry, 0 == offset);
+    if (generation != dfa->generation) {
+        generation = dfa->generation;
+        restart = prefiltered ? Dfa_start(self, dfa, entry, false) & DFA_ROW : DFA_DEAD;
+    }
+
+    const unsigned char *const classes = self->classes;
+    const uint32_t *transitions = dfa->transitions;
+    bool found = false;
+    if (state & DFA_MATCH) {
+        found = true;
+        *end = offset;
+        state &= DFA_ROW;
+    }
+    if (DFA_DEAD == state) {
+        return found;
+    }
+    for (size_t i = offset; i < length;) {
+        if (state == restart) {
+            // no thread is alive but the one looking for the start of a match: skip to the next candidate
+            const char *candidate = TextSimd_find(text + i, text + length, self->prefix, self->prefixSize);
+            if (NULL == candidate) {
+                return found;
+            }
+            i = (size_t) (candidate - text);
+        }
+        const size_t class = classes[(unsigned char) text[i]];
+        uint32_t next = transitions[state + class];
+        if (DFA_UNKNOWN == next) {
+            next = Dfa_next(self, dfa, state, class);
+            transitions = dfa->transitions;
+            if (generation != dfa->generation) {
+                generation = dfa->generation;
+                restart = prefiltered ? Dfa_start(self, dfa, entry, false) & DFA_ROW : DFA_DEAD;
+            }
+        }
+        i++;
+        state = next & DFA_ROW;
+        if (next & DFA_MATCH) {
+            found = true;
+            *end = i;
+        }
+        if (DFA_DEAD == state) {
+            return found;
+        }
+    }
+    if (Dfa_next(self, dfa, state, stride - 1) & DFA_MATCH) {
+        found = true;
+        *end = length;
+    }
+    return found;
+}
+
+/*
+ * Gets the start of the leftmost match ending at end, running the reversed program backward.
+ */
+static size_t TextRegex_searchStart(TextRegex *const self, const char *const text, const size_t length,
+                                    const size_t offset, const size_t end) {
+    struct Dfa *const dfa = &self->reverse;
+    const size_t stride = self->classesSize;
+    uint32_t state = Dfa_start(self, dfa, 0, end == length);
+    size_t start = (state & DFA_MATCH) ? end : NONE;
+    size_t i = end;
+    for (state &= DFA_ROW; i > offset && DFA_DEAD != state; i--) {
+        const uint32_t next = Dfa_next(self, dfa, state, self->classes[(unsigned char) text[i - 1]]);
+        state = next & DFA_ROW;
+        if (next & DFA_MATCH) {
+            start = i - 1;
+        }
+    }
+    if (0 == i && DFA_DEAD != state && (Dfa_next(self, dfa, state, stride - 1) & DFA_MATCH)) {
+        start = 0;
+    }
+    assert(NONE != start);
+    return start;
+}
+
+/*
+ * Pike VM: simulates the program in lockstep keeping the captures of each thread, used only on the span of a match.
+ */
+
+struct PikeFrame {
+    uint32_t pc;
+    uint32_t slot;      // UINT32_MAX for frames visiting pc, otherwise the slot to restore
+    size_t value;
+};
+
+static void TextRegex_addThread(TextRegex *const self, uint32_t *const threads, size_t *const size,
+                                size_t *const slots, size_t *const captures, const uint32_t pc, const size_t position,
+                                const size_t length) {
+    const struct Instruction *const instructions = self->forward.instructions;
+    const size_t slotsSize = 2 * (self->groups + 1);
+    struct PikeFrame *const frames = self->frames;
+    size_t top = 0;
+    frames[top++] = (struct PikeFrame) {.pc = pc, .slot = UINT32_MAX};
+    while (top > 0) {
+        const struct PikeFrame frame = frames[--top];
+        if (UINT32_MAX != frame.slot) {
+            captures[frame.slot] = frame.value;
+            continue;
+        }
+        if (!SparseSet_insert(&self->visited, frame.pc)) {
+            continue;
+        }
+        const struct Instruction *const instruction = &instructions[frame.pc];
+        switch (instruction->opcode) {
+            case OP_SPLIT:
+                frames[top++] = (struct PikeFrame) {.pc = instruction->alt, .slot = UINT32_MAX};
+                frames[top++] = (struct PikeFrame) {.pc = instruction->next, .slot = UINT32_MAX};
+                break;
+            case OP_JUMP:
+                frames[top++] = (struct PikeFrame) {.pc = instruction->next, .slot = UINT32_MAX};
+                break;
+            case OP_SAVE:
+                frames[top++] = (struct PikeFrame) {.slot = instruction->arg, .value = captures[instruction->arg]};
+                frames[top++] = (struct PikeFrame) {.pc = instruction->next, .slot = UINT32_MAX};
+                captures[instruction->arg] = position;
+                break;
+            case OP_BEGIN:
+                if (0 == position) {
+                    frames[top++] = (struct PikeFrame) {.pc = instruction->next, .slot = UINT32_MAX};
+                }
+                break;
+            case OP_END:
+                if (length == position) {
+                    frames[top++] = (struct PikeFrame) {.pc = instruction->next, .slot = UINT32_MAX};
+                }
+                break;
+            default:
+                threads[*size] = frame.pc;
+                memcpy(slots + *size * slotsSize, captures, slotsSize * sizeof(captures[0]));
+                (*size)++;
+                break;
+        }
+    }
+}
+
+/*
+ * Fills captures with the groups of the leftmost-first match spanning [start, end).
+ */
+static void TextRegex_pike(TextRegex *const self, const char *const text, const size_t length,
+                           const size_t start, const size_t end, size_t *const captures) {
+    const size_t slotsSize = 2 * (self->groups + 1), capacity = self->forward.size;
+    if (NULL == self->slots) {
+        self->slots = Option_unwrap(Alligator_malloc(2 * capacity * slotsSize * sizeof(self->slots[0])));
+        self->pikeThreads = Option_unwrap(Alligator_malloc(2 * capacity * sizeof(self->pikeThreads[0])));
+        self->frames = Option_unwrap(Alligator_malloc((2 * capacity + 1) * sizeof(self->frames[0])));
+    }
+    const struct Instruction *const instructions = self->forward.instructions;
+    uint32_t *current = self->pikeThreads, *next = self->pikeThreads + capacity;
+    size_t *currentSlots = self->slots, *nextSlots = self->slots + capacity * slotsSize;
+    size_t *const scratch = Option_unwrap(Alligator_malloc(slotsSize * sizeof(scratch[0])));
+    size_t currentSize = 0;
+
+    for (size_t i = 0; i < slotsSize; i++) {
+        scratch[i] = NONE;
+    }
+    self->visited.size = 0;
+    TextRegex_addThread(self, current, &currentSize, currentSlots, scratch, self->anchoredEntry, start, length);
+    for (size_t position = start; currentSize > 0; position++) {
+        size_t nextSize = 0;
+        self->visited.size = 0;
+        for (size_t i = 0; i < currentSize; i++) {
+            const struct Instruction *const instruction = &instructions[current[i]];
+            if (OP_MATCH == instruction->opcode) {
+                memcpy(captures, currentSlots + i * slotsSize, slotsSize * sizeof(captures[0]));
+                break;  // lower priority threads are cut
+            }
+            if (position < end &&
+                ByteSet_contains(&self->sets[instruction->arg], (unsigned char) text[position])) {
+                memcpy(scratch, currentSlots + i * slotsSize, slotsSize * sizeof(scratch[0]));
+                TextRegex_addThread(self, next, &nextSize, nextSlots, scratch, instruction->next, position + 1, length);
+            }
+        }
+        uint32_t *const threads = current;
+        size_t *const slots = currentSlots;
+        current = next, currentSlots = nextSlots, currentSize = nextSize;
+        next = threads, nextSlots = slots;
+    }
+    Alligator_free(scratch);
+}
+
+/*
+ * Appends the literal bytes every match starts with, returns true if the whole node was appended.
+ */
+static bool literalPrefix(const struct Node *const nodes, const struct ByteSet *const sets, const size_t index,
+                          char *const prefix, size_t *const size) {
+    const struct Node *const node = &nodes[index];
+    switch (node->kind) {
+        case NODE_EMPTY:
+            return true;
+        case NODE_SET: {
+            const int c = ByteSet_single(&sets[node->value]);
+            if (c < 0 || *size >= PREFIX_LIMIT) {
+                return false;
+            }
+            prefix[(*size)++] = (char) c;
+            return true;
+        }
+        case NODE_GROUP:
+            return literalPrefix(nodes, sets, node->child, prefix, size);
+        case NODE_CONCAT:
+            for (size_t child = node->child; NONE != child; child = nodes[child].sibling) {
+                if (!literalPrefix(nodes, sets, child, prefix, size)) {
+                    return false;
+                }
+            }
+            return true;
+        case NODE_REPEAT:
+            if (node->min > 0) {
+                literalPrefix(nodes, sets, node->child, prefix, size);
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+static bool startsWithBegin(const struct Node *const nodes, const size_t index) {
+    const struct Node *const node = &nodes[index];
+    switch (node->kind) {
+        case NODE_BEGIN:
+            return true;
+        case NODE_GROUP:
+        case NODE_CONCAT:
+            return startsWithBegin(nodes, node->child);
+        default:
+            return false;
+    }
+}
+
+/*
+ * Splits the bytes into classes such that no set of the program tells apart two bytes of the same class.
+ */
+static void TextRegex_classify(TextRegex *const self, const size_t setsSize) {
+    bool boundaries[256] = {false};
+    for (size_t i = 0; i < setsSize; i++) {
+        for (unsigned c = 1; c < 256; c++) {
+            if (ByteSet_contains(&self->sets[i], (unsigned char) c) !=
+                ByteSet_contains(&self->sets[i], (unsigned char) (c - 1))) {
+                boundaries[c] = true;
+            }
+        }
+    }
+    size_t class = 0;
+    self->representatives[0] = 0;
+    for (unsigned c = 0; c < 256; c++) {
+        if (boundaries[c]) {
+            self->representatives[++class] = (unsigned char) c;
+        }
+        self->classes[c] = (unsigned char) class;
+    }
+    self->classesSize = class + 2;
+}
+
+TextRegex *TextRegex_new(const TextView pattern, size_t *const invalidOffset) {
+    assert(pattern);
+    assert(invalidOffset);
+    struct Parser parser = {
+            .pattern = pattern, .length = Text_length(pattern), .cursor = 0, .depth = 0, .groups = 0, .error = NONE,
+            .nodes = NULL, .nodesSize = 0, .nodesCapacity = 0, .sets = NULL, .setsSize = 0, .setsCapacity = 0,
+    };
+    const size_t root = Parser_alternation(&parser);
+    if (NONE != root && parser.cursor < parser.length) {
+        Parser_fail(&parser, parser.cursor);    // unbalanced parenthesis
+    }
+
+    TextRegex *self = Option_unwrap(Alligator_calloc(1, sizeof(*self)));
+    self->sets = parser.sets;
+    self->groups = parser.groups;
+    if (NONE == parser.error) {
+        // forward: 0 split 2, 1 | 1 any byte | 2 save 0 | ... | save 1 | match
+        struct Compiler compiler = {.nodes = parser.nodes, .program = &self->forward, .reverse = false, .error = NONE};
+        struct ByteSet any;
+        memset(&any, 0xFF, sizeof(any));
+        const size_t anySet = parser.setsSize++;
+        if (parser.setsSize > parser.setsCapacity) {
+            self->sets = Option_unwrap(Alligator_realloc(self->sets, parser.setsSize * sizeof(self->sets[0])));
+        }
+        self->sets[anySet] = any;
+        self->unanchoredEntry = Compiler_emit(&compiler, OP_SPLIT, 0, 0);
+        Compiler_emit(&compiler, OP_SET, anySet, 0);
+        self->forward.instructions[0].next = 2;
+        self->forward.instructions[1].next = 0;
+        self->anchoredEntry = Compiler_emit(&compiler, OP_SAVE, 0, 0);
+        Compiler_node(&compiler, root);
+        Compiler_emit(&compiler, OP_SAVE, 1, 0);
+        Compiler_emit(&compiler, OP_MATCH, 0, 0);
+
+        compiler.program = &self->backward;
+        compiler.reverse = true;
+        Compiler_node(&compiler, root);
+        Compiler_emit(&compiler, OP_MATCH, 0, 0);
+        parser.error = compiler.error;
+
+        TextRegex_classify(self, parser.setsSize);
+        self->anchored = startsWithBegin(parser.nodes, root);
+        literalPrefix(parser.nodes, self->sets, root, self->prefix, &self->prefixSize);
+    }
+    Alligator_free(parser.nodes);
+    *invalidOffset = parser.error;
+    if (NONE != parser.error) {
+        TextRegex_delete(self);
+        return NULL;
+    }
+
+    const size_t capacity = self->forward.size > self->backward.size ? self->forward.size : self->backward.size;
+    self->visited.dense = Option_unwrap(Alligator_malloc(capacity * sizeof(self->visited.dense[0])));
+    self->visited.sparse = Option_unwrap(Alligator_calloc(capacity, sizeof(self->visited.sparse[0])));
+    self->stack = Option_unwrap(Alligator_malloc((2 * capacity + 1) * sizeof(self->stack[0])));
+    self->threads = Option_unwrap(Alligator_malloc(capacity * sizeof(self->threads[0])));
+    Dfa_init(&self->search, &self->forward, false, self->classesSize);
+    Dfa_init(&self->full, &self->forward, true, self->classesSize);
+    Dfa_init(&self->reverse, &self->backward, true, self->classesSize);
+    return self;
+}
+
+size_t TextRegex_groupCount(const TextRegex *const self) {
+    assert(self);
+    return self->groups;
+}
+
+bool TextRegex_match(TextRegex *const self, const TextView text) {
+    assert(self);
+    assert(text);
+    struct Dfa *const dfa = &self->full;
+    const size_t length = Text_length(text);
+    uint32_t state = Dfa_start(self, dfa, self->anchoredEntry, true);
+    bool matched = 0 != (state & DFA_MATCH);
+    for (size_t i = 0; i < length; i++) {
+        state = Dfa_next(self, dfa, state & DFA_ROW, self->classes[(unsigned char) text[i]]);
+        matched = 0 != (state & DFA_MATCH);
+        if (DFA_DEAD == (state & DFA_ROW)) {
+            return matched && i + 1 == length;
+        }
+    }
+    return matched || 0 != (Dfa_next(self, dfa, state & DFA_ROW, self->classesSize - 1) & DFA_MATCH);
+}
+
+bool TextRegex_search(TextRegex *const self, const TextView text, const size_t offset, TextSlice *const match) {
+    assert(self);
+    assert(text);
+    assert(match);
+    const size_t length = Text_length(text);
+    size_t end;
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+    if (!TextRegex_searchEnd(self, text, length, offset, &end)) {
+        return false;
+    }
+    const size_t start = TextRegex_searchStart(self, text, length, offset, end);
+    match->bytes = text + start;
+    match->size = end - start;
+    return true;
+}
+
+bool TextRegex_captures(TextRegex *const self, const TextView text, const size_t offset, TextSlice *const groups,
+                        const size_t count) {
+    assert(self);
+    assert(text);
+    assert(groups);
+    assert(count > 0);
+    TextSlice match;
+    if (!TextRegex_search(self, text, offset, &match)) {
+        return false;
+    }
+    const size_t start = (size_t) (match.bytes - text), slotsSize = 2 * (self->groups + 1);
+    size_t *const captures = Option_unwrap(Alligator_malloc(slotsSize * sizeof(captures[0])));
+    TextRegex_pike(self, text, Text_length(text), start, start + match.size, captures);
+    for (size_t i = 0; i < count; i++) {
+        if (i <= self->groups && NONE != captures[2 * i] && NONE != captures[2 * i + 1]) {
+            groups[i] = (TextSlice) {.bytes = text + captures[2 * i], .size = captures[2 * i + 1] - captures[2 * i]};
+        } else {
+            groups[i] = (TextSlice) {.bytes = NULL, .size = 0};
+        }
+    }
+    Alligator_free(captures);
+    return true;
+}
+
+TextRegexIterator TextRegex_findAll(TextRegex *const self, const TextView text, const size_t offset) {
+    assert(self);
+    assert(text);
+    if (offset > Text_length(text)) {
+        Panic_terminate("Out of range");
+    }
+    return (TextRegexIterator) {.regex = self, .text = text, .offset = offset, .done = false};
+}
+
+bool TextRegexIterator_next(TextRegexIterator *const self, TextSlice *const match) {
+    assert(self);
+    assert(match);
+    if (self->done || !TextRegex_search(self->regex, self->text, self->offset, match)) {
+        self->done = true;
+        return false;
+    }
+    self->offset = (size_t) (match->bytes - self->text) + match->size + (0 == match->size);
+    self->done = self->offset > Text_length(self->text);
+    return true;
+}
+
+void TextRegex_delete(TextRegex *const self) {
+    if (self) {
+        Dfa_destroy(&self->search);
+        Dfa_destroy(&self->full);
+        Dfa_destroy(&self->reverse);
+        Alligator_free(self->forward.instructions);
+        Alligator_free(self->backward.instructions);
+        Alligator_free(self->sets);
+        Alligator_free(self->visited.dense);
+        Alligator_free(self->visited.sparse);
+        Alligator_free(self->stack);
+        Alligator_free(self->threads);
+        Alligator_free(self->slots);
+        Alligator_free(self->pikeThreads);
+        Alligator_free(self->frames);
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,190 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdbool.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Regular expressions over texts.
+ * Patterns are compiled to a Thompson NFA which is simulated by a DFA built lazily while scanning, every search runs
+ * in time linear in the size of the text. Matches follow the leftmost-first (Perl) semantics and work on bytes.
+ * Like in Go and RE2, a star whose body can match empty stops after an empty iteration: ()* captures an empty group.
+ *
+ * The supported syntax is:
+ *  - literals and escapes: \\ \. \n \r \t \f \v \0 \xHH and any escaped punctuation.
+ *  - classes: . (any byte but \n) [abc] [^abc] [a-z] \d \D \w \W \s \S, the latter also inside brackets.
+ *  - groups: (capturing) (?:non capturing) and alternations a|b.
+ *  - repetitions: * + ? {n} {n,} {n,m}, lazy if followed by ?.
+ *  - anchors: ^ and $ at the start and at the end of the text.
+ *
+ * @attention Every function in this module terminates the program in case of out of memory.
+ * @attention A regex caches the states of its automata, it must not be used by many threads at once.
+ */
+
+/**
+ * A compiled regular expression.
+ * The literal prefix shared by all the matches, if any, is searched with SIMD before running the automaton.
+ */
+typedef struct TextRegex TextRegex;
+
+/**
+ * Iterates over the non overlapping matches of a regex.
+ * This struct must be treated as opaque, its members must not be accessed directly.
+ */
+typedef struct TextRegexIterator {
+    TextRegex *regex;
+    TextView text;
+    size_t offset;
+    bool done;
+} TextRegexIterator;
+
+/**
+ * Compiles a pattern into a new regex.
+ *
+ * @attention pattern must not be NULL.
+ * @attention invalidOffset must not be NULL.
+ *
+ * @param pattern The pattern to compile.
+ * @param invalidOffset Set to the offset of the construct preventing the compilation, SIZE_MAX on success.
+ * @return a new regex instance or NULL if the pattern is malformed or too large.
+ */
+extern TextRegex *TextRegex_new(TextView pattern, size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the number of capturing groups of the regex.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The regex instance.
+ * @return the number of capturing groups, the whole match excluded.
+ */
+extern size_t TextRegex_groupCount(const TextRegex *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Checks if the regex matches the whole text.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ *
+ * @param self The regex instance.
+ * @param text The text instance.
+ * @return true if the whole text matches, false otherwise.
+ */
+extern bool TextRegex_match(TextRegex *self, TextView text)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Searches the first match starting at or after offset.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention match must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The regex instance.
+ * @param text The text instance.
+ * @param offset The byte offset where the search starts.
+ * @param match The matched slice of the text, set only if found.
+ * @return true if a match was found, false otherwise.
+ */
+extern bool TextRegex_search(TextRegex *self, TextView text, size_t offset, TextSlice *match)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Searches the first match starting at or after offset and extracts its capturing groups.
+ * groups[0] is the whole match, groups[i] the i-th capturing group or {NULL, 0} if it did not participate.
+ * Entries past the number of groups are set to {NULL, 0}.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention groups must not be NULL.
+ * @attention count must be greater than 0.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The regex instance.
+ * @param text The text instance.
+ * @param offset The byte offset where the search starts.
+ * @param groups The slices to be filled, set only if found.
+ * @param count The number of slices.
+ * @return true if a match was found, false otherwise.
+ */
+extern bool TextRegex_captures(TextRegex *self, TextView text, size_t offset, TextSlice *groups, size_t count)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over the non overlapping matches starting at or after offset.
+ * After an empty match the search is resumed one byte further.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The regex instance, it must outlive the iterator.
+ * @param text The text instance.
+ * @param offset The byte offset where the search starts.
+ * @return a new iterator, the text must outlive it and must not be modified meanwhile.
+ */
+extern TextRegexIterator TextRegex_findAll(TextRegex *self, TextView text, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the next match.
+ *
+ * @attention self must not be NULL.
+ * @attention match must not be NULL.
+ *
+ * @param self The iterator instance.
+ * @param match The matched slice of the text, set only if found.
+ * @return true if a match was found, false when the text is over.
+ */
+extern bool TextRegexIterator_next(TextRegexIterator *self, TextSlice *match)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a regex.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextRegex_delete(TextRegex *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,403 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*
+ * Private scanning primitives shared by the text sources.
+ * Every routine has a portable scalar path, the SSE2 path is used whenever the target supports it.
+ */
+
+#pragma once
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdbool.h>
+#include "text.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define TEXT_SIMD_SSE2  1
+#endif
+
+static inline bool TextSimd_byteSetContains(const struct Text_ByteSet *const set, const unsigned char c) {
+    return 0 != (set->bitmap[c >> 5] & (UINT32_C(1) << (c & 31)));
+}
+
+static inline void TextSimd_byteSetInit(struct Text_ByteSet *const set, const void *const bytes, const size_t size) {
+    assert(set);
+    assert(bytes);
+    const unsigned char *data = bytes;
+    memset(set, 0, sizeof(*set));
+    for (size_t i = 0; i < size; i++) {
+        const unsigned char c = data[i];
+        if (!TextSimd_byteSetContains(set, c)) {
+            set->bitmap[c >> 5] |= UINT32_C(1) << (c & 31);
+            if (set->size < TEXT_BYTE_SET_SMALL) {
+                set->bytes[set->size] = c;
+            }
+            set->size += 1;
+        }
+    }
+}
+
+static inline unsigned TextSimd_countTrailingZeros(const uint32_t mask) {
+    assert(mask);
+    return (unsigned) __builtin_ctz(mask);
+}
+
+static inline unsigned TextSimd_highestBit(const uint32_t mask) {
+    assert(mask);
+    return 31U - (unsigned) __builtin_clz(mask);
+}
+
+static inline unsigned char TextSimd_foldAscii(const unsigned char c) {
+    return (unsigned char) ((unsigned) (c - 'A') < 26U ? c | 0x20U : c);
+}
+
+static inline int TextSimd_hexValue(const unsigned char c) {
+    if ((unsigned) (c - '0') < 10U) {
+        return c - '0';
+    }
+    const unsigned char folded = (unsigned char) (c | 0x20U);
+    return (unsigned) (folded - 'a') < 6U ? folded - 'a' + 10 : -1;
+}
+
+#ifdef TEXT_SIMD_SSE2
+
+/*
+ * Maps the ASCII upper case letters of the block to lower case, every other byte is left untouched.
+ */
+static inline __m128i TextSimd_foldAsciiBlock(const __m128i block) {
+    // moves 'A' to -128 so that a single signed comparison selects the range ['A', 'Z']
+    const __m128i shifted = _mm_add_epi8(block, _mm_set1_epi8((char) (0x80 - 'A')));
+    const __m128i upper = _mm_cmplt_epi8(shifted, _mm_set1_epi8((char) (-128 + 26)));
+    return _mm_or_si128(block, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+static inline uint32_t TextSimd_matchSmallSet(const __m128i block, const struct Text_ByteSet *const set) {
+    __m128i hits = _mm_setzero_si128();
+    for (size_t i = 0; i < set->size; i++) {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8((char) set->bytes[i])));
+    }
+    return (uint32_t) _mm_movemask_epi8(hits);
+}
+
+#endif
+
+/*
+ * Returns a mask having the i-th bit set if bytes[i] equals c, for each i in [0, 64).
+ */
+static inline uint64_t TextSimd_matchMask64(const char *const bytes, const char c) {
+    assert(bytes);
+#ifdef TEXT_SIMD_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    const uint64_t m0 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) bytes), needle));
+    const uint64_t m1 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (bytes + 16)), needle));
+    const uint64_t m2 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (bytes + 32)), needle));
+    const uint64_t m3 = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *) (bytes + 48)), needle));
+    return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+#else
+    uint64_t mask = 0;
+    for (unsigned i = 0; i < 64; i++) {
+        mask |= (uint64_t) (bytes[i] == c) << i;
+    }
+    return mask;
+#endif
+}
+
+/*
+ * Finds the first occurrence of c in [begin, end), returns NULL if not found.
+ */
+static inline const char *TextSimd_findByte(const char *const begin, const char *const end, const char c) {
+    assert(begin <= end);
+    return memchr(begin, c, (size_t) (end - begin));
+}
+
+/*
+ * Finds the last occurrence of c in [begin, end), returns NULL if not found.
+ */
+static inline const char *TextSimd_findLastByte(const char *const begin, const char *end, const char c) {
+    assert(begin <= end);
+#ifdef TEXT_SIMD_SSE2
+    const __m128i needle = _mm_set1_epi8(c);
+    while (end - begin >= 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) (end - 16));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(block, needle));
+        if (mask) {
+            return end - 16 + TextSimd_highestBit(mask);
+        }
+        end -= 16;
+    }
+#endif
+    while (begin < end) {
+        if (*--end == c) {
+            return end;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Finds the first byte in [begin, end) belonging to set, returns NULL if not found.
+ */
+static inline const char *TextSimd_findFirstOf(const char *begin, const char *const end,
+                                               const struct Text_ByteSet *const set) {
+    assert(begin <= end);
+    assert(set);
+#ifdef TEXT_SIMD_SSE2
+    if (set->size <= TEXT_BYTE_SET_SMALL) {
+        while (end - begin >= 16) {
+            const uint32_t mask = TextSimd_matchSmallSet(_mm_loadu_si128((const __m128i *) begin), set);
+            if (mask) {
+                return begin + TextSimd_countTrailingZeros(mask);
+            }
+            begin += 16;
+        }
+    }
+#endif
+    for (; begin < end; begin++) {
+        if (TextSimd_byteSetContains(set, (unsigned char) *begin)) {
+            return begin;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Finds the last byte in [begin, end) belonging to set, returns NULL if not found.
+ */
+static inline const char *TextSimd_findLastOf(const char *const begin, const char *end,
+                                              const struct Text_ByteSet *const set) {
+    assert(begin <= end);
+    assert(set);
+#ifdef TEXT_SIMD_SSE2
+    if (set->size <= TEXT_BYTE_SET_SMALL) {
+        while (end - begin >= 16) {
+            const uint32_t mask = TextSimd_matchSmallSet(_mm_loadu_si128((const __m128i *) (end - 16)), set);
+            if (mask) {
+                return end - 16 + TextSimd_highestBit(mask);
+            }
+            end -= 16;
+        }
+    }
+#endif
+    while (begin < end) {
+        if (TextSimd_byteSetContains(set, (unsigned char) *--end)) {
+            return end;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Finds the first occurrence of needle in [begin, end), returns NULL if not found.
+ * The SSE2 path filters candidates comparing both the first and the last byte of the needle 16 positions at once.
+ */
+static inline const char *TextSimd_find(const char *begin, const char *const end,
+                                        const char *const needle, const size_t size) {
+    assert(begin <= end);
+    assert(needle);
+    assert(size > 0);
+    if (size == 1) {
+        return TextSimd_findByte(begin, end, needle[0]);
+    }
+    if ((size_t) (end - begin) < size) {
+        return NULL;
+    }
+    const char *const last = end - size;  // last valid starting position
+#ifdef TEXT_SIMD_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]), final = _mm_set1_epi8(needle[size - 1]);
+    while (last - begin >= 15) {
+        const __m128i blockFirst = _mm_loadu_si128((const __m128i *) begin);
+        const __m128i blockFinal = _mm_loadu_si128((const __m128i *) (begin + size - 1));
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockFinal, final))
+        );
+        while (mask) {
+            const char *candidate = begin + TextSimd_countTrailingZeros(mask);
+            if (0 == memcmp(candidate + 1, needle + 1, size - 2)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+        begin += 16;
+    }
+#endif
+    for (; begin <= last; begin++) {
+        if (*begin == needle[0] && begin[size - 1] == needle[size - 1] && 0 == memcmp(begin, needle, size)) {
+            return begin;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Finds the last occurrence of needle in [begin, end), returns NULL if not found.
+ */
+static inline const char *TextSimd_findLast(const char *const begin, const char *const end,
+                                            const char *const needle, const size_t size) {
+    assert(begin <= end);
+    assert(needle);
+    assert(size > 0);
+    if (size == 1) {
+        return TextSimd_findLastByte(begin, end, needle[0]);
+    }
+    if ((size_t) (end - begin) < size) {
+        return NULL;
+    }
+    const char *cursor = end - size + 1;    // one past the last valid starting position
+#ifdef TEXT_SIMD_SSE2
+    const __m128i first = _mm_set1_epi8(needle[0]), final = _mm_set1_epi8(needle[size - 1]);
+    while (cursor - begin >= 16) {
+        const char *const window = cursor - 16;
+        const __m128i blockFirst = _mm_loadu_si128((const __m128i *) window);
+        const __m128i blockFinal = _mm_loadu_si128((const __m128i *) (window + size - 1));
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockFinal, final))
+        );
+        while (mask) {
+            const unsigned bit = TextSimd_highestBit(mask);
+            if (0 == memcmp(window + bit + 1, needle + 1, size - 2)) {
+                return window + bit;
+            }
+            mask &= ~(UINT32_C(1) << bit);
+        }
+        cursor = window;
+    }
+#endif
+    while (begin < cursor) {
+        cursor--;
+        if (*cursor == needle[0] && cursor[size - 1] == needle[size - 1] && 0 == memcmp(cursor, needle, size)) {
+            return cursor;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Returns the index of the first byte differing between a and b, size if none does.
+ */
+static inline size_t TextSimd_mismatch(const char *const a, const char *const b, const size_t size) {
+    assert(a);
+    assert(b);
+    size_t i = 0;
+#ifdef TEXT_SIMD_SSE2
+    for (; size - i >= 32; i += 32) {
+        const __m128i x0 = _mm_loadu_si128((const __m128i *) (a + i));
+        const __m128i x1 = _mm_loadu_si128((const __m128i *) (a + i + 16));
+        const __m128i y0 = _mm_loadu_si128((const __m128i *) (b + i));
+        const __m128i y1 = _mm_loadu_si128((const __m128i *) (b + i + 16));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x0, y0)) |
+                              (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x1, y1)) << 16;
+        if (UINT32_MAX != mask) {
+            return i + TextSimd_countTrailingZeros(~mask);
+        }
+    }
+    if (size - i >= 16) {
+        const __m128i x = _mm_loadu_si128((const __m128i *) (a + i)), y = _mm_loadu_si128((const __m128i *) (b + i));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFU;
+        if (mask) {
+            return i + TextSimd_countTrailingZeros(mask);
+        }
+        i += 16;
+    }
+#endif
+    for (; i < size; i++) {
+        if (a[i] != b[i]) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/*
+ * Returns the index of the first byte differing between a and b after ASCII case folding, size if none does.
+ */
+static inline size_t TextSimd_mismatchIgnoreCase(const char *const a, const char *const b, const size_t size) {
+    assert(a);
+    assert(b);
+    size_t i = 0;
+#ifdef TEXT_SIMD_SSE2
+    for (; size - i >= 16; i += 16) {
+        const __m128i x = TextSimd_foldAsciiBlock(_mm_loadu_si128((const __m128i *) (a + i)));
+        const __m128i y = TextSimd_foldAsciiBlock(_mm_loadu_si128((const __m128i *) (b + i)));
+        const uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFU;
+        if (mask) {
+            return i + TextSimd_countTrailingZeros(mask);
+        }
+    }
+#endif
+    for (; i < size; i++) {
+        if (TextSimd_foldAscii((unsigned char) a[i]) != TextSimd_foldAscii((unsigned char) b[i])) {
+            return i;
+        }
+    }
+    return size;
+}
+
+/*
+ * Finds the first occurrence of needle in [begin, end) ignoring ASCII case, returns NULL if not found.
+ */
+static inline const char *TextSimd_findIgnoreCase(const char *begin, const char *const end,
+                                                  const char *const needle, const size_t size) {
+    assert(begin <= end);
+    assert(needle);
+    assert(size > 0);
+    if ((size_t) (end - begin) < size) {
+        return NULL;
+    }
+    const char *const last = end - size;  // last valid starting position
+    const unsigned char head = TextSimd_foldAscii((unsigned char) needle[0]);
+    const unsigned char tail = TextSimd_foldAscii((unsigned char) needle[size - 1]);
+#ifdef TEXT_SIMD_SSE2
+    const __m128i first = _mm_set1_epi8((char) head), final = _mm_set1_epi8((char) tail);
+    while (last - begin >= 15) {
+        const __m128i blockFirst = TextSimd_foldAsciiBlock(_mm_loadu_si128((const __m128i *) begin));
+        const __m128i blockFinal = TextSimd_foldAsciiBlock(_mm_loadu_si128((const __m128i *) (begin + size - 1)));
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockFinal, final))
+        );
+        while (mask) {
+            const char *candidate = begin + TextSimd_countTrailingZeros(mask);
+            if (size < 3 || size - 2 == TextSimd_mismatchIgnoreCase(candidate + 1, needle + 1, size - 2)) {
+                return candidate;
+            }
+            mask &= mask - 1;
+        }
+        begin += 16;
+    }
+#endif
+    for (; begin <= last; begin++) {
+        if (TextSimd_foldAscii((unsigned char) *begin) == head &&
+            TextSimd_foldAscii((unsigned char) begin[size - 1]) == tail &&
+            size == TextSimd_mismatchIgnoreCase(begin, needle, size)) {
+            return begin;
+        }
+    }
+    return NULL;
+}
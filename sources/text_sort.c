@@ -0,0 +1,316 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_sort.h"
+#include "text_config.h"
+#include "text_simd.h"
+
+#if TEXT_SORT_PARALLEL_GRAIN < 1UL
+    #error
+#endif
+
+#define KEY_BYTES       7U      // bytes of text cached in the upper part of each key
+#define SMALL_RANGE     16U     // ranges up to this size are insertion sorted
+#define STACK_SIZE      128U    // see sortTask
+
+/*
+ * The key holds the KEY_BYTES bytes following depth in its upper bytes, zero padded, and how many of them belong to
+ * the text in its lowest byte: comparing keys as integers orders texts by those bytes, shorter texts first on ties.
+ */
+struct Entry {
+    uint64_t key;
+    Text text;
+};
+
+struct Task {
+    size_t begin;
+    size_t end;
+    size_t depth;
+    bool stale;     // keys still refer to the previous depth
+};
+
+static uint64_t makeKey(const TextView text, const size_t depth) {
+    const size_t remaining = Text_length(text) - depth;
+    const unsigned char *const bytes = (const unsigned char *) text + depth;
+    if (remaining >= KEY_BYTES) {
+        uint64_t word;  // the terminator makes the 8th byte always readable
+        memcpy(&word, bytes, sizeof(word));
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return (word & ~UINT64_C(0xFF)) | KEY_BYTES;
+    }
+    uint64_t key = 0;
+    for (size_t i = 0; i < KEY_BYTES; i++) {
+        key = (key << 8) | (i < remaining ? bytes[i] : 0);
+    }
+    return (key << 8) | remaining;
+}
+
+static bool isExhausted(const uint64_t key) {
+    return (key & 0xFF) < KEY_BYTES;
+}
+
+static void refreshKeys(struct Entry *const entries, const struct Task *const task) {
+    for (size_t i = task->begin; i < task->end; i++) {
+        entries[i].key = makeKey(entries[i].text, task->depth);
+    }
+}
+
+static int compareEntries(const struct Entry *const a, const struct Entry *const b, size_t depth) {
+    if (a->key != b->key) {
+        return a->key < b->key ? -1 : 1;
+    }
+    if (isExhausted(a->key)) {
+        return 0;
+    }
+    depth += KEY_BYTES;
+    const size_t aSize = Text_length(a->text) - depth, bSize = Text_length(b->text) - depth;
+    const size_t size = aSize < bSize ? aSize : bSize;
+    const size_t i = TextSimd_mismatch(a->text + depth, b->text + depth, size);
+    if (i < size) {
+        return (unsigned char) a->text[depth + i] - (unsigned char) b->text[depth + i];
+    }
+    return (aSize > bSize) - (aSize < bSize);
+}
+
+static void insertionSort(struct Entry *const entries, const struct Task *const task) {
+    for (size_t i = task->begin + 1; i < task->end; i++) {
+        const struct Entry entry = entries[i];
+        size_t j = i;
+        for (; j > task->begin && compareEntries(&entry, &entries[j - 1], task->depth) < 0; j--) {
+            entries[j] = entries[j - 1];
+        }
+        entries[j] = entry;
+    }
+}
+
+static uint64_t medianOf3(const uint64_t a, const uint64_t b, const uint64_t c) {
+    if (a < b) {
+        return b < c ? b : (a < c ? c : a);
+    }
+    return a < c ? a : (b < c ? c : b);
+}
+
+static uint64_t choosePivot(const struct Entry *const entries, const size_t begin, const size_t end) {
+    const size_t size = end - begin, middle = begin + size / 2, last = end - 1;
+    if (size < 128) {
+        return medianOf3(entries[begin].key, entries[middle].key, entries[last].key);
+    }
+    const size_t step = size / 8;
+    return medianOf3(
+            medianOf3(entries[begin].key, entries[begin + step].key, entries[begin + 2 * step].key),
+            medianOf3(entries[middle - step].key, entries[middle].key, entries[middle + step].key),
+            medianOf3(entries[last - 2 * step].key, entries[last - step].key, entries[last].key)
+    );
+}
+
+static void swapEntries(struct Entry *const a, struct Entry *const b) {
+    const struct Entry t = *a;
+    *a = *b;
+    *b = t;
+}
+
+/*
+ * Sorts small tasks in place, partitions the others in three by key.
+ * Writes the partitions still to be sorted into parts, from the largest to the smallest, and returns their number.
+ */
+static size_t split(struct Entry *const entries, const struct Task *const task, struct Task parts[3]) {
+    if (task->stale) {
+        refreshKeys(entries, task);
+    }
+    if (task->end - task->begin <= SMALL_RANGE) {
+        insertionSort(entries, task);
+        return 0;
+    }
+    const uint64_t pivot = choosePivot(entries, task->begin, task->end);
+    size_t lt = task->begin, i = task->begin, gt = task->end;
+    while (i < gt) {
+        const uint64_t key = entries[i].key;
+        if (key < pivot) {
+            swapEntries(&entries[lt++], &entries[i++]);
+        } else if (key > pivot) {
+            swapEntries(&entries[i], &entries[--gt]);
+        } else {
+            i++;
+        }
+    }
+    size_t count = 0;
+    if (lt - task->begin > 1) {
+        parts[count++] = (struct Task) {.begin=task->begin, .end=lt, .depth=task->depth, .stale=false};
+    }
+    if (task->end - gt > 1) {
+        parts[count++] = (struct Task) {.begin=gt, .end=task->end, .depth=task->depth, .stale=false};
+    }
+    if (gt - lt > 1 && !isExhausted(pivot)) {
+        parts[count++] = (struct Task) {.begin=lt, .end=gt, .depth=task->depth + KEY_BYTES, .stale=true};
+    }
+    for (size_t j = 1; j < count; j++) {
+        const struct Task part = parts[j];
+        size_t k = j;
+        for (; k > 0 && parts[k - 1].end - parts[k - 1].begin < part.end - part.begin; k--) {
+            parts[k] = parts[k - 1];
+        }
+        parts[k] = part;
+    }
+    return count;
+}
+
+/*
+ * Parts are pushed largest first, so the one stacked above a task's largest part is at most half of the task and the
+ * next one at most a third: the size of the entry at position p is bounded by n / sqrt(3)^p, which keeps the stack
+ * within 2 log3(n) entries no matter how deep the keys go.
+ */
+static void sortTask(struct Entry *const entries, const struct Task *const task) {
+    struct Task stack[STACK_SIZE];
+    size_t size = 0;
+    stack[size++] = *task;
+    while (size > 0) {
+        const struct Task current = stack[--size];
+        assert(size + 3 <= STACK_SIZE);
+        size += split(entries, &current, &stack[size]);
+    }
+}
+
+static struct Entry *makeEntries(const Text *const texts, const size_t count) {
+    struct Entry *entries = Option_unwrap(Alligator_malloc(sizeof(entries[0]) * count));
+    for (size_t i = 0; i < count; i++) {
+        assert(texts[i]);
+        entries[i].text = texts[i];
+        entries[i].key = makeKey(texts[i], 0);
+    }
+    return entries;
+}
+
+static void storeEntries(Text *const texts, struct Entry *const entries, const size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        texts[i] = entries[i].text;
+    }
+    Alligator_free(entries);
+}
+
+void Text_sortArray(Text *const texts, const size_t count) {
+    assert(texts);
+    if (count < 2) {
+        return;
+    }
+    struct Entry *entries = makeEntries(texts, count);
+    sortTask(entries, &(struct Task) {.begin=0, .end=count, .depth=0, .stale=false});
+    storeEntries(texts, entries, count);
+}
+
+/*
+ * Parallel mode: tasks larger than the grain are split once and their parts shared through a stack,
+ * smaller ones are sorted entirely by the thread taking them.
+ */
+struct Pool {
+    struct Entry *entries;
+    struct Task *tasks;
+    size_t tasksSize;
+    size_t tasksCapacity;
+    size_t pending;     // tasks queued or being processed
+    pthread_mutex_t mutex;
+    pthread_cond_t changed;
+};
+
+static void Pool_push(struct Pool *const self, const struct Task *const tasks, const size_t count) {
+    if (self->tasksSize + count > self->tasksCapacity) {
+        self->tasksCapacity = 2 * (self->tasksSize + count);
+        self->tasks = Option_unwrap(Alligator_realloc(self->tasks, sizeof(self->tasks[0]) * self->tasksCapacity));
+    }
+    memcpy(&self->tasks[self->tasksSize], tasks, sizeof(tasks[0]) * count);
+    self->tasksSize += count;
+    self->pending += count;
+}
+
+static void *Pool_work(void *const arg) {
+    struct Pool *const self = arg;
+    pthread_mutex_lock(&self->mutex);
+    for (;;) {
+        while (0 == self->tasksSize && self->pending > 0) {
+            pthread_cond_wait(&self->changed, &self->mutex);
+        }
+        if (0 == self->pending) {
+            break;
+        }
+        const struct Task task = self->tasks[--self->tasksSize];
+        pthread_mutex_unlock(&self->mutex);
+        struct Task parts[3];
+        size_t count = 0;
+        if (task.end - task.begin < TEXT_SORT_PARALLEL_GRAIN) {
+            sortTask(self->entries, &task);
+        } else {
+            count = split(self->entries, &task, parts);
+        }
+        pthread_mutex_lock(&self->mutex);
+        Pool_push(self, parts, count);
+        self->pending -= 1;
+        if (count > 0 || 0 == self->pending) {
+            pthread_cond_broadcast(&self->changed);
+        }
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+void Text_sortArrayParallel(Text *const texts, const size_t count, unsigned threads) {
+    assert(texts);
+    if (0 == threads) {
+        const long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (unsigned) online : 1;
+    }
+    if (1 == threads || count < TEXT_SORT_PARALLEL_GRAIN) {
+        Text_sortArray(texts, count);
+        return;
+    }
+    struct Pool pool = {.entries=makeEntries(texts, count)};
+    pthread_mutex_init(&pool.mutex, NULL);
+    pthread_cond_init(&pool.changed, NULL);
+    Pool_push(&pool, &(struct Task) {.begin=0, .end=count, .depth=0, .stale=false}, 1);
+    pthread_t *workers = Option_unwrap(Alligator_malloc(sizeof(workers[0]) * (threads - 1)));
+    for (unsigned i = 0; i < threads - 1; i++) {
+        if (0 != pthread_create(&workers[i], NULL, Pool_work, &pool)) {
+            Panic_terminate("Unable to create thread");
+        }
+    }
+    Pool_work(&pool);
+    for (unsigned i = 0; i < threads - 1; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    Alligator_free(workers);
+    Alligator_free(pool.tasks);
+    pthread_cond_destroy(&pool.changed);
+    pthread_mutex_destroy(&pool.mutex);
+    storeEntries(texts, pool.entries, count);
+}
@@ -0,0 +1,71 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Sorts the texts in ascending order as defined by Text_compare.
+ * Uses a multikey quicksort caching the next bytes of each text next to its handle, so that partitioning
+ * reads memory sequentially and common prefixes are examined only once. The sort is not stable.
+ *
+ * @attention texts must not be NULL.
+ * @attention every text must not be NULL.
+ *
+ * @param texts The texts to sort.
+ * @param count The number of texts.
+ */
+extern void Text_sortArray(Text *texts, size_t count)
+__attribute__((__nonnull__));
+
+/**
+ * Like Text_sortArray but spreads the partitions across threads, the result is the same.
+ * Partitions smaller than TEXT_SORT_PARALLEL_GRAIN elements are sorted by a single thread.
+ *
+ * @attention texts must not be NULL.
+ * @attention every text must not be NULL.
+ *
+ * @param texts The texts to sort.
+ * @param count The number of texts.
+ * @param threads The number of threads to use including the caller, 0 to use one per online processor.
+ */
+extern void Text_sortArrayParallel(Text *texts, size_t count, unsigned threads)
+__attribute__((__nonnull__));
+
+#ifdef __cplusplus
+}
+#endif
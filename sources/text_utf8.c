@@ -0,0 +1,837 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include <panic/panic.h>
+#include <alligator/alligator.h>
+#include "text_utf8.h"
+#include "text_config.h"
+#include "text_header.h"
+#include "text_simd.h"
+#include "text_case_tables.h"
+
+#if TEXT_CODE_POINT_INDEX_STRIDE < 1UL
+    #error
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define TEXT_UTF8_X86   1
+#endif
+
+static bool isContinuation(const unsigned char c) {
+    return 0x80 == (c & 0xC0);
+}
+
+/*
+ * Returns the length of the sequence started by c, or 0 if c can't start a sequence.
+ */
+static size_t sequenceLength(const unsigned char c) {
+    if (c < 0x80) {
+        return 1;
+    }
+    if (c < 0xC2) {
+        return 0;
+    }
+    if (c < 0xE0) {
+        return 2;
+    }
+    if (c < 0xF0) {
+        return 3;
+    }
+    return c < 0xF5 ? 4 : 0;
+}
+
+/*
+ * Gets the range of the byte following lead, ruling out overlong encodings, surrogates and values above U+10FFFF.
+ */
+static void secondByteBounds(const unsigned char lead, unsigned char *const low, unsigned char *const high) {
+    *low = 0x80;
+    *high = 0xBF;
+    switch (lead) {
+        case 0xE0: *low = 0xA0; break;
+        case 0xED: *high = 0x9F; break;
+        case 0xF0: *low = 0x90; break;
+        case 0xF4: *high = 0x8F; break;
+        default: break;
+    }
+}
+
+/*
+ * Decodes the sequence at cursor, returns its length or 1 storing TEXT_REPLACEMENT_CHARACTER if it's invalid.
+ */
+static size_t decode(const unsigned char *const cursor, const unsigned char *const end, uint32_t *const codePoint) {
+    const unsigned char lead = *cursor;
+    const size_t length = sequenceLength(lead);
+    if (1 == length) {
+        *codePoint = lead;
+        return 1;
+    }
+    if (0 == length || (size_t) (end - cursor) < length) {
+        *codePoint = TEXT_REPLACEMENT_CHARACTER;
+        return 1;
+    }
+    unsigned char low, high;
+    uint32_t value = lead & (0x7FU >> length);
+    secondByteBounds(lead, &low, &high);
+    for (size_t i = 1; i < length; i++) {
+        if (cursor[i] < low || cursor[i] > high) {
+            *codePoint = TEXT_REPLACEMENT_CHARACTER;
+            return 1;
+        }
+        value = (value << 6) | (cursor[i] & 0x3FU);
+        low = 0x80;
+        high = 0xBF;
+    }
+    *codePoint = value;
+    return length;
+}
+
+/*
+ * Scalar validation of [bytes, bytes + size).
+ * Returns the offset of the first invalid sequence or size if valid.
+ * If tail is not NULL a sequence truncated by the end of input is not an error, *tail is set to its offset
+ * (size if there is none).
+ */
+static size_t validateScalar(const unsigned char *const bytes, const size_t size, size_t *const tail) {
+    size_t i = 0;
+    if (tail) {
+        *tail = size;
+    }
+    while (i < size) {
+        if (i + 8 <= size) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            if (0 == (word & UINT64_C(0x8080808080808080))) {
+                i += 8;
+                continue;
+            }
+        }
+        const unsigned char lead = bytes[i];
+        const size_t length = sequenceLength(lead);
+        if (0 == length) {
+            return i;
+        }
+        if (1 == length) {
+            i++;
+            continue;
+        }
+        unsigned char low, high;
+        secondByteBounds(lead, &low, &high);
+        for (size_t j = 1; j < length; j++) {
+            if (i + j >= size) {
+                if (tail) {
+                    *tail = i;
+                    return size;
+                }
+                return i;
+            }
+            const unsigned char c = bytes[i + j];
+            if (c < low || c > high) {
+                return i;
+            }
+            low = 0x80;
+            high = 0xBF;
+        }
+        i += length;
+    }
+    return i;
+}
+
+/*
+ * Returns the offset of the first character starting at or before offset that may not be fully validated.
+ */
+static size_t boundaryBefore(const unsigned char *const bytes, const size_t offset) {
+    for (size_t back = 1; back <= 3 && back <= offset; back++) {
+        const unsigned char c = bytes[offset - back];
+        if (!isContinuation(c)) {
+            const size_t length = sequenceLength(c);
+            return 0 == length || length > back ? offset - back : offset;
+        }
+    }
+    return offset;
+}
+
+#ifdef TEXT_UTF8_X86
+
+/*
+ * Block validation following "Validating UTF-8 In Less Than One Instruction Per Byte" (Keiser, Lemire).
+ * Each byte is classified together with its predecessor through three 16 entries lookup tables, errors are
+ * encoded as bits that survive the intersection of the three lookups.
+ */
+#define TOO_SHORT       (1 << 0)
+#define TOO_LONG        (1 << 1)
+#define OVERLONG_3      (1 << 2)
+#define TOO_LARGE       (1 << 3)
+#define SURROGATE       (1 << 4)
+#define OVERLONG_2      (1 << 5)
+#define TOO_LARGE_1000  (1 << 6)
+#define OVERLONG_4      (1 << 6)
+#define TWO_CONTS       (1 << 7)
+#define CARRY           (TOO_SHORT | TOO_LONG | TWO_CONTS)
+
+#define BYTE_1_HIGH_TABLE \
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, \
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS, \
+    TOO_SHORT | OVERLONG_2, \
+    TOO_SHORT, \
+    TOO_SHORT | OVERLONG_3 | SURROGATE, \
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4
+
+#define BYTE_1_LOW_TABLE \
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4, \
+    CARRY | OVERLONG_2, \
+    CARRY, \
+    CARRY, \
+    CARRY | TOO_LARGE, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000, \
+    CARRY | TOO_LARGE | TOO_LARGE_1000
+
+#define BYTE_2_HIGH_TABLE \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, \
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE, \
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT
+
+/*
+ * Returns the offset of the first 16 bytes block containing an error, or the number of bytes validated.
+ */
+__attribute__((__target__("ssse3")))
+static size_t validateBlocksSsse3(const unsigned char *const bytes, const size_t size) {
+    const __m128i byte1High = _mm_setr_epi8(BYTE_1_HIGH_TABLE);
+    const __m128i byte1Low = _mm_setr_epi8(BYTE_1_LOW_TABLE);
+    const __m128i byte2High = _mm_setr_epi8(BYTE_2_HIGH_TABLE);
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    const __m128i incompleteLimits = _mm_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1)
+    );
+    __m128i previous = _mm_setzero_si128(), previousIncomplete = _mm_setzero_si128();
+    size_t i = 0;
+
+    for (; i + 16 <= size; i += 16) {
+        const __m128i input = _mm_loadu_si128((const __m128i *) (bytes + i));
+        if (0 == _mm_movemask_epi8(input)) {
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(previousIncomplete, _mm_setzero_si128()))) {
+                return i;
+            }
+        } else {
+            const __m128i previous1 = _mm_alignr_epi8(input, previous, 15);
+            const __m128i special = _mm_and_si128(
+                    _mm_and_si128(
+                            _mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(previous1, 4), nibble)),
+                            _mm_shuffle_epi8(byte1Low, _mm_and_si128(previous1, nibble))
+                    ),
+                    _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(input, 4), nibble))
+            );
+            const __m128i previous2 = _mm_alignr_epi8(input, previous, 14);
+            const __m128i previous3 = _mm_alignr_epi8(input, previous, 13);
+            const __m128i mustBeContinuation = _mm_and_si128(
+                    _mm_or_si128(
+                            _mm_subs_epu8(previous2, _mm_set1_epi8((char) (0xE0 - 0x80))),
+                            _mm_subs_epu8(previous3, _mm_set1_epi8((char) (0xF0 - 0x80)))
+                    ),
+                    _mm_set1_epi8((char) 0x80)
+            );
+            const __m128i error = _mm_xor_si128(mustBeContinuation, special);
+            if (0xFFFF != _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128()))) {
+                return i;
+            }
+        }
+        previousIncomplete = _mm_subs_epu8(input, incompleteLimits);
+        previous = input;
+    }
+    return i;
+}
+
+/*
+ * Returns the offset of the first 32 bytes block containing an error, or the number of bytes validated.
+ */
+__attribute__((__target__("avx2")))
+static size_t validateBlocksAvx2(const unsigned char *const bytes, const size_t size) {
+    const __m256i byte1High = _mm256_setr_epi8(BYTE_1_HIGH_TABLE, BYTE_1_HIGH_TABLE);
+    const __m256i byte1Low = _mm256_setr_epi8(BYTE_1_LOW_TABLE, BYTE_1_LOW_TABLE);
+    const __m256i byte2High = _mm256_setr_epi8(BYTE_2_HIGH_TABLE, BYTE_2_HIGH_TABLE);
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    const __m256i incompleteLimits = _mm256_setr_epi8(
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+            -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, (char) (0xF0 - 1), (char) (0xE0 - 1), (char) (0xC0 - 1)
+    );
+    __m256i previous = _mm256_setzero_si256(), previousIncomplete = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        const __m256i input = _mm256_loadu_si256((const __m256i *) (bytes + i));
+        if (0 == _mm256_movemask_epi8(input)) {
+            if (!_mm256_testz_si256(previousIncomplete, previousIncomplete)) {
+                return i;
+            }
+        } else {
+            // shifts across the two 128 bits lanes need the upper lane of previous next to the lower one of input
+            const __m256i shifted = _mm256_permute2x128_si256(previous, input, 0x21);
+            const __m256i previous1 = _mm256_alignr_epi8(input, shifted, 15);
+            const __m256i special = _mm256_and_si256(
+                    _mm256_and_si256(
+                            _mm256_shuffle_epi8(byte1High, _mm256_and_si256(_mm256_srli_epi16(previous1, 4), nibble)),
+                            _mm256_shuffle_epi8(byte1Low, _mm256_and_si256(previous1, nibble))
+                    ),
+                    _mm256_shuffle_epi8(byte2High, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble))
+            );
+            const __m256i previous2 = _mm256_alignr_epi8(input, shifted, 14);
+            const __m256i previous3 = _mm256_alignr_epi8(input, shifted, 13);
+            const __m256i mustBeContinuation = _mm256_and_si256(
+                    _mm256_or_si256(
+                            _mm256_subs_epu8(previous2, _mm256_set1_epi8((char) (0xE0 - 0x80))),
+                            _mm256_subs_epu8(previous3, _mm256_set1_epi8((char) (0xF0 - 0x80)))
+                    ),
+                    _mm256_set1_epi8((char) 0x80)
+            );
+            const __m256i error = _mm256_xor_si256(mustBeContinuation, special);
+            if (!_mm256_testz_si256(error, error)) {
+                return i;
+            }
+        }
+        previousIncomplete = _mm256_subs_epu8(input, incompleteLimits);
+        previous = input;
+    }
+    return i;
+}
+
+#endif
+
+static size_t validateBlocksNone(const unsigned char *const bytes, const size_t size) {
+    (void) bytes;
+    (void) size;
+    return 0;
+}
+
+typedef size_t (*BlockValidator)(const unsigned char *bytes, size_t size);
+
+static BlockValidator blockValidator(void) {
+    static BlockValidator selected = NULL;
+    if (NULL == selected) {
+        BlockValidator candidate = validateBlocksNone;
+#ifdef TEXT_UTF8_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            candidate = validateBlocksAvx2;
+        } else if (__builtin_cpu_supports("ssse3")) {
+            candidate = validateBlocksSsse3;
+        }
+#endif
+        selected = candidate;
+    }
+    return selected;
+}
+
+/*
+ * Validates the bulk with the fastest block validator available, the remaining bytes (and the exact offset of an
+ * error) are handled by the scalar validator starting from the last character boundary.
+ */
+static size_t validate(const unsigned char *const bytes, const size_t size, size_t *const tail) {
+    const size_t checked = blockValidator()(bytes, size);
+    const size_t start = boundaryBefore(bytes, checked);
+    const size_t result = validateScalar(bytes + start, size - start, tail);
+    if (tail) {
+        *tail += start;
+    }
+    return start + result;
+}
+
+bool Text_isValidUtf8(const TextView self, size_t *const invalidOffset) {
+    assert(self);
+    const size_t length = Text_length(self);
+    const size_t result = validate((const unsigned char *) self, length, NULL);
+    if (result < length) {
+        if (invalidOffset) {
+            *invalidOffset = result;
+        }
+        return false;
+    }
+    return true;
+}
+
+void TextUtf8Validator_init(TextUtf8Validator *const self) {
+    assert(self);
+    memset(self, 0, sizeof(*self));
+    self->invalidOffset = SIZE_MAX;
+}
+
+bool TextUtf8Validator_update(TextUtf8Validator *const self, const void *const bytes, const size_t size) {
+    assert(self);
+    assert(bytes);
+    const unsigned char *data = bytes;
+    size_t remaining = size, tail;
+
+    if (SIZE_MAX != self->invalidOffset) {
+        return false;
+    }
+
+    if (self->pendingSize > 0) {
+        const size_t missing = sequenceLength(self->pending[0]) - self->pendingSize;
+        const size_t taken = missing < remaining ? missing : remaining;
+        memcpy(self->pending + self->pendingSize, data, taken);
+        const size_t start = self->offset - self->pendingSize;
+        const size_t result = validateScalar(self->pending, self->pendingSize + taken, &tail);
+        self->offset += taken;
+        data += taken;
+        remaining -= taken;
+        if (result < self->pendingSize + taken) {
+            self->invalidOffset = start + result;
+            self->offset += remaining;
+            return false;
+        }
+        if (tail < self->pendingSize + taken) {
+            self->pendingSize += taken;
+            return true;
+        }
+        self->pendingSize = 0;
+    }
+
+    const size_t result = validate(data, remaining, &tail);
+    if (result < remaining) {
+        self->invalidOffset = self->offset + result;
+        self->offset += remaining;
+        return false;
+    }
+    self->pendingSize = remaining - tail;
+    memcpy(self->pending, data + tail, self->pendingSize);
+    self->offset += remaining;
+    return true;
+}
+
+bool TextUtf8Validator_finish(const TextUtf8Validator *const self, size_t *const invalidOffset) {
+    assert(self);
+    size_t offset = self->invalidOffset;
+    if (SIZE_MAX == offset && self->pendingSize > 0) {
+        offset = self->offset - self->pendingSize;
+    }
+    if (SIZE_MAX != offset) {
+        if (invalidOffset) {
+            *invalidOffset = offset;
+        }
+        return false;
+    }
+    return true;
+}
+
+/*
+ * Counts the bytes in [begin, end) that are not continuation bytes, i.e. greater than 0xBF as signed values.
+ * The SSE2 path accumulates the comparison results in 8 bits counters, flushing them every 255 blocks.
+ */
+static size_t countCodePoints(const unsigned char *begin, const unsigned char *const end) {
+    size_t count = 0;
+#ifdef TEXT_SIMD_SSE2
+    const __m128i threshold = _mm_set1_epi8((char) 0xBF);
+    while (end - begin >= 16) {
+        const size_t available = (size_t) (end - begin) / 16, blocks = available < 255 ? available : 255;
+        __m128i counters = _mm_setzero_si128();
+        for (size_t i = 0; i < blocks; i++, begin += 16) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) begin);
+            counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(block, threshold));
+        }
+        const __m128i sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+        count += (size_t) _mm_extract_epi16(sums, 0) + (size_t) _mm_extract_epi16(sums, 4);
+    }
+#endif
+    for (; begin < end; begin++) {
+        count += !isContinuation(*begin);
+    }
+    return count;
+}
+
+/*
+ * Finds the n-th (zero based) byte in [begin, end) that is not a continuation byte.
+ * Returns end if there are exactly n such bytes, NULL if there are less.
+ */
+static const unsigned char *findCodePoint(const unsigned char *begin, const unsigned char *const end, size_t n) {
+#ifdef TEXT_SIMD_SSE2
+    const __m128i threshold = _mm_set1_epi8((char) 0xBF);
+    while (end - begin >= 16) {
+        const __m128i block = _mm_loadu_si128((const __m128i *) begin);
+        uint32_t mask = (uint32_t) _mm_movemask_epi8(_mm_cmpgt_epi8(block, threshold));
+        const size_t found = (size_t) __builtin_popcount(mask);
+        if (n < found) {
+            for (; n > 0; n--) {
+                mask &= mask - 1;
+            }
+            return begin + TextSimd_countTrailingZeros(mask);
+        }
+        n -= found;
+        begin += 16;
+    }
+#endif
+    for (; begin < end; begin++) {
+        if (!isContinuation(*begin)) {
+            if (0 == n) {
+                return begin;
+            }
+            n -= 1;
+        }
+    }
+    return 0 == n ? end : NULL;
+}
+
+size_t Text_codePointCount(const TextView self) {
+    assert(self);
+    const unsigned char *const begin = (const unsigned char *) self;
+    return countCodePoints(begin, begin + Text_length(self));
+}
+
+size_t Text_codePointIndexAt(const TextView self, const size_t offset) {
+    assert(self);
+    if (offset > Text_length(self)) {
+        Panic_terminate("Out of range");
+    }
+    const unsigned char *const begin = (const unsigned char *) self;
+    return countCodePoints(begin, begin + offset);
+}
+
+size_t Text_offsetOfCodePoint(const TextView self, const size_t index) {
+    assert(self);
+    const unsigned char *const begin = (const unsigned char *) self;
+    const unsigned char *const found = findCodePoint(begin, begin + Text_length(self), index);
+    if (NULL == found) {
+        Panic_terminate("Out of range");
+    }
+    return (size_t) (found - begin);
+}
+
+TextCodePointIterator Text_codePoints(const TextView self, const size_t offset) {
+    assert(self);
+    const size_t length = Text_length(self);
+    if (offset > length) {
+        Panic_terminate("Out of range");
+    }
+    TextCodePointIterator iterator;
+    iterator.begin = self;
+    iterator.cursor = self + offset;
+    iterator.end = self + length;
+    return iterator;
+}
+
+bool TextCodePointIterator_next(TextCodePointIterator *const self, uint32_t *const codePoint) {
+    assert(self);
+    assert(codePoint);
+    if (self->cursor >= self->end) {
+        return false;
+    }
+    self->cursor += decode((const unsigned char *) self->cursor, (const unsigned char *) self->end, codePoint);
+    return true;
+}
+
+bool TextCodePointIterator_previous(TextCodePointIterator *const self, uint32_t *const codePoint) {
+    assert(self);
+    assert(codePoint);
+    if (self->cursor <= self->begin) {
+        return false;
+    }
+    const unsigned char *const cursor = (const unsigned char *) self->cursor;
+    const unsigned char *start = cursor - 1;
+    while (start > (const unsigned char *) self->begin && cursor - start < 4 && isContinuation(*start)) {
+        start--;
+    }
+    if (decode(start, cursor, codePoint) == (size_t) (cursor - start)) {
+        self->cursor = (const char *) start;
+    } else {
+        *codePoint = TEXT_REPLACEMENT_CHARACTER;
+        self->cursor -= 1;
+    }
+    return true;
+}
+
+size_t TextCodePointIterator_offset(const TextCodePointIterator *const self) {
+    assert(self);
+    return (size_t) (self->cursor - self->begin);
+}
+
+enum CaseMapping {
+    CaseMapping_Lower,
+    CaseMapping_Upper,
+    CaseMapping_Fold,
+};
+
+/*
+ * Maps the code point storing the result in mapped, returns the number of code points stored (at most 3).
+ */
+static size_t mapCase(const uint32_t codePoint, const enum CaseMapping mapping, uint32_t *const mapped) {
+    if (codePoint >= TEXT_CASE_LIMIT) {
+        mapped[0] = codePoint;
+        return 1;
+    }
+    const size_t block = TextCase_stage1[codePoint >> TEXT_CASE_SHIFT];
+    const size_t slot = codePoint & ((UINT32_C(1) << TEXT_CASE_SHIFT) - 1);
+    const struct TextCase_Record *const record = &TextCase_records[TextCase_stage2[(block << TEXT_CASE_SHIFT) | slot]];
+    const uint16_t special = record->special[mapping];
+    if (special) {
+        size_t size = 0;
+        for (; size < 3 && TextCase_specials[special][size]; size++) {
+            mapped[size] = TextCase_specials[special][size];
+        }
+        return size;
+    }
+    mapped[0] = (uint32_t) ((int32_t) codePoint + record->delta[mapping]);
+    return 1;
+}
+
+static size_t encodedLength(const uint32_t codePoint) {
+    return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+}
+
+static size_t encode(unsigned char *const out, const uint32_t codePoint) {
+    if (codePoint < 0x80) {
+        out[0] = (unsigned char) codePoint;
+        return 1;
+    }
+    if (codePoint < 0x800) {
+        out[0] = (unsigned char) (0xC0 | (codePoint >> 6));
+        out[1] = (unsigned char) (0x80 | (codePoint & 0x3F));
+        return 2;
+    }
+    if (codePoint < 0x10000) {
+        out[0] = (unsigned char) (0xE0 | (codePoint >> 12));
+        out[1] = (unsigned char) (0x80 | ((codePoint >> 6) & 0x3F));
+        out[2] = (unsigned char) (0x80 | (codePoint & 0x3F));
+        return 3;
+    }
+    out[0] = (unsigned char) (0xF0 | (codePoint >> 18));
+    out[1] = (unsigned char) (0x80 | ((codePoint >> 12) & 0x3F));
+    out[2] = (unsigned char) (0x80 | ((codePoint >> 6) & 0x3F));
+    out[3] = (unsigned char) (0x80 | (codePoint & 0x3F));
+    return 4;
+}
+
+static unsigned char mapAsciiCase(const unsigned char c, const enum CaseMapping mapping) {
+    if (CaseMapping_Upper == mapping) {
+        return (unsigned char) (c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+    }
+    return (unsigned char) (c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+}
+
+#ifdef TEXT_SIMD_SSE2
+
+/*
+ * Maps 16 ASCII bytes flipping the case bit of the letters in range, source and destination may overlap as long as
+ * destination doesn't follow source.
+ */
+static void mapAsciiBlock(unsigned char *const out, const __m128i block, const enum CaseMapping mapping) {
+    const char first = CaseMapping_Upper == mapping ? 'a' : 'A';
+    const __m128i letters = _mm_and_si128(
+            _mm_cmpgt_epi8(block, _mm_set1_epi8((char) (first - 1))),
+            _mm_cmplt_epi8(block, _mm_set1_epi8((char) (first + 26)))
+    );
+    _mm_storeu_si128((__m128i *) out, _mm_xor_si128(block, _mm_and_si128(letters, _mm_set1_epi8(0x20))));
+}
+
+#endif
+
+/*
+ * Maps the content of [bytes, bytes + size) writing to out (if not NULL) which may alias bytes as long as it doesn't
+ * follow it by more than the growth reported by a previous measuring pass.
+ * Returns the mapped length, *growth is set to the largest lead the output takes over the input at any point.
+ */
+static size_t mapCaseRange(unsigned char *out, const unsigned char *const bytes, const size_t size,
+                           const enum CaseMapping mapping, size_t *const growth) {
+    size_t i = 0, produced = 0;
+    *growth = 0;
+    while (i < size) {
+#ifdef TEXT_SIMD_SSE2
+        if (i + 16 <= size) {
+            const __m128i block = _mm_loadu_si128((const __m128i *) (bytes + i));
+            if (0 == _mm_movemask_epi8(block)) {
+                if (out) {
+                    mapAsciiBlock(out + produced, block, mapping);
+                }
+                i += 16;
+                produced += 16;
+                continue;
+            }
+        }
+#endif
+        const unsigned char c = bytes[i];
+        if (c < 0x80) {
+            if (out) {
+                out[produced] = mapAsciiCase(c, mapping);
+            }
+            i += 1;
+            produced += 1;
+            continue;
+        }
+        uint32_t codePoint, mapped[3];
+        const size_t length = decode(bytes + i, bytes + size, &codePoint);
+        if (1 == length) {
+            if (out) {
+                out[produced] = c;
+            }
+            produced += 1;
+        } else {
+            const size_t count = mapCase(codePoint, mapping, mapped);
+            if (out) {
+                // decoded before writing: the output may overwrite the sequence
+                for (size_t j = 0; j < count; j++) {
+                    produced += encode(out + produced, mapped[j]);
+                }
+            } else {
+                for (size_t j = 0; j < count; j++) {
+                    produced += encodedLength(mapped[j]);
+                }
+            }
+        }
+        i += length;
+        if (produced > i && produced - i > *growth) {
+            *growth = produced - i;
+        }
+    }
+    return produced;
+}
+
+/*
+ * Measures first: if the output never takes the lead over the input it's written in place, otherwise the content
+ * is moved forward by the largest lead (expanding the text once) and mapped back to the start.
+ */
+static Text mapCaseInPlace(Text *const ref, const enum CaseMapping mapping) {
+    assert(ref);
+    assert(*ref);
+    Text self = *ref;
+    Text_Header_getMutable(self);
+    const size_t length = Text_length(self);
+    size_t growth;
+    const size_t mappedLength = mapCaseRange(NULL, (const unsigned char *) self, length, mapping, &growth);
+    if (growth > 0) {
+        self = Text_expandToFit(ref, length + growth);
+        memmove(self + growth, self, length);
+    } else {
+        *ref = NULL;
+    }
+    size_t ignored;
+    mapCaseRange((unsigned char *) self, (const unsigned char *) self + growth, length, mapping, &ignored);
+    Text_setLength(self, mappedLength);
+    return self;
+}
+
+Text Text_lowerUtf8(Text *const ref) {
+    return mapCaseInPlace(ref, CaseMapping_Lower);
+}
+
+Text Text_upperUtf8(Text *const ref) {
+    return mapCaseInPlace(ref, CaseMapping_Upper);
+}
+
+Text Text_foldUtf8(Text *const ref) {
+    return mapCaseInPlace(ref, CaseMapping_Fold);
+}
+
+/*
+ * checkpoints[i] holds the number of code points starting before offset i * TEXT_CODE_POINT_INDEX_STRIDE.
+ */
+struct TextCodePointIndex {
+    size_t length;
+    size_t count;
+    size_t checkpointsSize;
+    size_t checkpoints[];
+};
+
+TextCodePointIndex *TextCodePointIndex_new(const TextView text) {
+    assert(text);
+    const unsigned char *const begin = (const unsigned char *) text;
+    const size_t length = Text_length(text), checkpointsSize = length / TEXT_CODE_POINT_INDEX_STRIDE + 1;
+    TextCodePointIndex *self = Option_unwrap(Alligator_malloc(
+            sizeof(*self) + sizeof(self->checkpoints[0]) * checkpointsSize
+    ));
+    size_t count = 0;
+    self->checkpoints[0] = 0;
+    for (size_t i = 1; i < checkpointsSize; i++) {
+        const unsigned char *const block = begin + (i - 1) * TEXT_CODE_POINT_INDEX_STRIDE;
+        count += countCodePoints(block, block + TEXT_CODE_POINT_INDEX_STRIDE);
+        self->checkpoints[i] = count;
+    }
+    self->length = length;
+    self->count = count + countCodePoints(begin + (checkpointsSize - 1) * TEXT_CODE_POINT_INDEX_STRIDE, begin + length);
+    self->checkpointsSize = checkpointsSize;
+    return self;
+}
+
+size_t TextCodePointIndex_count(const TextCodePointIndex *const self) {
+    assert(self);
+    return self->count;
+}
+
+size_t TextCodePointIndex_indexAt(const TextCodePointIndex *const self, const TextView text, const size_t offset) {
+    assert(self);
+    assert(text);
+    assert(Text_length(text) >= self->length);
+    if (offset > self->length) {
+        Panic_terminate("Out of range");
+    }
+    const size_t checkpoint = offset / TEXT_CODE_POINT_INDEX_STRIDE;
+    const unsigned char *const begin = (const unsigned char *) text;
+    return self->checkpoints[checkpoint] +
+           countCodePoints(begin + checkpoint * TEXT_CODE_POINT_INDEX_STRIDE, begin + offset);
+}
+
+size_t TextCodePointIndex_offsetOf(const TextCodePointIndex *const self, const TextView text, const size_t index) {
+    assert(self);
+    assert(text);
+    assert(Text_length(text) >= self->length);
+    if (index > self->count) {
+        Panic_terminate("Out of range");
+    }
+    // find the last checkpoint not past index
+    size_t low = 0, high = self->checkpointsSize;
+    while (low + 1 < high) {
+        const size_t middle = low + (high - low) / 2;
+        if (self->checkpoints[middle] <= index) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    const unsigned char *const begin = (const unsigned char *) text;
+    const unsigned char *const found = findCodePoint(
+            begin + low * TEXT_CODE_POINT_INDEX_STRIDE, begin + self->length, index - self->checkpoints[low]
+    );
+    assert(found);
+    return (size_t) (found - begin);
+}
+
+void TextCodePointIndex_delete(TextCodePointIndex *const self) {
+    if (self) {
+        Alligator_free(self);
+    }
+}
@@ -0,0 +1,330 @@
+/*
+Author: daddinuz
+email:  daddinuz@gmail.com
+
+Copyright (c) 2018 Davide Di Carlo
+
+Permission is hereby granted, free of charge, to any person
+obtaining a copy of this software and associated documentation
+files (the "Software"), to deal in the Software without
+restriction, including without limitation the rights to use,
+copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the
+Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be
+included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "text.h"
+
+#if !(defined(__GNUC__) || defined(__clang__))
+__attribute__(...)
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * UTF-8 facilities for texts.
+ *
+ * @attention Texts are byte strings, none of the functions in text.h enforces or assumes a particular encoding.
+ * Code point counts and indexes are defined as the number of bytes that are not continuation bytes, which equals the
+ * number of code points for valid UTF-8.
+ * @attention Unless otherwise stated, every function in this module terminates the program in case of out of memory.
+ */
+
+/**
+ * The code point yielded in place of each byte that doesn't belong to a valid sequence.
+ */
+#define TEXT_REPLACEMENT_CHARACTER  0xFFFDU
+
+/**
+ * Validates UTF-8 content incrementally, allowing to check a text chunk by chunk while it is being built.
+ * Sequences may span chunks. Fields are private.
+ */
+typedef struct TextUtf8Validator {
+    size_t offset;
+    size_t invalidOffset;
+    unsigned char pending[4];
+    size_t pendingSize;
+} TextUtf8Validator;
+
+/**
+ * Checks if the content of the text is valid UTF-8.
+ * Overlong encodings, surrogates, code points above U+10FFFF and truncated sequences are rejected.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The text instance.
+ * @param invalidOffset If not NULL and the content is invalid, set to the offset of the first invalid sequence.
+ * @return true if the content is valid UTF-8.
+ */
+extern bool Text_isValidUtf8(TextView self, size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__(1)));
+
+/**
+ * Initializes a streaming validator.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The validator.
+ */
+extern void TextUtf8Validator_init(TextUtf8Validator *self)
+__attribute__((__nonnull__));
+
+/**
+ * Validates the next chunk, a sequence truncated at the end of the chunk is completed by the following ones.
+ *
+ * @attention self must not be NULL.
+ * @attention bytes must not be NULL.
+ *
+ * @param self The validator.
+ * @param bytes The chunk.
+ * @param size The size of the chunk.
+ * @return false if an invalid sequence has been found so far.
+ */
+extern bool TextUtf8Validator_update(TextUtf8Validator *self, const void *bytes, size_t size)
+__attribute__((__nonnull__));
+
+/**
+ * Terminates the validation, a sequence left truncated by the last chunk is invalid.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The validator.
+ * @param invalidOffset If not NULL and the stream is invalid, set to the offset of the first invalid sequence
+ * counting from the first byte of the first chunk.
+ * @return true if the whole stream is valid UTF-8.
+ */
+extern bool TextUtf8Validator_finish(const TextUtf8Validator *self, size_t *invalidOffset)
+__attribute__((__warn_unused_result__, __nonnull__(1)));
+
+/**
+ * Iterates the code points of a text in both directions. Fields are private.
+ */
+typedef struct TextCodePointIterator {
+    const char *begin;
+    const char *cursor;
+    const char *end;
+} TextCodePointIterator;
+
+/**
+ * Maps byte offsets to code point indexes of a text and vice versa.
+ * The number of code points is recorded every TEXT_CODE_POINT_INDEX_STRIDE bytes so that conversions scan at most
+ * that many bytes.
+ */
+typedef struct TextCodePointIndex TextCodePointIndex;
+
+/**
+ * Counts the code points of the text.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The text instance.
+ * @return the number of code points.
+ */
+extern size_t Text_codePointCount(TextView self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the index of the code point starting at offset, that is the number of code points starting before offset.
+ *
+ * @attention self must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The text instance.
+ * @param offset The byte offset.
+ * @return the zero based code point index.
+ */
+extern size_t Text_codePointIndexAt(TextView self, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the byte offset where the code point starts.
+ *
+ * @attention self must not be NULL.
+ * @attention terminates execution if index is greater than the number of code points.
+ *
+ * @param self The text instance.
+ * @param index The zero based code point index, the number of code points maps to the length of the text.
+ * @return the offset of the first byte of the code point.
+ */
+extern size_t Text_offsetOfCodePoint(TextView self, size_t index)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates an iterator over the code points of the text positioned at offset.
+ * Use offset 0 to iterate forward from the start, the length of the text to iterate backward from the end.
+ *
+ * @attention self must not be NULL.
+ * @attention terminates execution if offset is greater than the length of the text.
+ *
+ * @param self The text instance.
+ * @param offset The initial byte offset of the iterator.
+ * @return a new iterator, the text must outlive it and must not be modified meanwhile.
+ */
+extern TextCodePointIterator Text_codePoints(TextView self, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Decodes the code point after the cursor and moves past it.
+ *
+ * @attention self must not be NULL.
+ * @attention codePoint must not be NULL.
+ *
+ * @param self The iterator.
+ * @param codePoint Where to store the code point, TEXT_REPLACEMENT_CHARACTER if the byte after the cursor doesn't
+ * start a valid sequence (the cursor is moved by one byte).
+ * @return false if the cursor is at the end of the text.
+ */
+extern bool TextCodePointIterator_next(TextCodePointIterator *self, uint32_t *codePoint)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Decodes the code point before the cursor and moves before it.
+ *
+ * @attention self must not be NULL.
+ * @attention codePoint must not be NULL.
+ *
+ * @param self The iterator.
+ * @param codePoint Where to store the code point, TEXT_REPLACEMENT_CHARACTER if the byte before the cursor doesn't
+ * end a valid sequence (the cursor is moved by one byte).
+ * @return false if the cursor is at the start of the text.
+ */
+extern bool TextCodePointIterator_previous(TextCodePointIterator *self, uint32_t *codePoint)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the byte offset of the cursor.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The iterator.
+ * @return the offset of the cursor.
+ */
+extern size_t TextCodePointIterator_offset(const TextCodePointIterator *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Converts to lower case following the full Unicode mappings, a code point may become several (e.g. U+0130).
+ * Context and language sensitive mappings (final sigma, Turkish and Lithuanian rules) are not applied, bytes that
+ * don't belong to a valid sequence are left untouched.
+ * The content is modified in place when possible, otherwise the text is expanded once to the required length.
+ *
+ * @attention ref and *ref must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The reference to the text instance.
+ * @return the modified text instance.
+ */
+extern Text Text_lowerUtf8(Text *ref)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Converts to upper case following the full Unicode mappings, a code point may become several (e.g. U+00DF).
+ * Same rules as Text_lowerUtf8 apply.
+ *
+ * @attention ref and *ref must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The reference to the text instance.
+ * @return the modified text instance.
+ */
+extern Text Text_upperUtf8(Text *ref)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Applies the full Unicode case folding, texts differing only by case are folded to the same content.
+ * Same rules as Text_lowerUtf8 apply.
+ *
+ * @attention ref and *ref must not be NULL.
+ *
+ * @attention the reference to the text will be invalidated after this call, the new text is returned.
+ *
+ * @param ref The reference to the text instance.
+ * @return the modified text instance.
+ */
+extern Text Text_foldUtf8(Text *ref)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Creates the code point index of the text.
+ *
+ * @attention text must not be NULL.
+ *
+ * @param text The text instance.
+ * @return a new code point index instance.
+ */
+extern TextCodePointIndex *TextCodePointIndex_new(TextView text)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Gets the number of code points of the indexed text.
+ *
+ * @attention self must not be NULL.
+ *
+ * @param self The code point index instance.
+ * @return the number of code points.
+ */
+extern size_t TextCodePointIndex_count(const TextCodePointIndex *self)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Same as Text_codePointIndexAt scanning at most TEXT_CODE_POINT_INDEX_STRIDE bytes.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL and must be the indexed text.
+ * @attention terminates execution if offset is greater than the indexed length.
+ *
+ * @param self The code point index instance.
+ * @param text The indexed text instance.
+ * @param offset The byte offset.
+ * @return the zero based code point index.
+ */
+extern size_t TextCodePointIndex_indexAt(const TextCodePointIndex *self, TextView text, size_t offset)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Same as Text_offsetOfCodePoint scanning at most TEXT_CODE_POINT_INDEX_STRIDE bytes, takes logarithmic time.
+ *
+ * @attention self must not be NULL.
+ * @attention text must not be NULL and must be the indexed text.
+ * @attention terminates execution if index is greater than the number of code points.
+ *
+ * @param self The code point index instance.
+ * @param text The indexed text instance.
+ * @param index The zero based code point index.
+ * @return the offset of the first byte of the code point.
+ */
+extern size_t TextCodePointIndex_offsetOf(const TextCodePointIndex *self, TextView text, size_t index)
+__attribute__((__warn_unused_result__, __nonnull__));
+
+/**
+ * Deletes an instance of a code point index.
+ * If NULL nothing will be done.
+ *
+ * @param self The instance to be deleted.
+ */
+extern void TextCodePointIndex_delete(TextCodePointIndex *self);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,5 +1,7 @@
+find_package(Threads REQUIRED)
+
 add_library(features ${CMAKE_CURRENT_LIST_DIR}/features.h ${CMAKE_CURRENT_LIST_DIR}/features.c)
-target_link_libraries(features PRIVATE text traits-unit)
+target_link_libraries(features PRIVATE text traits-unit Threads::Threads)
 
 add_executable(describe ${CMAKE_CURRENT_LIST_DIR}/describe.c)
 target_link_libraries(describe PRIVATE features)
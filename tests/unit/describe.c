@@ -35,6 +35,10 @@ Describe("Text",
                Run(withCapacity_checkRuntimeErrors),
                Run(quoted),
                Run(quoted_checkRuntimeErrors),
+               Run(unquoted),
+               Run(unquoted_checkRuntimeErrors),
+               Run(escapedHtml),
+               Run(escapedHtml_checkRuntimeErrors),
                Run(format),
                Run(format_checkRuntimeErrors),
                Skip(vFormat),
@@ -80,6 +84,10 @@ Describe("Text",
                Run(eraseRange_checkRuntimeErrors),
                Run(quote),
                Run(quote_checkRuntimeErrors),
+               Run(unquote),
+               Run(unquote_checkRuntimeErrors),
+               Run(escapeHtml),
+               Run(escapeHtml_checkRuntimeErrors),
                Run(lower),
                Run(lower_checkRuntimeErrors),
                Run(upper),
@@ -97,6 +105,11 @@ Describe("Text",
                Run(expandToFit_checkRuntimeErrors),
                Run(shrinkToFit),
                Run(shrinkToFit_checkRuntimeErrors)),
+         Trait("caller buffer",
+               Run(withBuffer),
+               Run(withBuffer_checkRuntimeErrors)),
+         Trait("recycling",
+               Run(recycling)),
          Trait("accessors",
                Run(get),
                Run(get_checkRuntimeErrors),
@@ -109,4 +122,129 @@ Describe("Text",
                Run(capacity_checkRuntimeErrors)),
          Trait("equality",
                Run(equals),
-               Run(equals_checkRuntimeErrors)))
+               Run(equals_checkRuntimeErrors),
+               Run(compare),
+               Run(compare_checkRuntimeErrors),
+               Run(commonPrefixLength),
+               Run(commonPrefixLength_checkRuntimeErrors),
+               Run(startsWith),
+               Run(startsWith_checkRuntimeErrors),
+               Run(endsWith),
+               Run(endsWith_checkRuntimeErrors),
+               Run(equalsIgnoreCase),
+               Run(equalsIgnoreCase_checkRuntimeErrors),
+               Run(compareIgnoreCase),
+               Run(compareIgnoreCase_checkRuntimeErrors),
+               Run(findIgnoreCase),
+               Run(findIgnoreCase_checkRuntimeErrors)),
+         Trait("split",
+               Run(splitByByte),
+               Run(splitByByte_checkRuntimeErrors),
+               Run(splitByByteSet),
+               Run(splitByByteSet_checkRuntimeErrors),
+               Run(splitBySeparator),
+               Run(splitBySeparator_checkRuntimeErrors),
+               Run(splitIterator_maxSplits),
+               Run(splitIterator_reverse)),
+         Trait("line index",
+               Run(lineIndex_new),
+               Run(lineIndex_new_checkRuntimeErrors),
+               Run(lineIndex_extend),
+               Run(lineIndex_extend_checkRuntimeErrors),
+               Run(lineIndex_lineAt),
+               Run(lineIndex_lineAt_checkRuntimeErrors),
+               Run(lineIndex_line_checkRuntimeErrors)),
+         Trait("input/output",
+               Run(appendFromFd),
+               Run(appendFromFd_checkRuntimeErrors),
+               Run(readFile),
+               Run(readFile_checkRuntimeErrors),
+               Run(writeAll),
+               Run(writeAll_checkRuntimeErrors),
+               Run(writeSlices),
+               Run(writeSlices_checkRuntimeErrors),
+               Run(lineReader),
+               Run(lineReader_longLines),
+               Run(lineReader_checkRuntimeErrors),
+               Run(async),
+               Run(async_threadPool),
+               Run(async_checkRuntimeErrors),
+               Run(mapFile),
+               Run(mapFile_checkRuntimeErrors)),
+         Trait("utf-8",
+               Run(isValidUtf8),
+               Run(isValidUtf8_checkRuntimeErrors),
+               Run(utf8Validator),
+               Run(utf8Validator_checkRuntimeErrors),
+               Run(codePointCount),
+               Run(codePointCount_checkRuntimeErrors),
+               Run(codePointIndexAt),
+               Run(codePointIndexAt_checkRuntimeErrors),
+               Run(codePoints),
+               Run(codePoints_checkRuntimeErrors),
+               Run(codePointIndex),
+               Run(codePointIndex_checkRuntimeErrors),
+               Run(lowerUtf8),
+               Run(lowerUtf8_checkRuntimeErrors),
+               Run(upperUtf8),
+               Run(upperUtf8_checkRuntimeErrors),
+               Run(foldUtf8),
+               Run(foldUtf8_checkRuntimeErrors)),
+         Trait("codecs",
+               Run(appendBase64),
+               Run(appendBase64_checkRuntimeErrors),
+               Run(appendFromBase64),
+               Run(appendFromBase64_checkRuntimeErrors),
+               Run(appendHex),
+               Run(appendHex_checkRuntimeErrors),
+               Run(appendFromHex),
+               Run(appendFromHex_checkRuntimeErrors),
+               Run(appendHexdump),
+               Run(appendHexdump_checkRuntimeErrors),
+               Run(appendUrlEncoded),
+               Run(appendUrlEncoded_checkRuntimeErrors),
+               Run(urlDecodeInPlace),
+               Run(urlDecodeInPlace_checkRuntimeErrors)),
+         Trait("csv",
+               Run(appendCsvField),
+               Run(appendCsvField_checkRuntimeErrors),
+               Run(appendCsvRecord),
+               Run(appendCsvRecord_checkRuntimeErrors),
+               Run(csvReader),
+               Run(csvReader_checkRuntimeErrors)),
+         Trait("matcher",
+               Run(matcherFind),
+               Run(matcherFind_checkRuntimeErrors),
+               Run(matcherMatches),
+               Run(matcherMatches_checkRuntimeErrors)),
+         Trait("regex",
+               Run(regexNew),
+               Run(regexNew_checkRuntimeErrors),
+               Run(regexMatch),
+               Run(regexMatch_checkRuntimeErrors),
+               Run(regexSearch),
+               Run(regexSearch_checkRuntimeErrors),
+               Run(regexCaptures),
+               Run(regexCaptures_checkRuntimeErrors),
+               Run(regexFindAll),
+               Run(regexFindAll_checkRuntimeErrors)),
+         Trait("sort",
+               Run(sortArray),
+               Run(sortArray_checkRuntimeErrors),
+               Run(sortArrayParallel),
+               Run(sortArrayParallel_checkRuntimeErrors)),
+         Trait("parallel",
+               Run(executorCase),
+               Run(executorCase_checkRuntimeErrors),
+               Run(executorCountByte),
+               Run(executorCountByte_checkRuntimeErrors),
+               Run(executorFind),
+               Run(executorFind_checkRuntimeErrors),
+               Run(executorIsValidUtf8),
+               Run(executorIsValidUtf8_checkRuntimeErrors)),
+         Trait("queue",
+               Run(queuePushPop),
+               Run(queuePushPop_checkRuntimeErrors),
+               Run(queueConcurrentProducers),
+               Run(poolTakeRecycle),
+               Run(poolTakeRecycle_checkRuntimeErrors)))
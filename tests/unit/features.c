@@ -26,9 +26,26 @@
  * OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <pthread.h>
 #include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
 #include <text.h>
+#include <text_io.h>
+#include <text_async.h>
 #include <text_config.h>
+#include <text_line_index.h>
+#include <text_utf8.h>
+#include <text_codec.h>
+#include <text_csv.h>
+#include <text_matcher.h>
+#include <text_regex.h>
+#include <text_sort.h>
+#include <text_parallel.h>
+#include <text_queue.h>
 #include <traits/traits.h>
 #include "features.h"
 
@@ -196,6 +213,125 @@ Feature(quoted_checkRuntimeErrors) {
     assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
 }
 
+Feature(unquoted) {
+    {   // round trip
+        const char BYTES[] = "1a\"2b\\3c/4d\b5e\f6f\n7g\r8h\t9i\0" "10l\1" "11m\2" "12n\3" "13o lorem ipsum dolor sit amet";
+        const size_t BYTES_SIZE = sizeof(BYTES) - 1;
+        Text quoted = Text_quoted(BYTES, BYTES_SIZE);
+        Text sut = Text_unquoted(quoted, Text_length(quoted));
+        assert_not_null(sut);
+        assert_equal(BYTES_SIZE, Text_length(sut));
+        assert_memory_equal(BYTES_SIZE, BYTES, sut);
+        Text_delete(quoted);
+        Text_delete(sut);
+    }
+
+    {   // bytes from 0x80 are quoted one by one and come back as the UTF-8 encoding of U+0080 to U+00FF
+        const char BYTES[] = "caf\xc3\xa9 \xff";
+        const char EXPECTED[] = "caf\xc3\x83\xc2\xa9 \xc3\xbf";
+        Text quoted = Text_quoted(BYTES, sizeof(BYTES) - 1);
+        assert_string_equal("\"caf\\u00c3\\u00a9 \\u00ff\"", quoted);
+        Text sut = Text_unquoted(quoted, Text_length(quoted));
+        assert_not_null(sut);
+        assert_equal(sizeof(EXPECTED) - 1, Text_length(sut));
+        assert_string_equal(EXPECTED, sut);
+        Text_delete(quoted);
+        Text_delete(sut);
+    }
+
+    {   // unescaped UTF-8 is copied as it is
+        const char LITERAL[] = "\"caf\xc3\xa9 \xe2\x82\xac\"";
+        Text sut = Text_unquoted(LITERAL, sizeof(LITERAL) - 1);
+        assert_not_null(sut);
+        assert_string_equal("caf\xc3\xa9 \xe2\x82\xac", sut);
+        Text_delete(sut);
+    }
+
+    {   // code points are encoded as UTF-8
+        const char LITERAL[] = "\"caf\\u00e9 \\u20AC \\ud83d\\ude00 \\u0041\"";
+        const char EXPECTED[] = "caf\xc3\xa9 \xe2\x82\xac \xf0\x9f\x98\x80 A";
+        Text sut = Text_unquoted(LITERAL, sizeof(LITERAL) - 1);
+        assert_not_null(sut);
+        assert_equal(sizeof(EXPECTED) - 1, Text_length(sut));
+        assert_string_equal(EXPECTED, sut);
+        Text_delete(sut);
+    }
+
+    {   // empty literal
+        Text sut = Text_unquoted("\"\"", 2);
+        assert_not_null(sut);
+        assert_equal(0, Text_length(sut));
+        Text_delete(sut);
+    }
+
+    {   // invalid literals
+        const struct ByteArray INVALID[] = {
+                {"",                 0},
+                {"\"",               1},
+                {"lorem",            5},
+                {"\"lorem",          6},
+                {"\"lo\"rem\"",      8},
+                {"\"lorem\\\"",      8},
+                {"\"\\x\"",          4},
+                {"\"\\u12\"",        6},
+                {"\"\\u12g4\"",      8},
+                {"\"\\ud83d\"",      8},
+                {"\"\\ud83d\\u0041\"", 14},
+                {"\"\\ude00\"",      8},
+        };
+        for (size_t i = 0; i < sizeof(INVALID) / sizeof(INVALID[0]); i++) {
+            assert_null(Text_unquoted(INVALID[i].bytes, INVALID[i].size), "%zu", i);
+        }
+    }
+}
+
+Feature(unquoted_checkRuntimeErrors) {
+    Text sut = NULL;
+    const void *bytes = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_unquoted(bytes, 0);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_unquoted("", SIZE_MAX);
+        (void) sut;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(escapedHtml) {
+    const char *const plain = "<a href=\"/?a=1&b='2'\">Lorem ipsum</a>";
+    Text sut = Text_escapedHtml(plain, strlen(plain));
+    assert_string_equal("&lt;a href=&quot;/?a=1&amp;b=&#39;2&#39;&quot;&gt;Lorem ipsum&lt;/a&gt;", sut);
+    Text_delete(sut);
+
+    sut = Text_escapedHtml("Lorem ipsum dolor sit amet", 26);
+    assert_string_equal("Lorem ipsum dolor sit amet", sut);
+    Text_delete(sut);
+
+    sut = Text_escapedHtml("", 0);
+    assert_string_equal("", sut);
+    Text_delete(sut);
+}
+
+Feature(escapedHtml_checkRuntimeErrors) {
+    const void *bytes = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_escapedHtml(bytes, 0);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
 Feature(format) {
     Text sut = NULL;
 
@@ -1644,6 +1780,85 @@ Feature(quote_checkRuntimeErrors) {
     assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
 }
 
+Feature(unquote) {
+    {
+        Text sut = Text_fromLiteral("\"lorem\\tipsum \\\"dolor\\\" sit amet, consectetur adipiscing elit\\n\"");
+        const size_t capacity = Text_capacity(sut);
+        assert_true(Text_unquote(sut));
+        assert_string_equal("lorem\tipsum \"dolor\" sit amet, consectetur adipiscing elit\n", sut);
+        assert_equal(strlen("lorem\tipsum \"dolor\" sit amet, consectetur adipiscing elit\n"), Text_length(sut));
+        assert_equal(capacity, Text_capacity(sut));
+        Text_delete(sut);
+    }
+
+    {   // the text is unchanged on failure
+        const char LITERAL[] = "\"lorem\\tipsum \\q\"";
+        Text sut = Text_fromLiteral(LITERAL);
+        assert_false(Text_unquote(sut));
+        assert_string_equal(LITERAL, sut);
+        Text_delete(sut);
+    }
+}
+
+Feature(unquote_checkRuntimeErrors) {
+    Text sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_unquote(sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(escapeHtml) {
+    Text sut = Text_fromLiteral("Lorem ipsum dolor sit amet");
+    const Text original = sut;
+    const size_t capacity = Text_capacity(sut);
+
+    sut = Text_escapeHtml(&sut);
+    assert_true(original == sut);
+    assert_equal(capacity, Text_capacity(sut));
+    assert_string_equal("Lorem ipsum dolor sit amet", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "<a href=\"/?a=1&b='2'\">Lorem ipsum</a>");
+    sut = Text_escapeHtml(&sut);
+    assert_string_equal("&lt;a href=&quot;/?a=1&amp;b=&#39;2&#39;&quot;&gt;Lorem ipsum&lt;/a&gt;", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    for (size_t i = 0; i < 100; i++) {
+        sut = Text_appendLiteral(&sut, "a<b");
+    }
+    sut = Text_escapeHtml(&sut);
+    assert_equal(600, Text_length(sut));
+    for (size_t i = 0; i < 100; i++) {
+        assert_memory_equal(6, "a&lt;b", sut + 6 * i);
+    }
+
+    Text_delete(sut);
+}
+
+Feature(escapeHtml_checkRuntimeErrors) {
+    Text *ref = NULL;
+    Text sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_escapeHtml(ref);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_escapeHtml(&sut);
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+}
+
 Feature(lower) {
     Text sut = Text_fromBytes(
             "0123456789\0abcdefghijklmnopqrstuvwxyz\0ABCDEFGHIJKLMNOPQRSTUVWXYZ\0!\"#$%&\'()*+,-./:;<=>?@[\\]^_`{|}~ \0\t\n\r",
@@ -2035,6 +2250,120 @@ Feature(capacity_checkRuntimeErrors) {
     assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
 }
 
+Feature(withBuffer) {
+    char buffer[TEXT_BUFFER_SIZE(32) + 1];
+    for (size_t misalignment = 0; misalignment < 2; misalignment++) {
+        Text sut = Text_withBuffer(buffer + misalignment, sizeof(buffer) - 1);
+        assert_true(sut > buffer && sut < buffer + sizeof(buffer));
+        assert_equal(0, Text_length(sut));
+        assert_true(Text_capacity(sut) >= 32);
+        assert_string_equal("", sut);
+
+        sut = Text_appendFormat(&sut, "%s=%d", "status", 200);
+        sut = Text_insertLiteral(&sut, 0, "http.");
+        assert_true(sut > buffer && sut < buffer + sizeof(buffer));
+        assert_string_equal("http.status=200", sut);
+        sut = Text_shrinkToFit(&sut);      // stays in the buffer
+        assert_true(sut > buffer && sut < buffer + sizeof(buffer));
+        Text_delete(sut);                  // nothing to free
+    }
+
+    {   // outgrowing the buffer moves the content to the heap
+        Text sut = Text_withBuffer(buffer, sizeof(buffer));
+        const size_t capacity = Text_capacity(sut);
+        sut = Text_appendLiteral(&sut, "lorem ipsum");
+        for (size_t i = 0; Text_length(sut) <= capacity; i++) {
+            sut = Text_appendFormat(&sut, " %zu", i);
+        }
+        assert_false(sut > buffer && sut < buffer + sizeof(buffer));
+        assert_equal(0, memcmp(sut, "lorem ipsum 0 1 2", 17));
+        assert_equal('\0', sut[Text_length(sut)]);
+        sut = Text_shrinkToFit(&sut);
+        assert_equal(Text_length(sut), Text_capacity(sut));
+        Text_delete(sut);
+    }
+
+    {   // the smallest buffer
+        char tiny[TEXT_BUFFER_SIZE(0)];
+        Text sut = Text_withBuffer(tiny, sizeof(tiny));
+        sut = Text_push(&sut, 'a');
+        sut = Text_push(&sut, 'b');
+        assert_string_equal("ab", sut);
+        Text_delete(sut);
+    }
+}
+
+Feature(withBuffer_checkRuntimeErrors) {
+    char buffer[TEXT_BUFFER_SIZE(0)], *nullBuffer = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_withBuffer(nullBuffer, sizeof(buffer));
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_withBuffer(buffer, sizeof(buffer) - 1);
+        (void) sut;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(recycling) {
+    Text_enableRecycling(4096);
+    assert_equal(0, Text_recycledBytes());
+
+    Text sut = Text_withCapacity(200), other;
+    sut = Text_appendLiteral(&sut, "lorem ipsum");
+    Text_delete(sut);
+    const size_t cached = Text_recycledBytes();
+    assert_true(cached > 200);
+
+    other = Text_withCapacity(200);     // same block, cleared
+    assert_true(sut == other);
+    assert_equal(0, Text_recycledBytes());
+    assert_equal(0, Text_length(other));
+    assert_string_equal("", other);
+    assert_equal(200, Text_capacity(other));
+    Text_delete(other);
+
+    other = Text_withCapacity(150);     // a larger block of the same bucket
+    assert_true(sut == other);
+    assert_equal(200, Text_capacity(other));
+    Text_delete(other);
+
+    other = Text_withCapacity(300);     // too small
+    assert_false(sut == other);
+    Text_delete(other);
+    assert_true(Text_recycledBytes() > cached);
+
+    other = Text_withCapacity(5000);    // above the limit, freed
+    Text_delete(other);
+    assert_true(Text_recycledBytes() <= 4096);
+
+    other = Text_new();
+    other = Text_shrinkToFit(&other);   // too small to be reused, freed
+    const size_t bytes = Text_recycledBytes();
+    Text_delete(other);
+    assert_equal(bytes, Text_recycledBytes());
+
+    Text_trimRecycled(cached);
+    assert_true(Text_recycledBytes() <= cached);
+    Text_enableRecycling(0);
+    assert_equal(0, Text_recycledBytes());
+
+    Text_enableRecycling(4096);
+    Text_delete(Text_fromLiteral("lorem"));
+    assert_true(Text_recycledBytes() > 0);
+    Text_disableRecycling();
+    assert_equal(0, Text_recycledBytes());
+    Text_delete(Text_fromLiteral("lorem"));
+    assert_equal(0, Text_recycledBytes());
+}
+
 Feature(equals) {
     Text sut, other;
 
@@ -2072,25 +2401,3425 @@ Feature(equals_checkRuntimeErrors) {
     Text_delete(sut);
 }
 
-Feature(isEmpty) {
-    Text sut = Text_new();
-    assert_true(Text_isEmpty(sut));
+Feature(compare) {
+    const struct {
+        const char *a;
+        size_t aSize;
+        const char *b;
+        size_t bSize;
+        int sign;
+    } cases[] = {
+            {"",            0,  "",             0,  0},
+            {"",            0,  "a",            1,  -1},
+            {"abc",         3,  "abd",          3,  -1},
+            {"abc",         3,  "ab",           2,  1},
+            {"a\0b",        3,  "a\0c",         3,  -1},    // embedded zeros are compared too
+            {"a\0",         2,  "a",            1,  1},
+            {"\x80",        1,  "\x7F",         1,  1},     // bytes are unsigned
+            {"Z",           1,  "a",            1,  -1},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Text a = Text_fromBytes(cases[i].a, cases[i].aSize), b = Text_fromBytes(cases[i].b, cases[i].bSize);
+        const int r = Text_compare(a, b), s = Text_compare(b, a);
+        assert_equal(cases[i].sign, (r > 0) - (r < 0));
+        assert_equal(-cases[i].sign, (s > 0) - (s < 0));
+        Text_delete(a);
+        Text_delete(b);
+    }
+
+    {   // long common prefixes
+        Text a = Text_new(), b;
+        for (size_t i = 0; i < 100; i++) {
+            a = Text_push(&a, (char) ('a' + i % 26));
+        }
+        b = Text_duplicate(a);
+        assert_equal(0, Text_compare(a, b));
+        for (size_t i = 0; i < 100; i++) {
+            const char c = Text_put(b, i, (char) (Text_get(a, i) + 1));
+            assert_true(Text_compare(a, b) < 0);
+            assert_true(Text_compare(b, a) > 0);
+            Text_put(b, i, c);
+        }
+        Text_delete(a);
+        Text_delete(b);
+    }
+}
 
-    sut = Text_appendLiteral(&sut, "lorem ipsum");
-    assert_false(Text_isEmpty(sut));
+Feature(compare_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const int r = Text_compare(sut, other);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const int r = Text_compare(other, sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
 
     Text_delete(sut);
 }
 
-Feature(isEmpty_checkRuntimeErrors) {
-    Text sut = NULL;
+Feature(commonPrefixLength) {
+    Text sut = Text_fromLiteral("/api/v1/users/42/orders"), other = Text_fromLiteral("/api/v1/users/42/profile");
+
+    assert_equal(17, Text_commonPrefixLength(sut, other));
+    assert_equal(17, Text_commonPrefixLength(other, sut));
+    assert_equal(Text_length(sut), Text_commonPrefixLength(sut, sut));
+
+    other = Text_overwriteWithLiteral(&other, "/api");
+    assert_equal(4, Text_commonPrefixLength(sut, other));
+    other = Text_overwriteWithLiteral(&other, "");
+    assert_equal(0, Text_commonPrefixLength(sut, other));
+    other = Text_overwriteWithBytes(&other, "/api/v1/users/42/orders\0", 24);
+    assert_equal(23, Text_commonPrefixLength(sut, other));
+    other = Text_overwriteWithLiteral(&other, "/api/v1/users/42/orders/7/items/3/status/history/2018");
+    sut = Text_overwriteWithLiteral(&sut, "/api/v1/users/42/orders/7/items/3/status/history/2019");
+    assert_equal(Text_length(sut) - 1, Text_commonPrefixLength(sut, other));
+
+    Text_delete(sut);
+    Text_delete(other);
+}
+
+Feature(commonPrefixLength_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
     const size_t counter = traits_unit_get_wrapped_signals_counter();
 
     traits_unit_wraps(SIGABRT) {
-        const bool r = Text_isEmpty(sut);
+        const size_t r = Text_commonPrefixLength(sut, other);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = Text_commonPrefixLength(other, sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(startsWith) {
+    Text sut = Text_fromBytes("GET /index.html\0HTTP/1.1", 24);
+
+    assert_true(Text_startsWith(sut, "GET ", 4));
+    assert_true(Text_startsWith(sut, "", 0));
+    assert_true(Text_startsWith(sut, "GET /index.html\0H", 17));
+    assert_true(Text_startsWith(sut, sut, Text_length(sut)));
+    assert_false(Text_startsWith(sut, "GET /index.html\0X", 17));
+    assert_false(Text_startsWith(sut, "POST", 4));
+    assert_false(Text_startsWith(sut, "GET /index.html\0HTTP/1.1 ", 25));
+
+    Text_delete(sut);
+}
+
+Feature(startsWith_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), nullText = NULL;
+    const char *nullPrefix = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_startsWith(nullText, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_startsWith(sut, nullPrefix, 0);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(endsWith) {
+    Text sut = Text_fromBytes("archive\0.tar.gz", 15);
+
+    assert_true(Text_endsWith(sut, ".gz", 3));
+    assert_true(Text_endsWith(sut, "", 0));
+    assert_true(Text_endsWith(sut, "e\0.tar.gz", 9));
+    assert_true(Text_endsWith(sut, sut, Text_length(sut)));
+    assert_false(Text_endsWith(sut, ".zip", 4));
+    assert_false(Text_endsWith(sut, "x\0.tar.gz", 9));
+    assert_false(Text_endsWith(sut, " archive\0.tar.gz", 16));
+
+    Text_delete(sut);
+}
+
+Feature(endsWith_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), nullText = NULL;
+    const char *nullSuffix = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_endsWith(nullText, "a", 1);
         (void) r;
     }
 
     assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_endsWith(sut, nullSuffix, 0);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(equalsIgnoreCase) {
+    Text sut = Text_fromLiteral("Content-Type"), other = Text_fromLiteral("content-type");
+    assert_true(Text_equalsIgnoreCase(sut, other));
+    assert_true(Text_equalsIgnoreCase(sut, sut));
+
+    other = Text_overwriteWithLiteral(&other, "content-typf");
+    assert_false(Text_equalsIgnoreCase(sut, other));
+    other = Text_overwriteWithLiteral(&other, "content-type ");
+    assert_false(Text_equalsIgnoreCase(sut, other));
+
+    // long enough to take the vectorized path, only ASCII letters are folded
+    sut = Text_overwriteWithLiteral(&sut, "X-FORWARDED-FOR: [@AZ`az{] \xC0");
+    other = Text_overwriteWithLiteral(&other, "x-forwarded-for: [@az`AZ{] \xC0");
+    assert_true(Text_equalsIgnoreCase(sut, other));
+    other = Text_overwriteWithLiteral(&other, "x-forwarded-for: {@az`AZ{] \xC0");
+    assert_false(Text_equalsIgnoreCase(sut, other));
+    other = Text_overwriteWithLiteral(&other, "x-forwarded-for: [@az`AZ{] \xE0");
+    assert_false(Text_equalsIgnoreCase(sut, other));
+
     Text_delete(sut);
+    Text_delete(other);
+}
+
+Feature(equalsIgnoreCase_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_equalsIgnoreCase(sut, other);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_equalsIgnoreCase(other, sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(compareIgnoreCase) {
+    const struct {
+        const char *a;
+        const char *b;
+        int sign;
+    } cases[] = {
+            {"",                                    "",                                     0},
+            {"",                                    "a",                                    -1},
+            {"Accept",                              "accept",                               0},
+            {"Accept",                              "ACCEPT-Encoding",                      -1},
+            {"Zebra",                               "apple",                                1},
+            {"a_b",                                 "A[b",                                  1},   // '_' > '['
+            {"Transfer-Encoding: chunked, gzip",    "TRANSFER-ENCODING: CHUNKED, GZIP",     0},
+            {"Transfer-Encoding: chunked, gzip",    "TRANSFER-ENCODING: CHUNKED, GZIQ",     -1},
+            {"Transfer-Encoding: chunked, gzip\x80", "TRANSFER-ENCODING: CHUNKED, GZIP\x7F", 1},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Text a = Text_fromLiteral(cases[i].a), b = Text_fromLiteral(cases[i].b);
+        const int r = Text_compareIgnoreCase(a, b), s = Text_compareIgnoreCase(b, a);
+        assert_equal(cases[i].sign, (r > 0) - (r < 0));
+        assert_equal(-cases[i].sign, (s > 0) - (s < 0));
+        Text_delete(a);
+        Text_delete(b);
+    }
+}
+
+Feature(compareIgnoreCase_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const int r = Text_compareIgnoreCase(sut, other);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const int r = Text_compareIgnoreCase(other, sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(findIgnoreCase) {
+    Text sut = Text_fromLiteral("Host: example.org\r\nCONTENT-LENGTH: 42\r\ncontent-length: 7\r\n");
+
+    assert_equal(19, Text_findIgnoreCase(sut, 0, "Content-Length", 14));
+    assert_equal(39, Text_findIgnoreCase(sut, 20, "Content-Length", 14));
+    assert_equal(SIZE_MAX, Text_findIgnoreCase(sut, 40, "Content-Length", 14));
+    assert_equal(0, Text_findIgnoreCase(sut, 0, "h", 1));
+    assert_equal(14, Text_findIgnoreCase(sut, 2, "O", 1));
+    assert_equal(6, Text_findIgnoreCase(sut, 0, "EXAMPLE.ORG", 11));
+    assert_equal(SIZE_MAX, Text_findIgnoreCase(sut, 0, "example_org", 11));
+    assert_equal(5, Text_findIgnoreCase(sut, 5, "", 0));
+    assert_equal(Text_length(sut), Text_findIgnoreCase(sut, Text_length(sut), "", 0));
+    assert_equal(SIZE_MAX, Text_findIgnoreCase(sut, Text_length(sut), "\n", 1));
+    assert_equal(Text_length(sut) - 3, Text_findIgnoreCase(sut, 0, "7\r\n", 3));
+
+    sut = Text_overwriteWithBytes(&sut, "ab\0AB\0aB", 8);
+    assert_equal(3, Text_findIgnoreCase(sut, 1, "Ab\0", 3));
+    assert_equal(SIZE_MAX, Text_findIgnoreCase(sut, 4, "ab\0", 3));
+
+    Text_delete(sut);
+}
+
+Feature(findIgnoreCase_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), nullText = NULL;
+    const char *nullNeedle = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = Text_findIgnoreCase(nullText, 0, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = Text_findIgnoreCase(sut, 0, nullNeedle, 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = Text_findIgnoreCase(sut, Text_length(sut) + 1, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(sut);
+}
+
+Feature(isEmpty) {
+    Text sut = Text_new();
+    assert_true(Text_isEmpty(sut));
+
+    sut = Text_appendLiteral(&sut, "lorem ipsum");
+    assert_false(Text_isEmpty(sut));
+
+    Text_delete(sut);
+}
+
+Feature(isEmpty_checkRuntimeErrors) {
+    Text sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_isEmpty(sut);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+static void assert_tokens(TextSplitIterator *iterator, const struct ByteArray *expected, const size_t expectedSize) {
+    TextSlice token;
+    for (size_t i = 0; i < expectedSize; i++) {
+        assert_true(TextSplitIterator_next(iterator, &token));
+        assert_equal(expected[i].size, token.size);
+        assert_memory_equal(expected[i].size, expected[i].bytes, token.bytes);
+    }
+    assert_false(TextSplitIterator_next(iterator, &token));
+    assert_false(TextSplitIterator_next(iterator, &token));
+}
+
+Feature(splitByByte) {
+    {   // empty text
+        Text sut = Text_new();
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        const struct ByteArray expected[] = {{"", 0}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+
+    {   // adjacent, leading and trailing delimiters
+        Text sut = Text_fromLiteral(",lorem,,ipsum,");
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        const struct ByteArray expected[] = {{"", 0}, {"lorem", 5}, {"", 0}, {"ipsum", 5}, {"", 0}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+
+    {   // embedded zeros and long tokens
+        Text sut = Text_fromBytes("lorem ipsum dolor sit amet\0consectetur adipiscing elit\0", 55);
+        TextSplitIterator iterator = Text_splitByByte(sut, '\0');
+        const struct ByteArray expected[] = {
+                {"lorem ipsum dolor sit amet",  26},
+                {"consectetur adipiscing elit", 27},
+                {"",                            0}
+        };
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+}
+
+Feature(splitByByte_checkRuntimeErrors) {
+    Text sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        (void) iterator;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(splitByByteSet) {
+    {   // small set
+        Text sut = Text_fromLiteral("GET /index.html HTTP/1.1\r\nHost: localhost\r\n");
+        TextSplitIterator iterator = Text_splitByByteSet(sut, " \r\n", 3);
+        const struct ByteArray expected[] = {
+                {"GET", 3}, {"/index.html", 11}, {"HTTP/1.1", 8}, {"", 0},
+                {"Host:", 5}, {"localhost", 9}, {"", 0}, {"", 0}
+        };
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+
+    {   // large set
+        Text sut = Text_fromLiteral("a0b1c2d3e4f5g6h7i8j9k");
+        TextSplitIterator iterator = Text_splitByByteSet(sut, "0123456789", 10);
+        const struct ByteArray expected[] = {
+                {"a", 1}, {"b", 1}, {"c", 1}, {"d", 1}, {"e", 1}, {"f", 1},
+                {"g", 1}, {"h", 1}, {"i", 1}, {"j", 1}, {"k", 1}
+        };
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+}
+
+Feature(splitByByteSet_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitByByteSet(other, ",", 1);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitByByteSet(sut, other, 1);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitByByteSet(sut, ",", 0);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(splitBySeparator) {
+    {   // separator longer than the text
+        Text sut = Text_fromLiteral("ab");
+        TextSplitIterator iterator = Text_splitBySeparator(sut, "abc", 3);
+        const struct ByteArray expected[] = {{"ab", 2}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+
+    {   // overlapping candidates and long text
+        Text sut = Text_fromLiteral("lorem::ipsum:::dolor::::sit amet, consectetur adipiscing elit::");
+        TextSplitIterator iterator = Text_splitBySeparator(sut, "::", 2);
+        const struct ByteArray expected[] = {
+                {"lorem", 5}, {"ipsum", 5}, {":dolor", 6}, {"", 0},
+                {"sit amet, consectetur adipiscing elit", 37}, {"", 0}
+        };
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+        Text_delete(sut);
+    }
+}
+
+Feature(splitBySeparator_checkRuntimeErrors) {
+    Text sut = Text_fromLiteral("lorem"), other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitBySeparator(other, "::", 2);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitBySeparator(sut, other, 2);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextSplitIterator iterator = Text_splitBySeparator(sut, "::", 0);
+        (void) iterator;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(splitIterator_maxSplits) {
+    Text sut = Text_fromLiteral("a,b,c,d");
+
+    {
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        TextSplitIterator_setMaxSplits(&iterator, 0);
+        const struct ByteArray expected[] = {{"a,b,c,d", 7}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    {
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        TextSplitIterator_setMaxSplits(&iterator, 2);
+        const struct ByteArray expected[] = {{"a", 1}, {"b", 1}, {"c,d", 3}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    {
+        TextSplitIterator iterator = Text_splitByByte(sut, ',');
+        TextSplitIterator_setMaxSplits(&iterator, 8);
+        const struct ByteArray expected[] = {{"a", 1}, {"b", 1}, {"c", 1}, {"d", 1}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    Text_delete(sut);
+}
+
+Feature(splitIterator_reverse) {
+    Text sut = Text_fromLiteral("/usr/local/share/lorem ipsum dolor sit amet/");
+
+    {
+        TextSplitIterator iterator = Text_splitByByte(sut, '/');
+        TextSplitIterator_setReverse(&iterator, true);
+        const struct ByteArray expected[] = {
+                {"", 0}, {"lorem ipsum dolor sit amet", 26}, {"share", 5}, {"local", 5}, {"usr", 3}, {"", 0}
+        };
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    {
+        TextSplitIterator iterator = Text_splitByByteSet(sut, "/ ", 2);
+        TextSplitIterator_setReverse(&iterator, true);
+        TextSplitIterator_setMaxSplits(&iterator, 3);
+        const struct ByteArray expected[] = {{"", 0}, {"amet", 4}, {"sit", 3}, {"/usr/local/share/lorem ipsum dolor", 34}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    {
+        TextSplitIterator iterator = Text_splitBySeparator(sut, "/lo", 3);
+        TextSplitIterator_setReverse(&iterator, true);
+        const struct ByteArray expected[] = {{"rem ipsum dolor sit amet/", 25}, {"cal/share", 9}, {"/usr", 4}};
+        assert_tokens(&iterator, expected, sizeof(expected) / sizeof(expected[0]));
+    }
+
+    Text_delete(sut);
+}
+
+Feature(lineIndex_new) {
+    {   // empty text has a single empty line
+        Text text = Text_new();
+        TextLineIndex *sut = TextLineIndex_new(text);
+        assert_equal(1, TextLineIndex_count(sut));
+        assert_equal(0, TextLineIndex_offsetOf(sut, 0));
+        assert_equal(0, TextLineIndex_line(sut, text, 0).size);
+        TextLineIndex_delete(sut);
+        Text_delete(text);
+    }
+
+    {   // more lines than a single block
+        Text text = Text_new();
+        for (size_t i = 0; i < TEXT_LINE_INDEX_BLOCK_LINES * 3 + 5; i++) {
+            text = Text_appendFormat(&text, "line %zu\n", i);
+        }
+
+        TextLineIndex *sut = TextLineIndex_new(text);
+        assert_equal(TEXT_LINE_INDEX_BLOCK_LINES * 3 + 6, TextLineIndex_count(sut));
+        for (size_t i = 0; i < TEXT_LINE_INDEX_BLOCK_LINES * 3 + 5; i++) {
+            char expected[32];
+            const int size = snprintf(expected, sizeof(expected), "line %zu", i);
+            const TextSlice line = TextLineIndex_line(sut, text, i);
+            assert_equal((size_t) size, line.size);
+            assert_memory_equal(line.size, expected, line.bytes);
+            assert_equal((size_t) (line.bytes - text), TextLineIndex_offsetOf(sut, i));
+        }
+        assert_equal(0, TextLineIndex_line(sut, text, TEXT_LINE_INDEX_BLOCK_LINES * 3 + 5).size);
+
+        TextLineIndex_delete(sut);
+        Text_delete(text);
+    }
+}
+
+Feature(lineIndex_new_checkRuntimeErrors) {
+    Text text = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextLineIndex *sut = TextLineIndex_new(text);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(lineIndex_extend) {
+    Text text = Text_fromLiteral("lorem\nips");
+    TextLineIndex *sut = TextLineIndex_new(text);
+    assert_equal(2, TextLineIndex_count(sut));
+
+    text = Text_appendLiteral(&text, "um\ndolor\n");
+    TextLineIndex_extend(sut, text);
+    assert_equal(4, TextLineIndex_count(sut));
+
+    const struct ByteArray expected[] = {{"lorem", 5}, {"ipsum", 5}, {"dolor", 5}, {"", 0}};
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        const TextSlice line = TextLineIndex_line(sut, text, i);
+        assert_equal(expected[i].size, line.size);
+        assert_memory_equal(line.size, expected[i].bytes, line.bytes);
+    }
+
+    TextLineIndex_extend(sut, text);
+    assert_equal(4, TextLineIndex_count(sut));
+
+    TextLineIndex_delete(sut);
+    Text_delete(text);
+}
+
+Feature(lineIndex_extend_checkRuntimeErrors) {
+    Text text = Text_fromLiteral("lorem\nipsum");
+    TextLineIndex *sut = TextLineIndex_new(text), *other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextLineIndex_extend(other, text);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    Text_setLength(text, 3);
+    traits_unit_wraps(SIGABRT) {
+        TextLineIndex_extend(sut, text);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    TextLineIndex_delete(sut);
+    Text_delete(text);
+}
+
+Feature(lineIndex_lineAt) {
+    Text text = Text_new();
+    for (size_t i = 0; i < TEXT_LINE_INDEX_BLOCK_LINES * 2; i++) {
+        text = Text_appendFormat(&text, "%0*zu\n", (int) (i % 7), i);
+    }
+
+    TextLineIndex *sut = TextLineIndex_new(text);
+    size_t line = 0;
+    for (size_t offset = 0; offset <= Text_length(text); offset++) {
+        assert_equal(line, TextLineIndex_lineAt(sut, offset));
+        if (offset < Text_length(text) && '\n' == text[offset]) {
+            line++;
+        }
+    }
+
+    TextLineIndex_delete(sut);
+    Text_delete(text);
+}
+
+Feature(lineIndex_lineAt_checkRuntimeErrors) {
+    Text text = Text_fromLiteral("lorem\nipsum");
+    TextLineIndex *sut = TextLineIndex_new(text);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextLineIndex_lineAt(sut, Text_length(text) + 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    TextLineIndex_delete(sut);
+    Text_delete(text);
+}
+
+Feature(lineIndex_line_checkRuntimeErrors) {
+    Text text = Text_fromLiteral("lorem\nipsum");
+    TextLineIndex *sut = TextLineIndex_new(text);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const TextSlice r = TextLineIndex_line(sut, text, 2);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextLineIndex_offsetOf(sut, 2);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    TextLineIndex_delete(sut);
+    Text_delete(text);
+}
+
+static void writeTemporaryFile(char *path, const void *bytes, const size_t size) {
+    strcpy(path, "/tmp/text-features-XXXXXX");
+    const int fd = mkstemp(path);
+    assert_greater_equal(fd, 0);
+    assert_equal((ssize_t) size, write(fd, bytes, size));
+    close(fd);
+}
+
+Feature(appendFromFd) {
+    char path[32];
+    int error = -1;
+
+    {   // regular file
+        Text content = Text_new();
+        for (size_t i = 0; i < 100; i++) {
+            content = Text_appendFormat(&content, "lorem ipsum %zu\n", i);
+        }
+        writeTemporaryFile(path, content, Text_length(content));
+
+        const int fd = open(path, O_RDONLY);
+        Text sut = Text_fromLiteral("head:");
+        sut = Text_appendFromFd(&sut, fd, SIZE_MAX, &error);
+        assert_equal(0, error);
+        assert_equal(strlen("head:") + Text_length(content), Text_length(sut));
+        assert_memory_equal(Text_length(content), content, sut + strlen("head:"));
+        assert_equal(0, sut[Text_length(sut)]);
+
+        sut = Text_appendFromFd(&sut, fd, SIZE_MAX, &error);
+        assert_equal(0, error);
+        assert_equal(strlen("head:") + Text_length(content), Text_length(sut));
+
+        close(fd);
+        unlink(path);
+        Text_delete(sut);
+        Text_delete(content);
+    }
+
+    {   // pipe with maxBytes
+        int fds[2];
+        assert_equal(0, pipe(fds));
+        assert_equal(11, write(fds[1], "lorem ipsum", 11));
+        close(fds[1]);
+
+        Text sut = Text_new();
+        sut = Text_appendFromFd(&sut, fds[0], 5, &error);
+        assert_equal(0, error);
+        assert_string_equal("lorem", sut);
+
+        sut = Text_appendFromFd(&sut, fds[0], SIZE_MAX, &error);
+        assert_equal(0, error);
+        assert_string_equal("lorem ipsum", sut);
+
+        close(fds[0]);
+        Text_delete(sut);
+    }
+
+    {   // pipe outgrowing a caller buffer
+        char buffer[TEXT_BUFFER_SIZE(64)], content[200];
+        for (size_t i = 0; i < sizeof(content); i++) {
+            content[i] = (char) ('a' + i % 26);
+        }
+        int fds[2];
+        assert_equal(0, pipe(fds));
+        assert_equal((ssize_t) sizeof(content), write(fds[1], content, sizeof(content)));
+        close(fds[1]);
+
+        Text sut = Text_withBuffer(buffer, sizeof(buffer));
+        sut = Text_appendLiteral(&sut, "head:");
+        sut = Text_appendFromFd(&sut, fds[0], SIZE_MAX, &error);
+        assert_equal(0, error);
+        assert_false(sut > buffer && sut < buffer + sizeof(buffer));
+        assert_equal(strlen("head:") + sizeof(content), Text_length(sut));
+        assert_memory_equal(strlen("head:"), "head:", sut);
+        assert_memory_equal(sizeof(content), content, sut + strlen("head:"));
+        assert_equal(0, sut[Text_length(sut)]);
+
+        close(fds[0]);
+        Text_delete(sut);
+    }
+
+    {   // read failure
+        Text sut = Text_fromLiteral("lorem");
+        sut = Text_appendFromFd(&sut, -1, SIZE_MAX, &error);
+        assert_equal(EBADF, error);
+        assert_string_equal("lorem", sut);
+        Text_delete(sut);
+    }
+}
+
+Feature(appendFromFd_checkRuntimeErrors) {
+    Text sut = Text_new(), other = NULL;
+    int error, *nullError = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromFd(&other, 0, SIZE_MAX, &error);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromFd(&sut, 0, SIZE_MAX, nullError);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(readFile) {
+    char path[32];
+
+    {
+        Text content = Text_new();
+        for (size_t i = 0; i < 1000; i++) {
+            content = Text_appendFormat(&content, "%zu,", i);
+        }
+        writeTemporaryFile(path, content, Text_length(content));
+
+        Text sut = Text_readFile(path);
+        assert_not_null(sut);
+        assert_true(Text_equals(content, sut));
+        assert_equal(Text_length(content), Text_capacity(sut));
+
+        unlink(path);
+        Text_delete(sut);
+        Text_delete(content);
+    }
+
+    {
+        errno = 0;
+        assert_null(Text_readFile("/tmp/text-features-missing"));
+        assert_equal(ENOENT, errno);
+    }
+}
+
+Feature(readFile_checkRuntimeErrors) {
+    const char *path = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_readFile(path);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(writeAll) {
+    char path[32];
+    const size_t count = 3000;  // more than IOV_MAX
+    Text *texts = malloc(sizeof(texts[0]) * count);
+    Text expected = Text_new();
+
+    for (size_t i = 0; i < count; i++) {
+        texts[i] = 0 == i % 7 ? Text_new() : Text_format("%zu;", i);
+        expected = Text_append(&expected, texts[i]);
+    }
+
+    writeTemporaryFile(path, "", 0);
+    const int fd = open(path, O_WRONLY | O_TRUNC);
+    assert_true(Text_writeAll(fd, texts, count));
+    assert_true(Text_writeAll(fd, texts, 0));
+    close(fd);
+
+    Text sut = Text_readFile(path);
+    assert_not_null(sut);
+    assert_true(Text_equals(expected, sut));
+
+    errno = 0;
+    assert_false(Text_writeAll(-1, texts, count));
+    assert_equal(EBADF, errno);
+
+    for (size_t i = 0; i < count; i++) {
+        Text_delete(texts[i]);
+    }
+    free(texts);
+    unlink(path);
+    Text_delete(sut);
+    Text_delete(expected);
+}
+
+Feature(writeAll_checkRuntimeErrors) {
+    const Text *texts = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_writeAll(-1, texts, 0);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(writeSlices) {
+    int fds[2];
+    assert_equal(0, pipe(fds));
+
+    const TextSlice slices[] = {{"HTTP/1.1 200 OK\r\n", 17}, {"", 0}, {"Content-Length: 5\r\n\r\n", 21}, {"lorem", 5}};
+    assert_true(Text_writeSlices(fds[1], slices, sizeof(slices) / sizeof(slices[0])));
+    close(fds[1]);
+
+    int error;
+    Text sut = Text_new();
+    sut = Text_appendFromFd(&sut, fds[0], SIZE_MAX, &error);
+    assert_equal(0, error);
+    assert_string_equal("HTTP/1.1 200 OK\r\nContent-Length: 5\r\n\r\nlorem", sut);
+
+    close(fds[0]);
+    Text_delete(sut);
+}
+
+Feature(writeSlices_checkRuntimeErrors) {
+    const TextSlice *slices = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = Text_writeSlices(-1, slices, 0);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(lineReader) {
+    char path[32];
+    TextSlice line;
+
+    {   // many lines, last one without newline
+        Text content = Text_new();
+        for (size_t i = 0; i < 10000; i++) {
+            content = Text_appendFormat(&content, "%zu\n", i);
+        }
+        content = Text_appendLiteral(&content, "\nlast");
+        writeTemporaryFile(path, content, Text_length(content));
+
+        const int fd = open(path, O_RDONLY);
+        TextLineReader *sut = TextLineReader_new(fd);
+        for (size_t i = 0; i < 10000; i++) {
+            char expected[32];
+            const int size = snprintf(expected, sizeof(expected), "%zu", i);
+            assert_true(TextLineReader_next(sut, &line));
+            assert_equal((size_t) size, line.size);
+            assert_memory_equal(line.size, expected, line.bytes);
+        }
+        assert_true(TextLineReader_next(sut, &line));
+        assert_equal(0, line.size);
+        assert_true(TextLineReader_next(sut, &line));
+        assert_equal(4, line.size);
+        assert_memory_equal(4, "last", line.bytes);
+        assert_false(TextLineReader_next(sut, &line));
+        assert_false(TextLineReader_next(sut, &line));
+        assert_equal(0, TextLineReader_error(sut));
+
+        TextLineReader_delete(sut);
+        close(fd);
+        unlink(path);
+        Text_delete(content);
+    }
+
+    {   // empty input
+        int fds[2];
+        assert_equal(0, pipe(fds));
+        close(fds[1]);
+
+        TextLineReader *sut = TextLineReader_new(fds[0]);
+        assert_false(TextLineReader_next(sut, &line));
+        assert_equal(0, TextLineReader_error(sut));
+
+        TextLineReader_delete(sut);
+        close(fds[0]);
+    }
+
+    {   // read failure
+        TextLineReader *sut = TextLineReader_new(-1);
+        assert_false(TextLineReader_next(sut, &line));
+        assert_equal(EBADF, TextLineReader_error(sut));
+        TextLineReader_delete(sut);
+    }
+}
+
+Feature(lineReader_longLines) {
+    int fds[2];
+    TextSlice line;
+    assert_equal(0, pipe(fds));
+
+    char longLine[TEXT_DEFAULT_CAPACITY * 4];
+    memset(longLine, 'x', sizeof(longLine));
+    const char content[] = "lorem ipsum dolor sit amet\nconsectetur\n\nadipiscing elit\n";
+    assert_equal(sizeof(content) - 1, (size_t) write(fds[1], content, sizeof(content) - 1));
+    assert_equal(sizeof(longLine), (size_t) write(fds[1], longLine, sizeof(longLine)));
+    close(fds[1]);
+
+    TextLineReader *sut = TextLineReader_withBlockSize(fds[0], 4);
+    const struct ByteArray expected[] = {
+            {"lorem ipsum dolor sit amet", 26}, {"consectetur", 11}, {"", 0}, {"adipiscing elit", 15},
+            {longLine, sizeof(longLine)}
+    };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); i++) {
+        assert_true(TextLineReader_next(sut, &line));
+        assert_equal(expected[i].size, line.size);
+        assert_memory_equal(line.size, expected[i].bytes, line.bytes);
+    }
+    assert_false(TextLineReader_next(sut, &line));
+    assert_equal(0, TextLineReader_error(sut));
+
+    TextLineReader_delete(sut);
+    close(fds[0]);
+}
+
+Feature(lineReader_checkRuntimeErrors) {
+    TextSlice line;
+    TextLineReader *sut = TextLineReader_new(-1), *other = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextLineReader *r = TextLineReader_withBlockSize(-1, 0);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextLineReader_next(other, &line);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const int r = TextLineReader_error(other);
+        (void) r;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    TextLineReader_delete(sut);
+}
+
+static void assert_asyncRoundTrip(TextAsync *sut, const size_t depth) {
+    enum { FILES = 8 };
+    char paths[FILES][32];
+    int fds[FILES];
+    Text contents[FILES];
+    TextAsyncCompletion completion;
+
+    for (size_t i = 0; i < FILES; i++) {   // write
+        contents[i] = Text_new();
+        for (size_t j = 0; j < 100 * (i + 1); j++) {
+            contents[i] = Text_appendFormat(&contents[i], "%zu:%zu\n", i, j);
+        }
+        writeTemporaryFile(paths[i], "", 0);
+        fds[i] = open(paths[i], O_RDWR);
+        TextAsync_queueWrite(sut, fds[i], 0, &contents[i], 1, &contents[i]);
+    }
+
+    for (size_t i = 0; i < FILES; i++) {
+        assert_true(TextAsync_wait(sut, &completion));
+        Text content = *(Text *) completion.userData;
+        assert_null(completion.text);
+        assert_equal((ssize_t) Text_length(content), completion.result);
+    }
+    assert_false(TextAsync_wait(sut, &completion));
+
+    for (size_t i = 0; i < FILES; i++) {   // read back appending to a prefix
+        Text text = Text_fromLiteral("prefix:");
+        TextAsync_queueRead(sut, fds[i], 0, &text, Text_length(contents[i]) + 1, (void *) i);
+        assert_null(text);
+    }
+    assert_equal(depth, TextAsync_submit(sut));
+    assert_equal(0, TextAsync_submit(sut));
+
+    for (size_t i = 0; i < FILES; i++) {
+        assert_true(TextAsync_wait(sut, &completion));
+        const size_t index = (size_t) completion.userData;
+        assert_not_null(completion.text);
+        assert_equal((ssize_t) Text_length(contents[index]), completion.result);
+        assert_equal(strlen("prefix:") + Text_length(contents[index]), Text_length(completion.text));
+        assert_memory_equal(strlen("prefix:"), "prefix:", completion.text);
+        assert_string_equal(contents[index], completion.text + strlen("prefix:"));
+        Text_delete(completion.text);
+    }
+    assert_false(TextAsync_wait(sut, &completion));
+
+    {   // failures are reported through the result
+        Text text = Text_new();
+        TextAsync_queueRead(sut, -1, -1, &text, 16, NULL);
+        assert_true(TextAsync_wait(sut, &completion));
+        assert_equal(-EBADF, completion.result);
+        assert_equal(0, Text_length(completion.text));
+        Text_delete(completion.text);
+    }
+
+    {   // operations still queued on delete are released
+        Text text = Text_new();
+        TextAsync_queueRead(sut, fds[0], 0, &text, 16, NULL);
+        TextAsync_queueWrite(sut, fds[1], 0, &contents[1], 1, NULL);
+    }
+
+    TextAsync_delete(sut);
+    for (size_t i = 0; i < FILES; i++) {
+        close(fds[i]);
+        unlink(paths[i]);
+        Text_delete(contents[i]);
+    }
+}
+
+Feature(async) {
+    TextAsync *sut = TextAsync_new(4);
+    const TextAsyncBackend backend = TextAsync_backend(sut);
+    assert_true(TextAsyncBackend_Uring == backend || TextAsyncBackend_ThreadPool == backend);
+    assert_asyncRoundTrip(sut, 4);
+}
+
+Feature(async_threadPool) {
+    TextAsync *sut = TextAsync_withThreadPool(3);
+    assert_equal(TextAsyncBackend_ThreadPool, TextAsync_backend(sut));
+    assert_asyncRoundTrip(sut, 3);
+}
+
+Feature(async_checkRuntimeErrors) {
+    TextAsync *sut = TextAsync_withThreadPool(1), *other = NULL;
+    Text text = Text_new(), nullText = NULL;
+    const Text *texts = NULL;
+    TextAsyncCompletion completion;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextAsync *r = TextAsync_new(0);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextAsync_queueRead(sut, 0, -1, &nullText, 1, NULL);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextAsync_queueRead(sut, 0, -1, &text, 0, NULL);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextAsync_queueWrite(sut, 1, -1, texts, 1, NULL);
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextAsync_wait(other, &completion);
+        (void) r;
+    }
+
+    assert_equal(counter + 5, traits_unit_get_wrapped_signals_counter());
+
+    Text_delete(text);
+    TextAsync_delete(sut);
+}
+
+Feature(mapFile) {
+    char path[32];
+
+    {   // empty file
+        writeTemporaryFile(path, "", 0);
+        TextView sut = Text_mapFile(path);
+        assert_not_null(sut);
+        assert_equal(0, Text_length(sut));
+        assert_string_equal("", sut);
+        Text_unmapFile(sut);
+        unlink(path);
+    }
+
+    {   // content is searchable and NUL terminated
+        const char content[] = "lorem\nipsum\0dolor\nsit amet";
+        writeTemporaryFile(path, content, sizeof(content) - 1);
+        TextView sut = Text_mapFile(path);
+        assert_not_null(sut);
+        assert_equal(sizeof(content) - 1, Text_length(sut));
+        assert_equal(sizeof(content) - 1, Text_capacity(sut));
+        assert_memory_equal(sizeof(content), content, sut);
+
+        TextSlice token;
+        TextSplitIterator iterator = Text_splitByByte(sut, '\n');
+        assert_true(TextSplitIterator_next(&iterator, &token));
+        assert_equal(5, token.size);
+        assert_true(TextSplitIterator_next(&iterator, &token));
+        assert_equal(11, token.size);
+
+        Text copy = Text_duplicate(sut);
+        assert_true(Text_equals(copy, sut));
+        Text_delete(copy);
+
+        Text_delete((Text) sut);
+        unlink(path);
+    }
+
+    {   // missing file
+        errno = 0;
+        assert_null(Text_mapFile("/tmp/text-features-missing"));
+        assert_equal(ENOENT, errno);
+    }
+
+    {   // not a regular file
+        errno = 0;
+        assert_null(Text_mapFile("/tmp"));
+        assert_equal(EINVAL, errno);
+    }
+}
+
+Feature(mapFile_checkRuntimeErrors) {
+    char path[32];
+    const char *nullPath = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextView sut = Text_mapFile(nullPath);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    writeTemporaryFile(path, "lorem", 5);
+    TextView sut = Text_mapFile(path);
+    assert_not_null(sut);
+
+    traits_unit_wraps(SIGABRT) {
+        Text_setLength((Text) sut, 0);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text text = (Text) sut;
+        text = Text_appendLiteral(&text, " ipsum");
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    Text other = Text_new();
+    traits_unit_wraps(SIGABRT) {
+        Text_unmapFile(other);
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+
+    assert_string_equal("lorem", sut);
+    Text_delete(other);
+    Text_unmapFile(sut);
+    unlink(path);
+}
+
+Feature(isValidUtf8) {
+    const struct {
+        const char *bytes;
+        size_t size;
+        size_t invalidOffset;   // SIZE_MAX if valid
+    } cases[] = {
+            {"",                                                   0,  SIZE_MAX},
+            {"Lorem ipsum dolor sit amet, consectetur adipiscing", 51, SIZE_MAX},
+            {"caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80",          14, SIZE_MAX},
+            {"\xED\x9F\xBF\xEE\x80\x80\xF4\x8F\xBF\xBF",           10, SIZE_MAX},
+            {"abc\x80",                                            4,  3},          // lone continuation
+            {"abc\xC0\xAF",                                        5,  3},          // overlong 2 bytes
+            {"abc\xE0\x9F\xBF",                                    6,  3},          // overlong 3 bytes
+            {"abc\xF0\x8F\xBF\xBF",                                7,  3},          // overlong 4 bytes
+            {"abc\xED\xA0\x80",                                    6,  3},          // surrogate
+            {"abc\xF4\x90\x80\x80",                                7,  3},          // above U+10FFFF
+            {"abc\xF5\x80\x80\x80",                                7,  3},          // invalid lead
+            {"abc\xE2\x82 ",                                       6,  3},          // too short
+            {"abc\xE2\x82",                                        5,  3},          // truncated
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const size_t prefix = 40 + i;  // moves the sequences across the block boundaries
+        Text sut = Text_new();
+        for (size_t j = 0; j < prefix; j++) {
+            sut = Text_appendLiteral(&sut, j % 3 ? "a" : "\xC3\xA9");
+        }
+        const size_t base = Text_length(sut);
+        sut = Text_appendBytes(&sut, cases[i].bytes, cases[i].size);
+        size_t invalidOffset = SIZE_MAX;
+        if (SIZE_MAX == cases[i].invalidOffset) {
+            assert_true(Text_isValidUtf8(sut, &invalidOffset));
+            assert_equal(SIZE_MAX, invalidOffset);
+        } else {
+            assert_false(Text_isValidUtf8(sut, &invalidOffset));
+            assert_equal(base + cases[i].invalidOffset, invalidOffset);
+            assert_false(Text_isValidUtf8(sut, NULL));
+        }
+        Text_delete(sut);
+    }
+}
+
+Feature(isValidUtf8_checkRuntimeErrors) {
+    TextView sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        bool valid = Text_isValidUtf8(sut, NULL);
+        (void) valid;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(utf8Validator) {
+    const char valid[] = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80";
+    const char invalid[] = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x28\x80";
+    const size_t size = sizeof(valid) - 1;
+
+    for (size_t split = 0; split <= size; split++) {
+        TextUtf8Validator sut;
+        size_t invalidOffset = SIZE_MAX;
+
+        TextUtf8Validator_init(&sut);
+        assert_true(TextUtf8Validator_update(&sut, valid, split));
+        assert_true(TextUtf8Validator_update(&sut, valid + split, size - split));
+        assert_true(TextUtf8Validator_finish(&sut, &invalidOffset));
+        assert_equal(SIZE_MAX, invalidOffset);
+
+        TextUtf8Validator_init(&sut);
+        (void) TextUtf8Validator_update(&sut, invalid, split);
+        assert_false(TextUtf8Validator_update(&sut, invalid + split, size - split));
+        assert_false(TextUtf8Validator_finish(&sut, &invalidOffset));
+        assert_equal(10, invalidOffset);
+
+        // a chunk ending in the middle of a sequence is invalid only if nothing follows
+        const size_t truncated = split > 10 && split < size ? 10 : split > 6 && split < 9 ? 6 : split == 4 ? 3 : SIZE_MAX;
+        invalidOffset = SIZE_MAX;
+        TextUtf8Validator_init(&sut);
+        assert_true(TextUtf8Validator_update(&sut, valid, split));
+        assert_equal(SIZE_MAX == truncated, TextUtf8Validator_finish(&sut, &invalidOffset));
+        assert_equal(truncated, invalidOffset);
+    }
+}
+
+Feature(utf8Validator_checkRuntimeErrors) {
+    TextUtf8Validator *sut = NULL;
+    const void *bytes = NULL;
+    TextUtf8Validator validator;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    TextUtf8Validator_init(&validator);
+
+    traits_unit_wraps(SIGABRT) {
+        TextUtf8Validator_init(sut);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        (void) TextUtf8Validator_update(sut, "a", 1);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        (void) TextUtf8Validator_update(&validator, bytes, 1);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool valid = TextUtf8Validator_finish(sut, NULL);
+        (void) valid;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(codePointCount) {
+    Text sut = Text_fromLiteral("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+    assert_equal(8, Text_codePointCount(sut));
+
+    for (size_t i = 0; i < 100; i++) {
+        sut = Text_appendLiteral(&sut, "\xC3\xA9\xE2\x82\xAC" "a");
+    }
+    assert_equal(308, Text_codePointCount(sut));
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    assert_equal(0, Text_codePointCount(sut));
+    Text_delete(sut);
+}
+
+Feature(codePointCount_checkRuntimeErrors) {
+    TextView sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        size_t count = Text_codePointCount(sut);
+        (void) count;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(codePointIndexAt) {
+    const size_t offsets[] = {0, 1, 2, 3, 5, 6, 9, 10, 14};
+    Text sut = Text_fromLiteral("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        assert_equal(i, Text_codePointIndexAt(sut, offsets[i]));
+        assert_equal(offsets[i], Text_offsetOfCodePoint(sut, i));
+    }
+    assert_equal(4, Text_codePointIndexAt(sut, 4));  // inside a sequence
+    Text_delete(sut);
+}
+
+Feature(codePointIndexAt_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    Text sut = Text_fromLiteral("caf\xC3\xA9");
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        size_t index = Text_codePointIndexAt(nullText, 0);
+        (void) index;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t index = Text_codePointIndexAt(sut, 6);
+        (void) index;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t offset = Text_offsetOfCodePoint(nullText, 0);
+        (void) offset;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t offset = Text_offsetOfCodePoint(sut, 5);
+        (void) offset;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(codePoints) {
+    const uint32_t expected[] = {'c', 'a', 'f', 0xE9, ' ', 0x20AC, ' ', 0x1F600};
+    const size_t count = sizeof(expected) / sizeof(expected[0]);
+    Text sut = Text_fromLiteral("caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+    uint32_t codePoint;
+    size_t i = 0;
+
+    TextCodePointIterator iterator = Text_codePoints(sut, 0);
+    while (TextCodePointIterator_next(&iterator, &codePoint)) {
+        assert_equal(expected[i++], codePoint);
+    }
+    assert_equal(count, i);
+    assert_equal(Text_length(sut), TextCodePointIterator_offset(&iterator));
+
+    iterator = Text_codePoints(sut, Text_length(sut));
+    while (TextCodePointIterator_previous(&iterator, &codePoint)) {
+        assert_equal(expected[--i], codePoint);
+        assert_equal(Text_offsetOfCodePoint(sut, i), TextCodePointIterator_offset(&iterator));
+    }
+    assert_equal(0, i);
+
+    {   // invalid bytes are replaced one at a time
+        const uint32_t replaced[] = {'a', TEXT_REPLACEMENT_CHARACTER, TEXT_REPLACEMENT_CHARACTER,
+                                     TEXT_REPLACEMENT_CHARACTER, 'z'};
+        sut = Text_overwriteWithLiteral(&sut, "a\x80\xE2\x82z");
+        iterator = Text_codePoints(sut, 0);
+        for (i = 0; TextCodePointIterator_next(&iterator, &codePoint); i++) {
+            assert_equal(replaced[i], codePoint);
+        }
+        assert_equal(5, i);
+        while (TextCodePointIterator_previous(&iterator, &codePoint)) {
+            assert_equal(replaced[--i], codePoint);
+        }
+        assert_equal(0, i);
+    }
+
+    Text_delete(sut);
+}
+
+Feature(codePoints_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    uint32_t *nullCodePoint = NULL;
+    Text sut = Text_fromLiteral("caf\xC3\xA9");
+    TextCodePointIterator iterator = Text_codePoints(sut, 0);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextCodePointIterator other = Text_codePoints(nullText, 0);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextCodePointIterator other = Text_codePoints(sut, 6);
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool moved = TextCodePointIterator_next(&iterator, nullCodePoint);
+        (void) moved;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool moved = TextCodePointIterator_previous(&iterator, nullCodePoint);
+        (void) moved;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(codePointIndex) {
+    Text sut = Text_new();
+    size_t offsets[3 * TEXT_CODE_POINT_INDEX_STRIDE], count = 0;
+
+    while (Text_length(sut) < 2 * TEXT_CODE_POINT_INDEX_STRIDE + 7) {
+        offsets[count] = Text_length(sut);
+        sut = Text_appendLiteral(&sut, count % 5 ? (count % 3 ? "a" : "\xE2\x82\xAC") : "\xF0\x9F\x98\x80");
+        count += 1;
+    }
+    offsets[count] = Text_length(sut);
+
+    TextCodePointIndex *index = TextCodePointIndex_new(sut);
+    assert_equal(count, TextCodePointIndex_count(index));
+    for (size_t i = 0; i <= count; i++) {
+        assert_equal(offsets[i], TextCodePointIndex_offsetOf(index, sut, i));
+        assert_equal(i, TextCodePointIndex_indexAt(index, sut, offsets[i]));
+        assert_equal(Text_codePointIndexAt(sut, offsets[i]), TextCodePointIndex_indexAt(index, sut, offsets[i]));
+    }
+    TextCodePointIndex_delete(index);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    index = TextCodePointIndex_new(sut);
+    assert_equal(0, TextCodePointIndex_count(index));
+    assert_equal(0, TextCodePointIndex_offsetOf(index, sut, 0));
+    assert_equal(0, TextCodePointIndex_indexAt(index, sut, 0));
+    TextCodePointIndex_delete(index);
+    TextCodePointIndex_delete(NULL);
+    Text_delete(sut);
+}
+
+Feature(codePointIndex_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextCodePointIndex *nullIndex = NULL;
+    Text sut = Text_fromLiteral("caf\xC3\xA9");
+    TextCodePointIndex *index = TextCodePointIndex_new(sut);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextCodePointIndex *other = TextCodePointIndex_new(nullText);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t count = TextCodePointIndex_count(nullIndex);
+        (void) count;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t offset = TextCodePointIndex_offsetOf(index, sut, 5);
+        (void) offset;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        size_t position = TextCodePointIndex_indexAt(index, sut, 6);
+        (void) position;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    TextCodePointIndex_delete(index);
+    Text_delete(sut);
+}
+
+Feature(lowerUtf8) {
+    Text sut = Text_fromLiteral("Lorem IPSUM \xC3\x89T\xC3\x89 \xCE\xA3\xCE\xA9 \xD0\x96 \xF0\x90\x90\x80");
+    const Text original = sut;
+
+    sut = Text_lowerUtf8(&sut);
+    assert_true(original == sut);  // same byte length, modified in place
+    assert_string_equal("lorem ipsum \xC3\xA9t\xC3\xA9 \xCF\x83\xCF\x89 \xD0\xB6 \xF0\x90\x90\xA8", sut);
+
+    {   // U+0130 lowers to "i" followed by U+0307
+        sut = Text_overwriteWithLiteral(&sut, "\xC4\xB0" "STANBUL");
+        sut = Text_lowerUtf8(&sut);
+        assert_string_equal("i\xCC\x87stanbul", sut);
+        assert_equal(10, Text_length(sut));
+    }
+
+    {   // U+2126 OHM SIGN lowers to the shorter U+03C9
+        sut = Text_overwriteWithLiteral(&sut, "\xE2\x84\xA6 A");
+        sut = Text_lowerUtf8(&sut);
+        assert_string_equal("\xCF\x89 a", sut);
+    }
+
+    {   // invalid bytes are kept
+        sut = Text_overwriteWithBytes(&sut, "A\x80\xE2\x82Z\xFF", 6);
+        sut = Text_lowerUtf8(&sut);
+        assert_equal(6, Text_length(sut));
+        assert_string_equal("a\x80\xE2\x82z\xFF", sut);
+    }
+
+    Text_delete(sut);
+}
+
+Feature(lowerUtf8_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    Text nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_lowerUtf8(nullRef);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_lowerUtf8(&nullText);
+        (void) sut;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    char path[32];
+    writeTemporaryFile(path, "LOREM", 5);
+    TextView mapped = Text_mapFile(path);
+    assert_not_null(mapped);
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = (Text) mapped;
+        sut = Text_lowerUtf8(&sut);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    assert_string_equal("LOREM", mapped);
+    Text_unmapFile(mapped);
+    unlink(path);
+}
+
+Feature(upperUtf8) {
+    Text sut = Text_fromLiteral("lorem ipsum \xC3\xA9t\xC3\xA9 \xCF\x83\xCF\x89 \xD0\xB6 \xF0\x90\x90\xA8");
+
+    sut = Text_upperUtf8(&sut);
+    assert_string_equal("LOREM IPSUM \xC3\x89T\xC3\x89 \xCE\xA3\xCE\xA9 \xD0\x96 \xF0\x90\x90\x80", sut);
+
+    {   // U+00DF uppercases to "SS", U+FB03 to "FFI"
+        sut = Text_overwriteWithLiteral(&sut, "stra\xC3\x9F" "e \xEF\xAC\x83" "x");
+        for (size_t i = 0; i < 10; i++) {
+            sut = Text_appendLiteral(&sut, " \xC3\x9F");
+        }
+        sut = Text_upperUtf8(&sut);
+        assert_string_equal("STRASSE FFIX SS SS SS SS SS SS SS SS SS SS", sut);
+    }
+
+    Text_delete(sut);
+}
+
+Feature(upperUtf8_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_upperUtf8(nullRef);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(foldUtf8) {
+    Text a = Text_fromLiteral("Stra\xC3\x9F" "e \xCE\xA3\xCE\xB9\xCF\x83\xCF\x8D\xCF\x86\xCE\xBF\xCF\x82 \xE1\xBA\x9E");
+    Text b = Text_fromLiteral("STRASSE \xCF\x83\xCE\xB9\xCF\x83\xCF\x8D\xCF\x86\xCE\xBF\xCF\x83 ss");
+
+    a = Text_foldUtf8(&a);
+    b = Text_foldUtf8(&b);
+    assert_string_equal("strasse \xCF\x83\xCE\xB9\xCF\x83\xCF\x8D\xCF\x86\xCE\xBF\xCF\x83 ss", a);
+    assert_true(Text_equals(a, b));
+
+    Text_delete(a);
+    Text_delete(b);
+}
+
+Feature(foldUtf8_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text sut = Text_foldUtf8(nullRef);
+        (void) sut;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+Feature(appendBase64) {
+    const char *const plain = "Lorem ipsum dolor sit amet, consectetur adipiscing elit?";
+    Text sut = Text_fromLiteral("data:");
+
+    sut = Text_appendBase64(&sut, plain, strlen(plain), TextBase64Alphabet_Standard);
+    assert_string_equal(
+            "data:TG9yZW0gaXBzdW0gZG9sb3Igc2l0IGFtZXQsIGNvbnNlY3RldHVyIGFkaXBpc2NpbmcgZWxpdD8=", sut
+    );
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendBase64(&sut, "\xFB\xFF", 2, TextBase64Alphabet_Standard);
+    assert_string_equal("+/8=", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendBase64(&sut, "\xFB\xFF", 2, TextBase64Alphabet_UrlSafe);
+    assert_string_equal("-_8", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendBase64(&sut, "", 0, TextBase64Alphabet_Standard);
+    assert_string_equal("", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendBase64_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendBase64(nullRef, "a", 1, TextBase64Alphabet_Standard);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendBase64(&sut, nullBytes, 1, TextBase64Alphabet_Standard);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendFromBase64) {
+    const char *const encoded = "TG9yZW0gaXBzdW0gZG9sb3Igc2l0IGFtZXQsIGNvbnNlY3RldHVyIGFkaXBpc2NpbmcgZWxpdD8=";
+    size_t invalidOffset = 0;
+    Text sut = Text_fromLiteral(">");
+
+    sut = Text_appendFromBase64(&sut, encoded, strlen(encoded), TextBase64Alphabet_Standard, &invalidOffset);
+    assert_equal(SIZE_MAX, invalidOffset);
+    assert_string_equal(">Lorem ipsum dolor sit amet, consectetur adipiscing elit?", sut);
+
+    {   // padding is optional
+        sut = Text_overwriteWithLiteral(&sut, "");
+        sut = Text_appendFromBase64(&sut, "-_8", 3, TextBase64Alphabet_UrlSafe, &invalidOffset);
+        assert_equal(SIZE_MAX, invalidOffset);
+        assert_equal(2, Text_length(sut));
+        assert_string_equal("\xFB\xFF", sut);
+        sut = Text_appendFromBase64(&sut, "+/8=", 4, TextBase64Alphabet_Standard, &invalidOffset);
+        assert_equal(SIZE_MAX, invalidOffset);
+        assert_string_equal("\xFB\xFF\xFB\xFF", sut);
+    }
+
+    {   // malformed input appends nothing
+        const struct {
+            const char *encoded;
+            size_t invalidOffset;
+        } cases[] = {
+                {"TG9yZW0gaXBzdW0gZG9sb3Igc2l0IGFtZXQsIGNvbnNlY3RldHVy*GFkaXBpc2NpbmcgZWxpdD8=", 52},
+                {"TG9y ZW0=",                                                                      4},
+                {"+/8=",                                                                           0},
+                {"TG9yZ",                                                                          5},
+                {"TG9=yZW0",                                                                       3},
+                {"TG9yZW0",                                                                        SIZE_MAX},
+                {"TG9yZW0=",                                                                       SIZE_MAX},
+                {"TG9yZW=",                                                                        7},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            sut = Text_overwriteWithLiteral(&sut, "lorem");
+            sut = Text_appendFromBase64(&sut, cases[i].encoded, strlen(cases[i].encoded),
+                                        TextBase64Alphabet_UrlSafe, &invalidOffset);
+            assert_equal(cases[i].invalidOffset, invalidOffset);
+            if (SIZE_MAX != invalidOffset) {
+                assert_string_equal("lorem", sut);
+            }
+        }
+    }
+
+    Text_delete(sut);
+}
+
+Feature(appendFromBase64_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    size_t *nullOffset = NULL;
+    size_t invalidOffset;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendFromBase64(nullRef, "QQ", 2, TextBase64Alphabet_Standard, &invalidOffset);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromBase64(&sut, nullBytes, 2, TextBase64Alphabet_Standard, &invalidOffset);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromBase64(&sut, "QQ", 2, TextBase64Alphabet_Standard, nullOffset);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    {   // malformed input is reported, not aborted on
+        const struct {
+            const char *encoded;
+            size_t invalidOffset;
+        } cases[] = {
+                {"QUJDR",     5},   // truncated in the middle of a group
+                {"QUJDR=",    5},   // padding after a lone character
+                {"QUJD=",     4},   // padding after a complete group
+                {"QUJDRA=",   7},   // incomplete padding
+                {"QUJDRA=A",  6},   // padding followed by data
+                {"QUJDREE==", 8},   // padding longer than the group needs
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            sut = Text_overwriteWithLiteral(&sut, "lorem");
+            sut = Text_appendFromBase64(&sut, cases[i].encoded, strlen(cases[i].encoded),
+                                        TextBase64Alphabet_Standard, &invalidOffset);
+            assert_equal(cases[i].invalidOffset, invalidOffset, "%zu", i);
+            assert_string_equal("lorem", sut);
+        }
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendHex) {
+    const char *const plain = "Lorem ipsum dolor sit amet\xFF";
+    Text sut = Text_fromLiteral("0x");
+
+    sut = Text_appendHex(&sut, plain, strlen(plain));
+    assert_string_equal("0x4c6f72656d20697073756d20646f6c6f722073697420616d6574ff", sut);
+
+    sut = Text_appendHex(&sut, "", 0);
+    assert_string_equal("0x4c6f72656d20697073756d20646f6c6f722073697420616d6574ff", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendHex_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendHex(nullRef, "a", 1);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendHex(&sut, nullBytes, 1);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendFromHex) {
+    const char *const digits = "4c6f72656D20697073756D20646F6C6F722073697420616d6574FF";
+    size_t invalidOffset = 0;
+    Text sut = Text_fromLiteral(">");
+
+    sut = Text_appendFromHex(&sut, digits, strlen(digits), &invalidOffset);
+    assert_equal(SIZE_MAX, invalidOffset);
+    assert_string_equal(">Lorem ipsum dolor sit amet\xFF", sut);
+
+    {   // malformed input appends nothing
+        const struct {
+            const char *digits;
+            size_t invalidOffset;
+        } cases[] = {
+                {"4c6f72656d20697073756d20646f6c6f72207369742g616d6574", 43},
+                {"4c6f72656d20697073756d20646f6c6f722073697420616d657",  50},
+                {"x0",                                                   0},
+                {"0x",                                                   1},
+                {"0",                                                    0},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            sut = Text_overwriteWithLiteral(&sut, "lorem");
+            sut = Text_appendFromHex(&sut, cases[i].digits, strlen(cases[i].digits), &invalidOffset);
+            assert_equal(cases[i].invalidOffset, invalidOffset);
+            assert_string_equal("lorem", sut);
+        }
+    }
+
+    Text_delete(sut);
+}
+
+Feature(appendFromHex_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    size_t *nullOffset = NULL;
+    size_t invalidOffset;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendFromHex(nullRef, "00", 2, &invalidOffset);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromHex(&sut, nullBytes, 2, &invalidOffset);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendFromHex(&sut, "00", 2, nullOffset);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendHexdump) {
+    const char *const plain = "Lorem ipsum dolor sit amet\n";
+    Text sut = Text_new();
+
+    sut = Text_appendHexdump(&sut, plain, strlen(plain));
+    assert_string_equal(
+            "00000000  4c 6f 72 65 6d 20 69 70  73 75 6d 20 64 6f 6c 6f  |Lorem ipsum dolo|\n"
+            "00000010  72 20 73 69 74 20 61 6d  65 74 0a                 |r sit amet.|\n",
+            sut
+    );
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendHexdump(&sut, "", 0);
+    assert_string_equal("", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendHexdump_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendHexdump(nullRef, "a", 1);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendHexdump(&sut, nullBytes, 1);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendUrlEncoded) {
+    const char *const plain = "a b/c?d=e&f~g*h\xC3\xA9";
+    Text sut = Text_fromLiteral("?q=");
+
+    sut = Text_appendUrlEncoded(&sut, plain, strlen(plain), TextUrlEncoding_Component);
+    assert_string_equal("?q=a%20b%2Fc%3Fd%3De%26f~g%2Ah%C3%A9", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendUrlEncoded(&sut, plain, strlen(plain), TextUrlEncoding_Path);
+    assert_string_equal("a%20b/c%3Fd=e&f~g*h%C3%A9", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendUrlEncoded(&sut, plain, strlen(plain), TextUrlEncoding_Form);
+    assert_string_equal("a+b%2Fc%3Fd%3De%26f%7Eg*h%C3%A9", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendUrlEncoded(&sut, "", 0, TextUrlEncoding_Form);
+    assert_string_equal("", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendUrlEncoded_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendUrlEncoded(nullRef, "a", 1, TextUrlEncoding_Component);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendUrlEncoded(&sut, nullBytes, 1, TextUrlEncoding_Component);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(urlDecodeInPlace) {
+    Text sut = Text_fromLiteral("a+b%2Fc%3fd%3De%26f~g*h%C3%A9");
+    const size_t capacity = Text_capacity(sut);
+
+    Text_urlDecodeInPlace(sut, TextUrlEncoding_Form);
+    assert_string_equal("a b/c?d=e&f~g*h\xC3\xA9", sut);
+    assert_equal(capacity, Text_capacity(sut));
+
+    sut = Text_overwriteWithLiteral(&sut, "a+b%20c");
+    Text_urlDecodeInPlace(sut, TextUrlEncoding_Component);
+    assert_string_equal("a+b c", sut);
+
+    {   // malformed sequences are kept
+        sut = Text_overwriteWithLiteral(&sut, "%%41%4%zz%4g%");
+        Text_urlDecodeInPlace(sut, TextUrlEncoding_Path);
+        assert_string_equal("%A%4%zz%4g%", sut);
+    }
+
+    Text_delete(sut);
+}
+
+Feature(urlDecodeInPlace_checkRuntimeErrors) {
+    Text sut = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text_urlDecodeInPlace(sut, TextUrlEncoding_Component);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+    char path[32];
+    writeTemporaryFile(path, "a%20b", 5);
+    TextView mapped = Text_mapFile(path);
+    assert_not_null(mapped);
+
+    traits_unit_wraps(SIGABRT) {
+        Text_urlDecodeInPlace((Text) mapped, TextUrlEncoding_Component);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    assert_string_equal("a%20b", mapped);
+    Text_unmapFile(mapped);
+    unlink(path);
+}
+
+Feature(appendCsvField) {
+    Text sut = Text_new();
+
+    sut = Text_appendCsvField(&sut, "lorem", 5, ',');
+    assert_string_equal("lorem", sut);
+
+    sut = Text_appendCsvField(&sut, "a,b", 3, ',');
+    assert_string_equal("lorem\"a,b\"", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendCsvField(&sut, "say \"hi\"\n", 9, ';');
+    assert_string_equal("\"say \"\"hi\"\"\n\"", sut);
+
+    sut = Text_overwriteWithLiteral(&sut, "");
+    sut = Text_appendCsvField(&sut, "a,b", 3, ';');
+    assert_string_equal("a,b", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendCsvField_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const void *nullBytes = NULL;
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendCsvField(nullRef, "a", 1, ',');
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendCsvField(&sut, nullBytes, 1, ',');
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendCsvField(&sut, "a", 1, '"');
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(appendCsvRecord) {
+    const TextSlice fields[] = {
+            {"id",         2},
+            {"",           0},
+            {"a \"b\", c", 8},
+            {"multi\r\nline", 11},
+    };
+    Text sut = Text_fromLiteral("header\r\n");
+
+    sut = Text_appendCsvRecord(&sut, fields, sizeof(fields) / sizeof(fields[0]), ',');
+    assert_string_equal("header\r\nid,,\"a \"\"b\"\", c\",\"multi\r\nline\"\r\n", sut);
+
+    sut = Text_appendCsvRecord(&sut, fields, 0, ',');
+    assert_string_equal("header\r\nid,,\"a \"\"b\"\", c\",\"multi\r\nline\"\r\n\r\n", sut);
+
+    Text_delete(sut);
+}
+
+Feature(appendCsvRecord_checkRuntimeErrors) {
+    Text *nullRef = NULL;
+    const TextSlice *nullFields = NULL;
+    const TextSlice fields[] = {{"a", 1}};
+    Text sut = Text_new();
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text other = Text_appendCsvRecord(nullRef, fields, 1, ',');
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendCsvRecord(&sut, nullFields, 1, ',');
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        sut = Text_appendCsvRecord(&sut, fields, 1, '\n');
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    Text_delete(sut);
+}
+
+Feature(csvReader) {
+    const struct {
+        const char *bytes;
+        bool endOfRecord;
+    } expected[] = {
+            {"id",                        false},
+            {"name",                      false},
+            {"note",                      true},
+            {"1",                         false},
+            {"lorem, ipsum",              false},
+            {"",                          true},
+            {"2",                         false},
+            {"say \"hi\"",                false},
+            {"multi\r\nline",             true},
+            {"3",                         false},
+            {"",                          false},
+            {"",                          true},
+    };
+    Text text = Text_fromLiteral(
+            "id,name,note\n"
+            "1,\"lorem, ipsum\",\r\n"
+            "2,\"say \"\"hi\"\"\",\"multi\r\nline\"\r"
+            "3,,"
+    );
+    TextCsvReader *sut = TextCsvReader_new(text, ',');
+    TextSlice field;
+    bool endOfRecord;
+    size_t i = 0;
+
+    while (TextCsvReader_next(sut, &field, &endOfRecord)) {
+        assert_true(i < sizeof(expected) / sizeof(expected[0]));
+        assert_equal(strlen(expected[i].bytes), field.size);
+        assert_memory_equal(field.size, expected[i].bytes, field.bytes);
+        assert_equal(expected[i].endOfRecord, endOfRecord);
+        if (4 == i) {
+            assert_true(field.bytes > text && field.bytes < text + Text_length(text));  // not copied
+        }
+        i++;
+    }
+    assert_equal(sizeof(expected) / sizeof(expected[0]), i);
+    assert_false(TextCsvReader_next(sut, &field, &endOfRecord));
+    TextCsvReader_delete(sut);
+
+    {   // quotes spanning several chunks
+        text = Text_overwriteWithLiteral(&text, "\"");
+        for (size_t j = 0; j < 100; j++) {
+            text = Text_appendLiteral(&text, "a,\n\"\"");
+        }
+        text = Text_appendLiteral(&text, "\"\nb");
+        sut = TextCsvReader_new(text, ',');
+        assert_true(TextCsvReader_next(sut, &field, &endOfRecord));
+        assert_true(endOfRecord);
+        assert_equal(400, field.size);
+        assert_memory_equal(4, "a,\n\"", field.bytes + 396);
+        assert_true(TextCsvReader_next(sut, &field, &endOfRecord));
+        assert_memory_equal(1, "b", field.bytes);
+        assert_false(TextCsvReader_next(sut, &field, &endOfRecord));
+        TextCsvReader_delete(sut);
+    }
+
+    {   // empty content and trailing line break
+        text = Text_overwriteWithLiteral(&text, "");
+        sut = TextCsvReader_new(text, ',');
+        assert_false(TextCsvReader_next(sut, &field, &endOfRecord));
+        TextCsvReader_delete(sut);
+
+        text = Text_overwriteWithLiteral(&text, "a;b\n");
+        sut = TextCsvReader_new(text, ';');
+        assert_true(TextCsvReader_next(sut, &field, &endOfRecord));
+        assert_false(endOfRecord);
+        assert_true(TextCsvReader_next(sut, &field, &endOfRecord));
+        assert_true(endOfRecord);
+        assert_false(TextCsvReader_next(sut, &field, &endOfRecord));
+        TextCsvReader_delete(sut);
+    }
+
+    TextCsvReader_delete(NULL);
+    Text_delete(text);
+}
+
+Feature(csvReader_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextSlice *nullField = NULL;
+    TextSlice field;
+    bool endOfRecord;
+    Text text = Text_fromLiteral("a,b");
+    TextCsvReader *sut = TextCsvReader_new(text, ',');
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextCsvReader *other = TextCsvReader_new(nullText, ',');
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextCsvReader *other = TextCsvReader_new(text, '\r');
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool read = TextCsvReader_next(sut, nullField, &endOfRecord);
+        (void) read;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    assert_true(TextCsvReader_next(sut, &field, &endOfRecord));
+    assert_memory_equal(1, "a", field.bytes);
+    TextCsvReader_delete(sut);
+    Text_delete(text);
+}
+
+Feature(matcherFind) {
+    Text patterns[] = {
+            Text_fromLiteral("he"), Text_fromLiteral("she"), Text_fromLiteral("his"), Text_fromLiteral("hers"),
+    };
+    Text text = Text_fromLiteral("ushers and his");
+    TextMatcher *sut = TextMatcher_new((const TextView *) patterns, 4, false);
+    TextMatch match;
+
+    assert_true(TextMatcher_find(sut, text, 0, &match));
+    assert_equal(1, match.pattern);
+    assert_equal(1, match.offset);
+    assert_equal(3, match.size);
+
+    assert_true(TextMatcher_find(sut, text, 2, &match));    // "hers" is longer than "he"
+    assert_equal(3, match.pattern);
+    assert_equal(2, match.offset);
+    assert_equal(4, match.size);
+
+    assert_true(TextMatcher_find(sut, text, 6, &match));
+    assert_equal(2, match.pattern);
+    assert_equal(11, match.offset);
+
+    assert_false(TextMatcher_find(sut, text, 12, &match));
+    assert_false(TextMatcher_find(sut, text, Text_length(text), &match));
+    TextMatcher_delete(sut);
+
+    {   // the leftmost occurrence wins over one ending first
+        text = Text_overwriteWithLiteral(&text, "abcdef");
+        patterns[0] = Text_overwriteWithLiteral(&patterns[0], "bcd");
+        patterns[1] = Text_overwriteWithLiteral(&patterns[1], "abcdef");
+        sut = TextMatcher_new((const TextView *) patterns, 2, false);
+        assert_true(TextMatcher_find(sut, text, 0, &match));
+        assert_equal(1, match.pattern);
+        assert_equal(0, match.offset);
+        assert_equal(6, match.size);
+        TextMatcher_delete(sut);
+    }
+
+    {   // ignoring case, duplicates are reported by their first index
+        text = Text_overwriteWithLiteral(&text, "Deny: FOO, bar");
+        patterns[0] = Text_overwriteWithLiteral(&patterns[0], "bar");
+        patterns[1] = Text_overwriteWithLiteral(&patterns[1], "foo");
+        patterns[2] = Text_overwriteWithLiteral(&patterns[2], "Foo");
+        sut = TextMatcher_new((const TextView *) patterns, 3, true);
+        assert_true(TextMatcher_find(sut, text, 0, &match));
+        assert_equal(1, match.pattern);
+        assert_equal(6, match.offset);
+        assert_equal(3, match.size);
+        TextMatcher_delete(sut);
+
+        sut = TextMatcher_new((const TextView *) patterns, 3, false);
+        assert_true(TextMatcher_find(sut, text, 0, &match));
+        assert_equal(0, match.pattern);
+        assert_equal(11, match.offset);
+        TextMatcher_delete(sut);
+    }
+
+    sut = TextMatcher_new((const TextView *) patterns, 0, false);
+    assert_false(TextMatcher_find(sut, text, 0, &match));
+    TextMatcher_delete(sut);
+
+    TextMatcher_delete(NULL);
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        Text_delete(patterns[i]);
+    }
+    Text_delete(text);
+}
+
+Feature(matcherFind_checkRuntimeErrors) {
+    const TextView *nullPatterns = NULL;
+    TextView nullText = NULL;
+    TextMatch *nullMatch = NULL;
+    Text patterns[] = {Text_fromLiteral("a"), Text_new()};
+    Text text = Text_fromLiteral("abc");
+    TextMatcher *sut = TextMatcher_new((const TextView *) patterns, 1, false);
+    TextMatch match;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextMatcher *other = TextMatcher_new(nullPatterns, 1, false);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextMatcher *other = TextMatcher_new((const TextView *) patterns, 2, false);    // empty pattern
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextMatcher_find(sut, nullText, 0, &match);
+        (void) found;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextMatcher_find(sut, text, 0, nullMatch);
+        (void) found;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextMatcher_find(sut, text, Text_length(text) + 1, &match);
+        (void) found;
+    }
+
+    assert_equal(counter + 5, traits_unit_get_wrapped_signals_counter());
+
+    TextMatcher_delete(sut);
+    Text_delete(patterns[0]);
+    Text_delete(patterns[1]);
+    Text_delete(text);
+}
+
+Feature(matcherMatches) {
+    const struct {
+        size_t pattern;
+        size_t offset;
+        size_t size;
+    } expected[] = {
+            {1, 1, 3},
+            {0, 2, 2},
+            {3, 2, 4},
+            {2, 11, 3},
+    };
+    Text patterns[] = {
+            Text_fromLiteral("he"), Text_fromLiteral("she"), Text_fromLiteral("his"), Text_fromLiteral("hers"),
+    };
+    Text text = Text_fromLiteral("ushers and his");
+    TextMatcher *sut = TextMatcher_new((const TextView *) patterns, 4, false);
+    TextMatchIterator iterator = TextMatcher_matches(sut, text, 0);
+    TextMatch match;
+    size_t i = 0;
+
+    while (TextMatchIterator_next(&iterator, &match)) {
+        assert_true(i < sizeof(expected) / sizeof(expected[0]));
+        assert_equal(expected[i].pattern, match.pattern);
+        assert_equal(expected[i].offset, match.offset);
+        assert_equal(expected[i].size, match.size);
+        i++;
+    }
+    assert_equal(sizeof(expected) / sizeof(expected[0]), i);
+    assert_false(TextMatchIterator_next(&iterator, &match));
+
+    iterator = TextMatcher_matches(sut, text, 3);
+    assert_true(TextMatchIterator_next(&iterator, &match));
+    assert_equal(2, match.pattern);
+    assert_false(TextMatchIterator_next(&iterator, &match));
+    TextMatcher_delete(sut);
+
+    {   // overlapping occurrences, ignoring case
+        text = Text_overwriteWithLiteral(&text, "aAaA");
+        patterns[0] = Text_overwriteWithLiteral(&patterns[0], "aa");
+        sut = TextMatcher_new((const TextView *) patterns, 1, true);
+        iterator = TextMatcher_matches(sut, text, 0);
+        for (i = 0; TextMatchIterator_next(&iterator, &match); i++) {
+            assert_equal(i, match.offset);
+        }
+        assert_equal(3, i);
+        TextMatcher_delete(sut);
+    }
+
+    for (i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        Text_delete(patterns[i]);
+    }
+    Text_delete(text);
+}
+
+Feature(matcherMatches_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextMatch *nullMatch = NULL;
+    Text pattern = Text_fromLiteral("a");
+    Text text = Text_fromLiteral("abc");
+    TextMatcher *sut = TextMatcher_new((const TextView *) &pattern, 1, false);
+    TextMatchIterator iterator = TextMatcher_matches(sut, text, 0);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextMatchIterator other = TextMatcher_matches(sut, nullText, 0);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextMatchIterator other = TextMatcher_matches(sut, text, Text_length(text) + 1);
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextMatchIterator_next(&iterator, nullMatch);
+        (void) found;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    TextMatcher_delete(sut);
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+Feature(regexNew) {
+    const struct {
+        const char *pattern;
+        size_t invalidOffset;
+        size_t groups;
+    } cases[] = {
+            {"",                0,  0},
+            {"a(b)(?:c)(d|e)*", 0,  2},
+            {"[]a-]x{2,}\\.",   0,  0},
+            {"a{x}b{",          0,  0},
+            {"{1}a",            0,  0},
+            {"a)",              1,  0},
+            {"(a",              0,  0},
+            {"(?a)",            0,  0},
+            {"*a",              0,  0},
+            {"a**",             1,  0},
+            {"a{3,2}",          1,  0},
+            {"a{1001}",         1,  0},
+            {"[z-a]",           2,  0},
+            {"[ab",             0,  0},
+            {"\\q",             0,  0},
+            {"\\x4",            0,  0},
+            {"a\\",             1,  0},
+            {"(a{1000}){1000}", 1,  0},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Text pattern = Text_fromLiteral(cases[i].pattern);
+        size_t invalidOffset;
+        TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+        if (SIZE_MAX == invalidOffset) {
+            assert_not_null(sut);
+            assert_equal(cases[i].groups, TextRegex_groupCount(sut));
+        } else {
+            assert_null(sut);
+            assert_equal(cases[i].invalidOffset, invalidOffset);
+        }
+        assert_equal(i <= 3, SIZE_MAX == invalidOffset);
+        TextRegex_delete(sut);
+        Text_delete(pattern);
+    }
+    TextRegex_delete(NULL);
+}
+
+Feature(regexNew_checkRuntimeErrors) {
+    TextView nullPattern = NULL;
+    size_t *nullOffset = NULL;
+    Text pattern = Text_fromLiteral("a");
+    size_t invalidOffset;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextRegex *other = TextRegex_new(nullPattern, &invalidOffset);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextRegex *other = TextRegex_new(pattern, nullOffset);
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(pattern);
+}
+
+Feature(regexMatch) {
+    const struct {
+        const char *pattern;
+        const char *text;
+        bool expected;
+    } cases[] = {
+            {"",                    "",             true},
+            {"",                    "a",            false},
+            {"a|ab",                "ab",           true},
+            {"[0-9]{4}-\\d\\d",     "2018-06",      true},
+            {"[0-9]{4}-\\d\\d",     "2018-06-01",   false},
+            {"^a.c$",               "abc",          true},
+            {"a.c",                 "a\nc",         false},
+            {"(\\w+\\s?)+",         "lorem ipsum",  true},
+            {"[^a-z]*",             "ABC 123",      true},
+            {"x*y$|x+",             "xxx",          true},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Text pattern = Text_fromLiteral(cases[i].pattern), text = Text_fromLiteral(cases[i].text);
+        size_t invalidOffset;
+        TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+        assert_equal(cases[i].expected, TextRegex_match(sut, text));
+        TextRegex_delete(sut);
+        Text_delete(pattern);
+        Text_delete(text);
+    }
+}
+
+Feature(regexMatch_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    Text pattern = Text_fromLiteral("a");
+    size_t invalidOffset;
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        bool matched = TextRegex_match(sut, nullText);
+        (void) matched;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+    TextRegex_delete(sut);
+    Text_delete(pattern);
+}
+
+Feature(regexSearch) {
+    const struct {
+        const char *pattern;
+        const char *text;
+        size_t offset;
+        size_t start;   // SIZE_MAX if not found
+        size_t end;
+    } cases[] = {
+            {"ERROR .*timeout",     "INFO ok\nERROR upstream timeout\n",    0,  8,          30},
+            {"a|ab",                "xab",                                  0,  1,          2},
+            {"ab|a",                "xab",                                  0,  1,          3},
+            {"a+?",                 "baaa",                                 0,  1,          2},
+            {"a*",                  "baa",                                  0,  0,          0},
+            {"a*",                  "baa",                                  1,  1,          3},
+            {"^a",                  "aa",                                   1,  SIZE_MAX,   0},
+            {"a$",                  "aa",                                   0,  1,          2},
+            {"\\d+\\.\\d+",         "v 10.25 and 3.1",                      0,  2,          7},
+            {"\\d+\\.\\d+",         "v 10.25 and 3.1",                      3,  3,          7},
+            {"\\d+\\.\\d+",         "v 10.25 and 3.1",                      7,  12,         15},
+            {"status=5\\d\\d",      "status=200 status=503",                0,  11,         21},
+            {"status=5\\d\\d",      "status=200 status=404",                0,  SIZE_MAX,   0},
+            {"(?:x|y)z",            "xxxxxxxxxxxxxxxxxxxxxxxxxyz",          0,  25,         27},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        Text pattern = Text_fromLiteral(cases[i].pattern), text = Text_fromLiteral(cases[i].text);
+        size_t invalidOffset;
+        TextSlice match;
+        TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+        const bool found = TextRegex_search(sut, text, cases[i].offset, &match);
+        assert_equal(SIZE_MAX != cases[i].start, found);
+        if (found) {
+            assert_equal(text + cases[i].start, match.bytes);
+            assert_equal(cases[i].end - cases[i].start, match.size);
+        }
+        TextRegex_delete(sut);
+        Text_delete(pattern);
+        Text_delete(text);
+    }
+
+    {   // long texts exercising the prefilter and the cache
+        Text pattern = Text_fromLiteral("needle\\d+"), text = Text_new();
+        size_t invalidOffset;
+        TextSlice match;
+        TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+        for (size_t i = 0; i < 1000; i++) {
+            text = Text_appendLiteral(&text, "haystack needle ");
+        }
+        text = Text_appendLiteral(&text, "needle42");
+        for (size_t i = 0; i < 3; i++) {
+            assert_true(TextRegex_search(sut, text, 0, &match));
+            assert_equal(Text_length(text) - 8, (size_t) (match.bytes - text));
+            assert_equal(8, match.size);
+        }
+        assert_false(TextRegex_search(sut, text, Text_length(text), &match));
+        TextRegex_delete(sut);
+        Text_delete(pattern);
+        Text_delete(text);
+    }
+}
+
+Feature(regexSearch_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextSlice *nullMatch = NULL;
+    Text pattern = Text_fromLiteral("a"), text = Text_fromLiteral("abc");
+    size_t invalidOffset;
+    TextSlice match;
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_search(sut, nullText, 0, &match);
+        (void) found;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_search(sut, text, 0, nullMatch);
+        (void) found;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_search(sut, text, Text_length(text) + 1, &match);
+        (void) found;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    TextRegex_delete(sut);
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+Feature(regexCaptures) {
+    Text pattern = Text_fromLiteral("user=(\\w+) status=(5\\d\\d)( retry)?");
+    Text text = Text_fromLiteral("user=bob status=200\nuser=alice status=503\n");
+    size_t invalidOffset;
+    TextSlice groups[5];
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+
+    assert_equal(3, TextRegex_groupCount(sut));
+    assert_true(TextRegex_captures(sut, text, 0, groups, 5));
+    assert_equal(text + 20, groups[0].bytes);
+    assert_equal(21, groups[0].size);
+    assert_memory_equal(5, "alice", groups[1].bytes);
+    assert_equal(5, groups[1].size);
+    assert_memory_equal(3, "503", groups[2].bytes);
+    assert_equal(3, groups[2].size);
+    assert_null(groups[3].bytes);       // not participating
+    assert_equal(0, groups[3].size);
+    assert_null(groups[4].bytes);       // past the number of groups
+    assert_false(TextRegex_captures(sut, text, 21, groups, 1));
+    TextRegex_delete(sut);
+
+    {   // priorities: lazy and greedy repetitions, last iteration of repeated groups
+        pattern = Text_overwriteWithLiteral(&pattern, "(a+?)(a*)|(x)");
+        text = Text_overwriteWithLiteral(&text, "baaa");
+        sut = TextRegex_new(pattern, &invalidOffset);
+        assert_true(TextRegex_captures(sut, text, 0, groups, 4));
+        assert_equal(text + 1, groups[1].bytes);
+        assert_equal(1, groups[1].size);
+        assert_equal(text + 2, groups[2].bytes);
+        assert_equal(2, groups[2].size);
+        assert_null(groups[3].bytes);
+        TextRegex_delete(sut);
+
+        pattern = Text_overwriteWithLiteral(&pattern, "(?:(\\d)-)+");
+        text = Text_overwriteWithLiteral(&text, "1-2-3-");
+        sut = TextRegex_new(pattern, &invalidOffset);
+        assert_true(TextRegex_captures(sut, text, 0, groups, 2));
+        assert_equal(6, groups[0].size);
+        assert_equal(text + 4, groups[1].bytes);
+        TextRegex_delete(sut);
+    }
+
+    {   // stars whose body can match empty stop after an empty iteration, as in Go and RE2
+        const struct {
+            const char *pattern;
+            const char *text;
+            size_t begin, end;      // the span of the match
+            size_t groupBegin;      // the span of the first group, SIZE_MAX if not participating
+            size_t groupEnd;
+        } cases[] = {
+                {"()*",     "",    0, 0, 0,        0},
+                {"(|a)*",   "aa",  0, 0, 0,        0},
+                {"(a*)*",   "b",   0, 0, 0,        0},
+                {"(a|)*",   "aa",  0, 2, 1,        2},
+                {"(|ab)*c", "abc", 0, 3, 0,        2},
+                {"(b)*?a",  "a",   0, 1, SIZE_MAX, SIZE_MAX},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            pattern = Text_overwriteWithLiteral(&pattern, cases[i].pattern);
+            text = Text_overwriteWithLiteral(&text, cases[i].text);
+            sut = TextRegex_new(pattern, &invalidOffset);
+            assert_true(TextRegex_captures(sut, text, 0, groups, 2), "%zu", i);
+            assert_equal(text + cases[i].begin, groups[0].bytes, "%zu", i);
+            assert_equal(cases[i].end - cases[i].begin, groups[0].size, "%zu", i);
+            if (SIZE_MAX == cases[i].groupBegin) {
+                assert_null(groups[1].bytes, "%zu", i);
+            } else {
+                assert_equal(text + cases[i].groupBegin, groups[1].bytes, "%zu", i);
+                assert_equal(cases[i].groupEnd - cases[i].groupBegin, groups[1].size, "%zu", i);
+            }
+            TextRegex_delete(sut);
+        }
+    }
+
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+Feature(regexCaptures_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextSlice *nullGroups = NULL;
+    Text pattern = Text_fromLiteral("(a)"), text = Text_fromLiteral("abc");
+    size_t invalidOffset;
+    TextSlice groups[2];
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_captures(sut, nullText, 0, groups, 2);
+        (void) found;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_captures(sut, text, 0, nullGroups, 2);
+        (void) found;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_captures(sut, text, 0, groups, 0);
+        (void) found;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegex_captures(sut, text, Text_length(text) + 1, groups, 2);
+        (void) found;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    TextRegex_delete(sut);
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+Feature(regexFindAll) {
+    const char *expected[] = {"10.0.0.1", "192.168.1.254", "8.8.8.8"};
+    Text pattern = Text_fromLiteral("\\d+\\.\\d+\\.\\d+\\.\\d+");
+    Text text = Text_fromLiteral("from 10.0.0.1 to 192.168.1.254 via 8.8.8.8, version 1.2.3");
+    size_t invalidOffset, i = 0;
+    TextSlice match;
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+    TextRegexIterator iterator = TextRegex_findAll(sut, text, 0);
+
+    while (TextRegexIterator_next(&iterator, &match)) {
+        assert_true(i < sizeof(expected) / sizeof(expected[0]));
+        assert_equal(strlen(expected[i]), match.size);
+        assert_memory_equal(match.size, expected[i], match.bytes);
+        i++;
+    }
+    assert_equal(sizeof(expected) / sizeof(expected[0]), i);
+    assert_false(TextRegexIterator_next(&iterator, &match));
+    TextRegex_delete(sut);
+
+    {   // empty matches
+        const size_t offsets[] = {0, 1, 3}, sizes[] = {0, 2, 0};
+        pattern = Text_overwriteWithLiteral(&pattern, "a*");
+        text = Text_overwriteWithLiteral(&text, "baa");
+        sut = TextRegex_new(pattern, &invalidOffset);
+        iterator = TextRegex_findAll(sut, text, 0);
+        for (i = 0; TextRegexIterator_next(&iterator, &match); i++) {
+            assert_true(i < 3);
+            assert_equal(text + offsets[i], match.bytes);
+            assert_equal(sizes[i], match.size);
+        }
+        assert_equal(3, i);
+        TextRegex_delete(sut);
+    }
+
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+Feature(regexFindAll_checkRuntimeErrors) {
+    TextView nullText = NULL;
+    TextSlice *nullMatch = NULL;
+    Text pattern = Text_fromLiteral("a"), text = Text_fromLiteral("abc");
+    size_t invalidOffset;
+    TextRegex *sut = TextRegex_new(pattern, &invalidOffset);
+    TextRegexIterator iterator = TextRegex_findAll(sut, text, 0);
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextRegexIterator other = TextRegex_findAll(sut, nullText, 0);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextRegexIterator other = TextRegex_findAll(sut, text, Text_length(text) + 1);
+        (void) other;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        bool found = TextRegexIterator_next(&iterator, nullMatch);
+        (void) found;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    TextRegex_delete(sut);
+    Text_delete(pattern);
+    Text_delete(text);
+}
+
+static int compareTexts(const void *a, const void *b) {
+    return Text_compare(*(const Text *) a, *(const Text *) b);
+}
+
+static Text *makeSortInput(const size_t count, uint32_t state) {
+    static const char *const prefixes[] = {"", "a", "https://example.org/", "https://example.org/api/v1/", "z\0"};
+    Text *texts = malloc(sizeof(texts[0]) * count);
+    assert_not_null(texts);
+    for (size_t i = 0; i < count; i++) {
+        const char *prefix = prefixes[i % 5];
+        texts[i] = Text_fromBytes(prefix, 4 == i % 5 ? 2 : strlen(prefix));
+        state = state * 1103515245U + 12345U;
+        for (size_t size = (state >> 16) % 20; size > 0; size--) {
+            state = state * 1103515245U + 12345U;
+            const char alphabet[] = {'a', 'b', '\0', '\xFF', '/'};
+            texts[i] = Text_push(&texts[i], alphabet[(state >> 16) % 5]);
+        }
+    }
+    return texts;
+}
+
+static void assert_sorted(Text *texts, Text *expected, const size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        assert_true(Text_equals(expected[i], texts[i]));
+    }
+    for (size_t i = 0; i < count; i++) {
+        Text_delete(texts[i]);
+    }
+    free(texts);
+    free(expected);
+}
+
+Feature(sortArray) {
+    Text empty[1] = {NULL};
+    Text_sortArray(empty, 0);
+
+    Text one[] = {Text_fromLiteral("lorem")};
+    Text_sortArray(one, 1);
+    assert_string_equal("lorem", one[0]);
+    Text_delete(one[0]);
+
+    {
+        const char *const expected[] = {"", "a", "a\0", "ab", "abcdefgh", "abcdefghi", "b", "\xFF"};
+        const size_t count = sizeof(expected) / sizeof(expected[0]);
+        Text texts[] = {
+                Text_fromLiteral("abcdefghi"), Text_fromLiteral("\xFF"), Text_fromLiteral("ab"),
+                Text_fromBytes("a\0", 2), Text_fromLiteral(""), Text_fromLiteral("b"),
+                Text_fromLiteral("abcdefgh"), Text_fromLiteral("a"),
+        };
+        Text_sortArray(texts, count);
+        for (size_t i = 0; i < count; i++) {
+            assert_equal(2 == i ? 2 : strlen(expected[i]), Text_length(texts[i]));
+            assert_memory_equal(Text_length(texts[i]), expected[i], texts[i]);
+            Text_delete(texts[i]);
+        }
+    }
+
+    for (size_t count = 2; count < 3000; count *= 3) {
+        Text *texts = makeSortInput(count, (uint32_t) count), *expected = malloc(sizeof(expected[0]) * count);
+        assert_not_null(expected);
+        memcpy(expected, texts, sizeof(texts[0]) * count);
+        qsort(expected, count, sizeof(expected[0]), compareTexts);
+        Text_sortArray(texts, count);
+        assert_sorted(texts, expected, count);
+    }
+
+    {   // a large group of equal keys going deeper past a few outliers at every level
+        const size_t levels = 200, equals = 2000, count = 5 * levels + equals;
+        Text *texts = malloc(sizeof(texts[0]) * count), *expected = malloc(sizeof(expected[0]) * count);
+        assert_not_null(texts);
+        assert_not_null(expected);
+        Text prefix = Text_new();
+        for (size_t level = 0, i = 0; level < levels; level++) {
+            const char outliers[] = "abxyz";
+            for (size_t j = 0; j < 5; j++) {
+                texts[i] = Text_duplicate(prefix);
+                texts[i] = Text_push(&texts[i], outliers[j]);
+                i++;
+            }
+            prefix = Text_appendLiteral(&prefix, "mmmmmmm");
+        }
+        for (size_t i = 5 * levels; i < count; i++) {
+            texts[i] = Text_duplicate(prefix);
+        }
+        uint32_t state = 7;
+        for (size_t i = count - 1; i > 0; i--) {
+            state = state * 1103515245U + 12345U;
+            const size_t j = (state >> 8) % (i + 1);
+            Text t = texts[i];
+            texts[i] = texts[j];
+            texts[j] = t;
+        }
+        memcpy(expected, texts, sizeof(texts[0]) * count);
+        qsort(expected, count, sizeof(expected[0]), compareTexts);
+        Text_sortArray(texts, count);
+        assert_sorted(texts, expected, count);
+        Text_delete(prefix);
+    }
+}
+
+Feature(sortArray_checkRuntimeErrors) {
+    Text *nullTexts = NULL;
+    Text texts[] = {Text_fromLiteral("lorem"), NULL};
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text_sortArray(nullTexts, 1);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text_sortArray(texts, 2);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(texts[0]);
+}
+
+Feature(sortArrayParallel) {
+    const size_t count = 4 * TEXT_SORT_PARALLEL_GRAIN;
+    const unsigned threads[] = {0, 1, 3};
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        Text *texts = makeSortInput(count, 42), *expected = malloc(sizeof(expected[0]) * count);
+        assert_not_null(expected);
+        memcpy(expected, texts, sizeof(texts[0]) * count);
+        Text_sortArray(expected, count);
+        Text_sortArrayParallel(texts, count, threads[i]);
+        assert_sorted(texts, expected, count);
+    }
+}
+
+Feature(sortArrayParallel_checkRuntimeErrors) {
+    Text *nullTexts = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        Text_sortArrayParallel(nullTexts, 1, 2);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+}
+
+static Text makeParallelInput(void) {
+    Text text = Text_withCapacity(3 * TEXT_PARALLEL_CHUNK_SIZE + 64);
+    while (Text_length(text) < 3 * TEXT_PARALLEL_CHUNK_SIZE + 7) {
+        text = Text_appendLiteral(&text, "Lorem Ipsum \xE2\x82\xAC ");
+    }
+    return text;
+}
+
+Feature(executorCase) {
+    const unsigned threads[] = {0, 1, 4};
+    for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++) {
+        TextExecutor *sut = TextExecutor_new(threads[i]);
+        Text text = makeParallelInput(), expected = Text_duplicate(text);
+        assert_true(TextExecutor_threads(sut) > 0);
+
+        Text_lower(expected);
+        TextExecutor_lower(sut, text);
+        assert_true(Text_equals(expected, text));
+
+        Text_upper(expected);
+        TextExecutor_upper(sut, text);
+        assert_true(Text_equals(expected, text));
+
+        text = Text_overwriteWithLiteral(&text, "Lorem");
+        TextExecutor_upper(sut, text);
+        assert_string_equal("LOREM", text);
+
+        Text_delete(text);
+        Text_delete(expected);
+        TextExecutor_delete(sut);
+    }
+    TextExecutor_delete(NULL);
+}
+
+Feature(executorCase_checkRuntimeErrors) {
+    TextExecutor *sut = TextExecutor_new(2), *nullExecutor = NULL;
+    Text text = Text_fromLiteral("lorem"), nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextExecutor_lower(nullExecutor, text);
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextExecutor_upper(sut, nullText);
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorCountByte) {
+    TextExecutor *sut = TextExecutor_new(3);
+    Text text = makeParallelInput();
+    size_t expected = 0;
+    for (size_t i = 0; i < Text_length(text); i++) {
+        expected += ' ' == text[i];
+    }
+    assert_equal(expected, TextExecutor_countByte(sut, text, ' '));
+    assert_equal(expected / 3, TextExecutor_countByte(sut, text, '\xAC'));
+    assert_equal(0, TextExecutor_countByte(sut, text, '\0'));
+
+    text = Text_overwriteWithBytes(&text, "a\0a\0", 4);
+    assert_equal(2, TextExecutor_countByte(sut, text, '\0'));
+    text = Text_overwriteWithLiteral(&text, "");
+    assert_equal(0, TextExecutor_countByte(sut, text, 'a'));
+
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorCountByte_checkRuntimeErrors) {
+    TextExecutor *sut = TextExecutor_new(2), *nullExecutor = NULL;
+    Text text = Text_fromLiteral("lorem"), nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_countByte(nullExecutor, text, 'a');
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_countByte(sut, nullText, 'a');
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorFind) {
+    TextExecutor *sut = TextExecutor_new(4);
+    Text text = makeParallelInput();
+    const size_t length = Text_length(text);
+
+    assert_equal(0, TextExecutor_find(sut, text, 0, "Lorem", 5));
+    assert_equal(16, TextExecutor_find(sut, text, 1, "Lorem", 5));
+    assert_equal(SIZE_MAX, TextExecutor_find(sut, text, 0, "lorem", 5));
+    assert_equal(7, TextExecutor_find(sut, text, 7, "", 0));
+    assert_equal(length, TextExecutor_find(sut, text, length, "", 0));
+    assert_equal(SIZE_MAX, TextExecutor_find(sut, text, length, "L", 1));
+
+    // occurrences crossing chunk boundaries and the last one
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE - 1, '#');
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE, '#');
+    Text_put(text, 2 * TEXT_PARALLEL_CHUNK_SIZE + 1, '#');
+    Text_put(text, length - 1, '!');
+    assert_equal(TEXT_PARALLEL_CHUNK_SIZE - 1, TextExecutor_find(sut, text, 0, "##", 2));
+    assert_equal(TEXT_PARALLEL_CHUNK_SIZE, TextExecutor_find(sut, text, TEXT_PARALLEL_CHUNK_SIZE, "#", 1));
+    assert_equal(2 * TEXT_PARALLEL_CHUNK_SIZE + 1, TextExecutor_find(sut, text, TEXT_PARALLEL_CHUNK_SIZE + 1, "#", 1));
+    assert_equal(length - 1, TextExecutor_find(sut, text, 0, "!", 1));
+    text = Text_appendLiteral(&text, "needle");
+    assert_equal(length, TextExecutor_find(sut, text, 0, "needle", 6));
+
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorFind_checkRuntimeErrors) {
+    TextExecutor *sut = TextExecutor_new(2), *nullExecutor = NULL;
+    Text text = Text_fromLiteral("lorem"), nullText = NULL;
+    const char *nullNeedle = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_find(nullExecutor, text, 0, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_find(sut, nullText, 0, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_find(sut, text, 0, nullNeedle, 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const size_t r = TextExecutor_find(sut, text, Text_length(text) + 1, "a", 1);
+        (void) r;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorIsValidUtf8) {
+    TextExecutor *sut = TextExecutor_new(3);
+    Text text = makeParallelInput();
+    size_t invalidOffset = 42;
+
+    assert_true(TextExecutor_isValidUtf8(sut, text, &invalidOffset));
+    assert_equal(42, invalidOffset);
+
+    // a sequence crossing a chunk boundary, the input repeats every 16 bytes so ASCII is overwritten
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE - 1, '\xE2');
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE, '\x82');
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE + 1, '\xAC');
+    assert_true(TextExecutor_isValidUtf8(sut, text, &invalidOffset));
+
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE + 1, 'x');
+    Text_put(text, 2 * TEXT_PARALLEL_CHUNK_SIZE, '\xFF');
+    assert_false(TextExecutor_isValidUtf8(sut, text, &invalidOffset));
+    assert_equal(TEXT_PARALLEL_CHUNK_SIZE - 1, invalidOffset);
+    assert_false(TextExecutor_isValidUtf8(sut, text, NULL));
+
+    Text_put(text, TEXT_PARALLEL_CHUNK_SIZE + 1, '\xAC');
+    assert_false(TextExecutor_isValidUtf8(sut, text, &invalidOffset));
+    assert_equal(2 * TEXT_PARALLEL_CHUNK_SIZE, invalidOffset);
+
+    text = Text_overwriteWithLiteral(&text, "");
+    assert_true(TextExecutor_isValidUtf8(sut, text, NULL));
+
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(executorIsValidUtf8_checkRuntimeErrors) {
+    TextExecutor *sut = TextExecutor_new(2), *nullExecutor = NULL;
+    Text text = Text_fromLiteral("lorem"), nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextExecutor_isValidUtf8(nullExecutor, text, NULL);
+        (void) r;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextExecutor_isValidUtf8(sut, nullText, NULL);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+    Text_delete(text);
+    TextExecutor_delete(sut);
+}
+
+Feature(queuePushPop) {
+    TextQueue *sut = TextQueue_new(3);
+    Text text = NULL;
+
+    assert_null(TextQueue_pop(sut));
+    for (size_t i = 0; i < 4; i++) {
+        text = Text_format("%zu", i);
+        assert_true(TextQueue_push(sut, &text));
+        assert_null(text);
+    }
+    text = Text_fromLiteral("overflow");
+    assert_false(TextQueue_push(sut, &text));
+    assert_string_equal("overflow", text);
+
+    for (size_t lap = 0; lap < 3; lap++) {     // the ring wraps around keeping the order
+        Text popped = TextQueue_pop(sut);
+        assert_not_null(popped);
+        assert_equal(lap, strtoul(popped, NULL, 10));
+        Text_delete(popped);
+        assert_true(TextQueue_push(sut, &text));
+        text = Text_format("%zu", lap + 4);
+    }
+    Text_delete(text);
+    TextQueue_delete(sut);     // deletes the texts left
+    TextQueue_delete(NULL);
+}
+
+Feature(queuePushPop_checkRuntimeErrors) {
+    TextQueue *sut = TextQueue_new(1), *nullQueue = NULL;
+    Text text = Text_fromLiteral("lorem"), nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextQueue *other = TextQueue_new(0);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextQueue_push(nullQueue, &text);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        const bool r = TextQueue_push(sut, &nullText);
+        (void) r;
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text r = TextQueue_pop(nullQueue);
+        (void) r;
+    }
+
+    assert_equal(counter + 4, traits_unit_get_wrapped_signals_counter());
+    Text_delete(text);
+    TextQueue_delete(sut);
+}
+
+#define QUEUE_PRODUCERS         4
+#define QUEUE_TEXTS_PER_THREAD  20000
+
+struct QueueProducer {
+    TextQueue *queue;
+    TextPool *pool;
+    size_t id;
+};
+
+static void *queueProduce(void *arg) {
+    const struct QueueProducer *producer = arg;
+    for (size_t i = 0; i < QUEUE_TEXTS_PER_THREAD; i++) {
+        Text text = TextPool_take(producer->pool);
+        text = Text_appendFormat(&text, "%zu %zu", producer->id, i);
+        while (!TextQueue_push(producer->queue, &text)) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+Feature(queueConcurrentProducers) {
+    TextQueue *queue = TextQueue_new(64);
+    TextPool *pool = TextPool_new(64, 32);
+    struct QueueProducer producers[QUEUE_PRODUCERS];
+    pthread_t threads[QUEUE_PRODUCERS];
+    size_t expected[QUEUE_PRODUCERS] = {0};
+
+    for (size_t i = 0; i < QUEUE_PRODUCERS; i++) {
+        producers[i] = (struct QueueProducer) {.queue=queue, .pool=pool, .id=i};
+        assert_equal(0, pthread_create(&threads[i], NULL, queueProduce, &producers[i]));
+    }
+    for (size_t received = 0; received < QUEUE_PRODUCERS * QUEUE_TEXTS_PER_THREAD;) {
+        Text text = TextQueue_pop(queue);
+        if (NULL == text) {
+            sched_yield();
+            continue;
+        }
+        size_t id, sequence;
+        assert_equal(2, sscanf(text, "%zu %zu", &id, &sequence));
+        assert_true(id < QUEUE_PRODUCERS);
+        assert_equal(expected[id]++, sequence);    // the order of each producer is kept
+        TextPool_recycle(pool, &text);
+        assert_null(text);
+        received++;
+    }
+    for (size_t i = 0; i < QUEUE_PRODUCERS; i++) {
+        assert_equal(0, pthread_join(threads[i], NULL));
+        assert_equal(QUEUE_TEXTS_PER_THREAD, expected[i]);
+    }
+    assert_null(TextQueue_pop(queue));
+    TextQueue_delete(queue);
+    TextPool_delete(pool);
+}
+
+Feature(poolTakeRecycle) {
+    TextPool *sut = TextPool_new(2, 16);
+    Text text = TextPool_take(sut), first, second, third;
+
+    assert_equal(0, Text_length(text));
+    assert_true(Text_capacity(text) >= 16);
+    text = Text_appendLiteral(&text, "a line longer than sixteen bytes");
+    const size_t capacity = Text_capacity(text);
+    first = text;
+    TextPool_recycle(sut, &text);
+    assert_null(text);
+
+    text = TextPool_take(sut);     // the same buffer comes back empty with its capacity
+    assert_true(first == text);
+    assert_equal(0, Text_length(text));
+    assert_string_equal("", text);
+    assert_equal(capacity, Text_capacity(text));
+
+    first = text;
+    second = TextPool_take(sut);
+    third = TextPool_take(sut);
+    TextPool_recycle(sut, &first);
+    TextPool_recycle(sut, &second);
+    TextPool_recycle(sut, &third);      // the pool is full, deleted
+    assert_null(third);
+
+    TextPool_delete(sut);      // deletes the texts kept
+    TextPool_delete(NULL);
+}
+
+Feature(poolTakeRecycle_checkRuntimeErrors) {
+    TextPool *sut = TextPool_new(1, 8), *nullPool = NULL;
+    Text nullText = NULL;
+    const size_t counter = traits_unit_get_wrapped_signals_counter();
+
+    traits_unit_wraps(SIGABRT) {
+        TextPool *other = TextPool_new(0, 8);
+        (void) other;
+    }
+
+    assert_equal(counter + 1, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        Text r = TextPool_take(nullPool);
+        (void) r;
+    }
+
+    assert_equal(counter + 2, traits_unit_get_wrapped_signals_counter());
+
+    traits_unit_wraps(SIGABRT) {
+        TextPool_recycle(sut, &nullText);
+    }
+
+    assert_equal(counter + 3, traits_unit_get_wrapped_signals_counter());
+    TextPool_delete(sut);
 }
@@ -42,6 +42,12 @@ Feature(withCapacity_checkRuntimeErrors);
 Feature(quoted);
 Feature(quoted_checkRuntimeErrors);
 
+Feature(unquoted);
+Feature(unquoted_checkRuntimeErrors);
+
+Feature(escapedHtml);
+Feature(escapedHtml_checkRuntimeErrors);
+
 Feature(format);
 Feature(format_checkRuntimeErrors);
 
@@ -108,6 +114,12 @@ Feature(eraseRange_checkRuntimeErrors);
 Feature(quote);
 Feature(quote_checkRuntimeErrors);
 
+Feature(unquote);
+Feature(unquote_checkRuntimeErrors);
+
+Feature(escapeHtml);
+Feature(escapeHtml_checkRuntimeErrors);
+
 Feature(lower);
 Feature(lower_checkRuntimeErrors);
 
@@ -141,12 +153,153 @@ Feature(get_checkRuntimeErrors);
 Feature(length_checkRuntimeErrors);
 Feature(capacity_checkRuntimeErrors);
 
+Feature(withBuffer);
+Feature(withBuffer_checkRuntimeErrors);
+Feature(recycling);
+
 Feature(equals);
 Feature(equals_checkRuntimeErrors);
+Feature(compare);
+Feature(compare_checkRuntimeErrors);
+Feature(commonPrefixLength);
+Feature(commonPrefixLength_checkRuntimeErrors);
+Feature(startsWith);
+Feature(startsWith_checkRuntimeErrors);
+Feature(endsWith);
+Feature(endsWith_checkRuntimeErrors);
+Feature(equalsIgnoreCase);
+Feature(equalsIgnoreCase_checkRuntimeErrors);
+Feature(compareIgnoreCase);
+Feature(compareIgnoreCase_checkRuntimeErrors);
+Feature(findIgnoreCase);
+Feature(findIgnoreCase_checkRuntimeErrors);
 
 Feature(isEmpty);
 Feature(isEmpty_checkRuntimeErrors);
 
+Feature(splitByByte);
+Feature(splitByByte_checkRuntimeErrors);
+
+Feature(splitByByteSet);
+Feature(splitByByteSet_checkRuntimeErrors);
+
+Feature(splitBySeparator);
+Feature(splitBySeparator_checkRuntimeErrors);
+
+Feature(splitIterator_maxSplits);
+Feature(splitIterator_reverse);
+
+Feature(lineIndex_new);
+Feature(lineIndex_new_checkRuntimeErrors);
+
+Feature(lineIndex_extend);
+Feature(lineIndex_extend_checkRuntimeErrors);
+
+Feature(lineIndex_lineAt);
+Feature(lineIndex_lineAt_checkRuntimeErrors);
+
+Feature(lineIndex_line_checkRuntimeErrors);
+
+Feature(appendFromFd);
+Feature(appendFromFd_checkRuntimeErrors);
+
+Feature(readFile);
+Feature(readFile_checkRuntimeErrors);
+
+Feature(writeAll);
+Feature(writeAll_checkRuntimeErrors);
+
+Feature(writeSlices);
+Feature(writeSlices_checkRuntimeErrors);
+
+Feature(lineReader);
+Feature(lineReader_longLines);
+Feature(lineReader_checkRuntimeErrors);
+
+Feature(async);
+Feature(async_threadPool);
+Feature(async_checkRuntimeErrors);
+
+Feature(mapFile);
+Feature(mapFile_checkRuntimeErrors);
+
+Feature(isValidUtf8);
+Feature(isValidUtf8_checkRuntimeErrors);
+Feature(utf8Validator);
+Feature(utf8Validator_checkRuntimeErrors);
+Feature(codePointCount);
+Feature(codePointCount_checkRuntimeErrors);
+Feature(codePointIndexAt);
+Feature(codePointIndexAt_checkRuntimeErrors);
+Feature(codePoints);
+Feature(codePoints_checkRuntimeErrors);
+Feature(codePointIndex);
+Feature(codePointIndex_checkRuntimeErrors);
+Feature(lowerUtf8);
+Feature(lowerUtf8_checkRuntimeErrors);
+Feature(upperUtf8);
+Feature(upperUtf8_checkRuntimeErrors);
+Feature(foldUtf8);
+Feature(foldUtf8_checkRuntimeErrors);
+
+Feature(appendBase64);
+Feature(appendBase64_checkRuntimeErrors);
+Feature(appendFromBase64);
+Feature(appendFromBase64_checkRuntimeErrors);
+Feature(appendHex);
+Feature(appendHex_checkRuntimeErrors);
+Feature(appendFromHex);
+Feature(appendFromHex_checkRuntimeErrors);
+Feature(appendHexdump);
+Feature(appendHexdump_checkRuntimeErrors);
+Feature(appendUrlEncoded);
+Feature(appendUrlEncoded_checkRuntimeErrors);
+Feature(urlDecodeInPlace);
+Feature(urlDecodeInPlace_checkRuntimeErrors);
+
+Feature(appendCsvField);
+Feature(appendCsvField_checkRuntimeErrors);
+Feature(appendCsvRecord);
+Feature(appendCsvRecord_checkRuntimeErrors);
+Feature(csvReader);
+Feature(csvReader_checkRuntimeErrors);
+
+Feature(matcherFind);
+Feature(matcherFind_checkRuntimeErrors);
+Feature(matcherMatches);
+Feature(matcherMatches_checkRuntimeErrors);
+
+Feature(regexNew);
+Feature(regexNew_checkRuntimeErrors);
+Feature(regexMatch);
+Feature(regexMatch_checkRuntimeErrors);
+Feature(regexSearch);
+Feature(regexSearch_checkRuntimeErrors);
+Feature(regexCaptures);
+Feature(regexCaptures_checkRuntimeErrors);
+Feature(regexFindAll);
+Feature(regexFindAll_checkRuntimeErrors);
+
+Feature(sortArray);
+Feature(sortArray_checkRuntimeErrors);
+Feature(sortArrayParallel);
+Feature(sortArrayParallel_checkRuntimeErrors);
+
+Feature(executorCase);
+Feature(executorCase_checkRuntimeErrors);
+Feature(executorCountByte);
+Feature(executorCountByte_checkRuntimeErrors);
+Feature(executorFind);
+Feature(executorFind_checkRuntimeErrors);
+Feature(executorIsValidUtf8);
+Feature(executorIsValidUtf8_checkRuntimeErrors);
+
+Feature(queuePushPop);
+Feature(queuePushPop_checkRuntimeErrors);
+Feature(queueConcurrentProducers);
+Feature(poolTakeRecycle);
+Feature(poolTakeRecycle_checkRuntimeErrors);
+
 #ifdef __cplusplus
 }
 #endif